@@ -0,0 +1,110 @@
+#pragma once
+
+#include "zinc/base.h"
+#include "zinc/cpu.h"
+
+#include <chrono>
+
+#if ZINC_COMPILER_MSVC
+#include <intrin.h>
+#endif
+
+namespace zinc::bench {
+// keeps the optimiser from discarding a value that is never read
+template <typename TValue> inline void keep(TValue const &value) {
+#if ZINC_COMPILER_MSVC && !ZINC_COMPILER_CLANG_CL
+  _ReadWriteBarrier();
+  (void)*reinterpret_cast<char const volatile *>(&value);
+#else
+  asm volatile("" : : "r,m"(value) : "memory");
+#endif
+}
+
+inline auto now_ns() -> u64 {
+  return as<u64>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                     std::chrono::steady_clock::now().time_since_epoch())
+                     .count());
+}
+
+// runs func a few times and reports the best run, items is the number of
+// operations a single call to func performs
+template <typename TFunc>
+inline auto measure(char const *name, u64 items, TFunc &&func,
+                    u32 runs = 5) -> f64 {
+  func();
+  auto best = ~u64(0);
+  for (u32 i = 0; i < runs; ++i) {
+    auto const start = now_ns();
+    func();
+    auto const elapsed = now_ns() - start;
+    best = elapsed < best ? elapsed : best;
+  }
+  auto const per_item = as<f64>(best) / as<f64>(items ? items : 1);
+  printf("%-48s %10.2f ns/op %10.2f Mop/s\n", name, per_item,
+         1e3 / per_item);
+  return per_item;
+}
+
+// like measure but reports throughput for a func that touches bytes bytes
+template <typename TFunc>
+inline auto measure_bytes(char const *name, u64 bytes, TFunc &&func,
+                          u32 runs = 5) -> f64 {
+  func();
+  auto best = ~u64(0);
+  for (u32 i = 0; i < runs; ++i) {
+    auto const start = now_ns();
+    func();
+    auto const elapsed = now_ns() - start;
+    best = elapsed < best ? elapsed : best;
+  }
+  auto const gbps = as<f64>(bytes) / as<f64>(best ? best : 1);
+  printf("%-48s %10.2f GB/s\n", name, gbps);
+  return gbps;
+}
+
+// small deterministic generator so runs are comparable
+struct rng {
+  u64 m_state;
+
+  explicit rng(u64 seed = 0x9e3779b97f4a7c15) : m_state(seed) {}
+
+  auto next() -> u64 {
+    m_state += 0x9e3779b97f4a7c15;
+    auto z = m_state;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+    return z ^ (z >> 31);
+  }
+  auto below(u64 bound) -> u64 { return next() % bound; }
+};
+// Calls func(level) once for each instruction set level, from native down
+// to scalar, with cpu() restricted to that level so dispatched kernels take
+// its path. Levels the machine lacks, or that would run the same code as
+// the one before, are skipped. Restrictions only ever remove features, so
+// this goes from widest to scalar and nothing can be measured natively
+// after it.
+template <typename TFunc> inline void for_each_cpu_level(TFunc &&func) {
+  struct level {
+    char const *name;
+    bool present;
+    cpu_features allowed;
+  };
+  auto const machine = cpu();
+  level const levels[] = {
+      {"native", true, machine},
+      {"avx2", machine.avx2, {true, true, true, true, true, true, true}},
+      {"sse", machine.sse2, {true, true, true, true, true}},
+      {"scalar", true, {}},
+  };
+  auto previous = cpu_features{};
+  for (usize i = 0; i < 4; ++i) {
+    if (!levels[i].present)
+      continue;
+    restrict_cpu_features(levels[i].allowed);
+    if (i > 0 && memcmp(&previous, &cpu(), sizeof(previous)) == 0)
+      continue;
+    previous = cpu();
+    func(levels[i].name);
+  }
+}
+} // namespace zinc::bench
\ No newline at end of file
@@ -0,0 +1,109 @@
+#include "bench.h"
+
+#include "zinc/cord.h"
+
+#include <string>
+#include <vector>
+
+#if ZINC_PLATFORM_LINUX || ZINC_PLATFORM_OSX || ZINC_PLATFORM_BSD
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#define ZINC_BENCH_WRITEV 1
+#endif
+
+using namespace zinc;
+
+// rows of a json response, a few dozen bytes each
+static auto make_rows(u64 count) -> std::vector<std::string> {
+  auto random = bench::rng();
+  std::vector<std::string> rows;
+  char row[128];
+  for (u64 i = 0; i < count; ++i) {
+    auto const length =
+        snprintf(row, sizeof(row), "{\"id\":%llu,\"score\":%u,\"tag\":\"t%u\"},",
+                 static_cast<unsigned long long>(i),
+                 as<u32>(random.below(100000)), as<u32>(random.below(64)));
+    rows.emplace_back(row, as<usize>(length));
+  }
+  return rows;
+}
+
+template <typename TString>
+static auto build(std::vector<std::string> const &rows) -> TString {
+  TString out;
+  for (auto const &row : rows)
+    out.append(row.data(), row.size());
+  return out;
+}
+
+static auto build_cord(std::vector<std::string> const &rows) -> cord {
+  cord out;
+  for (auto const &row : rows)
+    out.append(string_view(row.data(), row.size()));
+  return out;
+}
+
+auto main() -> int {
+  constexpr u64 row_count = 200'000;
+  auto const rows = make_rows(row_count);
+  usize bytes = 0;
+  for (auto const &row : rows)
+    bytes += row.size();
+  printf("response of %zu bytes in %llu appends\n", bytes,
+         static_cast<unsigned long long>(row_count));
+
+  bench::measure("build/std_string", row_count,
+                 [&] { bench::keep(build<std::string>(rows).size()); });
+  bench::measure("build/zinc_string", row_count,
+                 [&] { bench::keep(build<string>(rows).length()); });
+  bench::measure("build/cord", row_count,
+                 [&] { bench::keep(build_cord(rows).length()); });
+
+  // wrapping a finished body in an envelope
+  auto const body_string = build<std::string>(rows);
+  auto const body_cord = build_cord(rows);
+  bench::measure("wrap/std_string", 1, [&] {
+    auto copy = body_string;
+    copy.insert(0, "{\"rows\":[");
+    copy.append("]}");
+    bench::keep(copy.size());
+  });
+  bench::measure("wrap/cord", 1, [&] {
+    auto copy = body_cord;
+    copy.prepend("{\"rows\":[");
+    copy.append("]}");
+    bench::keep(copy.length());
+  });
+
+  bench::measure("substr_half/std_string", 1, [&] {
+    bench::keep(body_string.substr(bytes / 4, bytes / 2).size());
+  });
+  bench::measure("substr_half/cord", 1, [&] {
+    bench::keep(body_cord.substr(bytes / 4, bytes / 2).length());
+  });
+
+  bench::measure_bytes("flatten/cord", bytes,
+                       [&] { bench::keep(body_cord.flatten().length()); });
+
+#if ZINC_BENCH_WRITEV
+  auto const sink = open("/dev/null", O_WRONLY);
+  bench::measure_bytes("emit/std_string_write", bytes, [&] {
+    bench::keep(write(sink, body_string.data(), body_string.size()));
+  });
+  // the chunks go to the kernel as they are, in batches of IOV_MAX
+  std::vector<iovec> vectors;
+  bench::measure_bytes("emit/cord_writev", bytes, [&] {
+    vectors.clear();
+    for (auto chunk : body_cord.chunks())
+      vectors.push_back({const_cast<char *>(chunk.data()), chunk.length()});
+    for (usize i = 0; i < vectors.size(); i += IOV_MAX) {
+      auto const count = vectors.size() - i < IOV_MAX ? vectors.size() - i
+                                                      : usize(IOV_MAX);
+      bench::keep(writev(sink, vectors.data() + i, as<int>(count)));
+    }
+  });
+  close(sink);
+#endif
+  return 0;
+}
\ No newline at end of file
@@ -0,0 +1,92 @@
+#include "bench.h"
+
+#include "zinc/format.h"
+
+#include <sstream>
+
+using namespace zinc;
+
+// a typical log line, a name, a padded integer, a float and a duration
+auto main() -> int {
+  constexpr u64 count = 1'000'000;
+  char const *const routes[] = {"/index.html", "/api/v1/users", "/health",
+                                "/static/app.js"};
+  auto random = bench::rng();
+  u32 statuses[256];
+  f64 sizes[256];
+  for (u32 i = 0; i < 256; ++i) {
+    statuses[i] = random.below(2) ? 200 : 404;
+    sizes[i] = as<f64>(random.below(1'000'000)) / 1000;
+  }
+
+  bench::measure("log_line/zinc::format_to", count, [&] {
+    char buffer[128];
+    usize total = 0;
+    for (u64 i = 0; i < count; ++i)
+      total += format_to(buffer, ZINC_FMT("{:<16} {:>5} {:.2f}KB {}"),
+                         routes[i & 3], statuses[i & 255], sizes[i & 255],
+                         duration::from_microseconds(i));
+    bench::keep(total);
+  });
+
+  bench::measure("log_line/zinc::format_string", count, [&] {
+    auto line = string();
+    usize total = 0;
+    for (u64 i = 0; i < count; ++i) {
+      line.resize(0);
+      format(line, ZINC_FMT("{:<16} {:>5} {:.2f}KB {}"), routes[i & 3],
+             statuses[i & 255], sizes[i & 255],
+             duration::from_microseconds(i));
+      total += line.length();
+    }
+    bench::keep(total);
+  });
+
+  bench::measure("log_line/snprintf", count, [&] {
+    char buffer[128];
+    usize total = 0;
+    for (u64 i = 0; i < count; ++i)
+      total += as<usize>(snprintf(buffer, sizeof(buffer),
+                                  "%-16s %5u %.2fKB %lluus", routes[i & 3],
+                                  statuses[i & 255], sizes[i & 255],
+                                  as<unsigned long long>(i)));
+    bench::keep(total);
+  });
+
+  bench::measure("log_line/ostringstream", count, [&] {
+    usize total = 0;
+    std::ostringstream line;
+    line.precision(2);
+    line << std::fixed;
+    for (u64 i = 0; i < count; ++i) {
+      line.str({});
+      line.width(16);
+      line << std::left << routes[i & 3] << ' ';
+      line.width(5);
+      line << std::right << statuses[i & 255] << ' ' << sizes[i & 255]
+           << "KB " << i << "us";
+      total += as<usize>(line.tellp());
+    }
+    bench::keep(total);
+  });
+
+  bench::measure("ints/zinc::format_to", count, [&] {
+    char buffer[128];
+    usize total = 0;
+    for (u64 i = 0; i < count; ++i)
+      total += format_to(buffer, ZINC_FMT("{},{},{:x}"), i, i * 7, i);
+    bench::keep(total);
+  });
+
+  bench::measure("ints/snprintf", count, [&] {
+    char buffer[128];
+    usize total = 0;
+    for (u64 i = 0; i < count; ++i)
+      total += as<usize>(snprintf(buffer, sizeof(buffer), "%llu,%llu,%llx",
+                                  as<unsigned long long>(i),
+                                  as<unsigned long long>(i * 7),
+                                  as<unsigned long long>(i)));
+    bench::keep(total);
+  });
+  return 0;
+}
\ No newline at end of file
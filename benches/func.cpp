@@ -0,0 +1,84 @@
+#include "bench.h"
+
+#include "zinc/func.h"
+#include "zinc/inplace_func.h"
+
+#include <functional>
+#include <vector>
+
+using namespace zinc;
+
+static u64 s_allocations = 0;
+
+auto operator new(size_t size) -> void * {
+  ++s_allocations;
+  if (auto *block = malloc(size ? size : 1))
+    return block;
+  throw std::bad_alloc();
+}
+auto operator delete(void *block) noexcept -> void { free(block); }
+auto operator delete(void *block, size_t) noexcept -> void { free(block); }
+
+// fills a queue with count tasks capturing two pointers and an index, the
+// way a task or callback queue would, then runs them
+template <typename TTask>
+static auto enqueue(char const *name, u64 count) -> void {
+  std::vector<TTask> queue;
+  queue.reserve(count);
+  u64 total = 0;
+  auto *sink = &total;
+  auto const before = s_allocations;
+  for (u64 i = 0; i < count; ++i)
+    queue.emplace_back([sink, &queue, i] { *sink += i + queue.size(); });
+  auto const allocations = s_allocations - before;
+  queue.clear();
+
+  bench::measure(name, count, [&] {
+    for (u64 i = 0; i < count; ++i)
+      queue.emplace_back([sink, &queue, i] { *sink += i + queue.size(); });
+    for (auto &task : queue)
+      task();
+    queue.clear();
+  });
+  bench::keep(total);
+  printf("%-48s %10.2f allocations/task\n", name,
+         as<f64>(allocations) / as<f64>(count));
+}
+
+// hands every value to a type-erased callback
+template <typename TCallback>
+static auto visit(u32 const *values, usize count, TCallback const &callback)
+    -> void {
+  for (usize i = 0; i < count; ++i)
+    callback(values[i]);
+}
+
+auto main() -> int {
+  constexpr u64 count = 1'000'000;
+  enqueue<std::function<void()>>("enqueue/std_function", count);
+  enqueue<func<void()>>("enqueue/func", count);
+  enqueue<inplace_func<void()>>("enqueue/inplace_func", count);
+  // a buffer too small for the captures, what every func used to do
+  enqueue<func<void(), sizeof(void *)>>("enqueue/func_on_heap", count);
+
+  std::vector<u32> values(count);
+  for (usize i = 0; i < count; ++i)
+    values[i] = as<u32>(i);
+  u64 total = 0;
+  auto const add = [&total](u32 value) { total += value; };
+
+  bench::measure("callback/std_function", count, [&] {
+    visit(values.data(), count, std::function<void(u32)>(add));
+  });
+  bench::measure("callback/func", count, [&] {
+    visit(values.data(), count, func<void(u32)>(add));
+  });
+  bench::measure("callback/inplace_func", count, [&] {
+    visit(values.data(), count, inplace_func<void(u32)>(add));
+  });
+  bench::measure("callback/function_ref", count, [&] {
+    visit(values.data(), count, function_ref<void(u32)>(add));
+  });
+  bench::keep(total);
+  return 0;
+}
\ No newline at end of file
@@ -0,0 +1,88 @@
+#include "bench.h"
+
+#include "zinc/hash.h"
+
+#include <functional>
+#include <string_view>
+#include <vector>
+
+using namespace zinc;
+
+// the fnv-1a loop that tends to get written when no hash is at hand
+static auto fnv1a(void const *data, usize size) -> u64 {
+  auto const *bytes = static_cast<u8 const *>(data);
+  u64 value = 0xcbf29ce484222325ull;
+  for (usize i = 0; i < size; ++i)
+    value = (value ^ bytes[i]) * 0x100000001b3ull;
+  return value;
+}
+
+template <typename THash>
+static auto hash_all(std::vector<u8> const &input, usize size, THash &&hash)
+    -> void {
+  for (usize at = 0; at + size <= input.size(); at += size)
+    bench::keep(hash(input.data() + at, size));
+}
+
+static auto run_size(std::vector<u8> const &input, usize size) -> void {
+  auto const bytes = input.size() / size * size;
+  char name[64];
+
+  snprintf(name, sizeof(name), "%zu/hash_bytes", size);
+  bench::measure_bytes(name, bytes, [&] {
+    hash_all(input, size,
+             [](u8 const *data, usize n) { return hash_bytes(data, n); });
+  });
+
+  snprintf(name, sizeof(name), "%zu/std_hash", size);
+  bench::measure_bytes(name, bytes, [&] {
+    hash_all(input, size, [](u8 const *data, usize n) {
+      return std::hash<std::string_view>{}(
+          std::string_view(reinterpret_cast<char const *>(data), n));
+    });
+  });
+
+  snprintf(name, sizeof(name), "%zu/fnv1a", size);
+  bench::measure_bytes(name, bytes,
+                       [&] { hash_all(input, size, fnv1a); });
+}
+
+// the same megabyte pushed through the streaming hasher in pieces
+static auto run_streaming(std::vector<u8> const &input, usize piece) -> void {
+  char name[64];
+  snprintf(name, sizeof(name), "hasher/pieces_of_%zu", piece);
+  bench::measure_bytes(name, input.size(), [&] {
+    hasher state;
+    for (usize at = 0; at < input.size(); at += piece)
+      state.update(input.data() + at, piece < input.size() - at
+                                          ? piece
+                                          : input.size() - at);
+    bench::keep(state.finish());
+  });
+}
+
+auto main() -> int {
+  constexpr usize megabyte = 1 << 20;
+  auto random = bench::rng();
+  std::vector<u8> input(megabyte);
+  for (auto &byte : input)
+    byte = as<u8>(random.next());
+
+  for (usize size : {usize(4), usize(8), usize(16), usize(32), usize(64),
+                     usize(256), usize(1024), usize(16384), megabyte})
+    run_size(input, size);
+
+  for (usize piece : {usize(7), usize(64), usize(4096)})
+    run_streaming(input, piece);
+
+  constexpr u64 keys = 10'000'000;
+  bench::measure("u64/hash_int", keys, [] {
+    for (u64 i = 0; i < keys; ++i)
+      bench::keep(hash_int(i));
+  });
+  bench::measure("u64/std_hash", keys, [] {
+    for (u64 i = 0; i < keys; ++i)
+      bench::keep(std::hash<u64>{}(i));
+  });
+  return 0;
+}
\ No newline at end of file
@@ -0,0 +1,128 @@
+#include "bench.h"
+
+#include "zinc/interner.h"
+
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+using namespace zinc;
+
+static auto make_names(u64 count) -> std::vector<std::string> {
+  static char const *const prefixes[] = {"http.server.", "db.pool.",
+                                         "cache.", "queue.consumer."};
+  static char const *const suffixes[] = {".count", ".latency_ms", ".errors",
+                                         ".bytes_in"};
+  auto random = bench::rng();
+  std::vector<std::string> names;
+  for (u64 i = 0; i < count; ++i)
+    names.push_back(prefixes[random.below(4)] + std::to_string(i) +
+                    suffixes[random.below(4)]);
+  return names;
+}
+
+// what code without an interner tends to do, a locked map from the string
+struct locked_map {
+  std::mutex m_mutex;
+  std::unordered_map<std::string, u32> m_ids;
+
+  auto intern(std::string const &name) -> u32 {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_ids.emplace(name, as<u32>(m_ids.size())).first->second;
+  }
+};
+
+auto main() -> int {
+  constexpr u64 lookups = 4'000'000;
+  auto const names = make_names(4'000);
+  auto random = bench::rng();
+  std::vector<u32> order(lookups);
+  for (auto &index : order)
+    index = as<u32>(random.below(names.size()));
+
+  interner table;
+  locked_map map;
+  std::vector<symbol> symbols;
+  for (auto const &name : names) {
+    symbols.push_back(table.intern(string_view(name.data(), name.size())));
+    map.intern(name);
+  }
+
+  bench::measure("intern_hit", lookups, [&] {
+    for (auto index : order) {
+      auto const &name = names[index];
+      bench::keep(table.intern(string_view(name.data(), name.size())));
+    }
+  });
+
+  bench::measure("locked_unordered_map_hit", lookups, [&] {
+    for (auto index : order)
+      bench::keep(map.intern(names[index]));
+  });
+
+  bench::measure("resolve", lookups, [&] {
+    for (auto index : order)
+      bench::keep(table.resolve(symbols[index]));
+  });
+
+  bench::measure("compare_symbol", lookups, [&] {
+    usize equal = 0;
+    for (u64 i = 1; i < lookups; ++i)
+      equal += symbols[order[i]] == symbols[order[i - 1]];
+    bench::keep(equal);
+  });
+
+  bench::measure("compare_string", lookups, [&] {
+    usize equal = 0;
+    for (u64 i = 1; i < lookups; ++i)
+      equal += names[order[i]] == names[order[i - 1]];
+    bench::keep(equal);
+  });
+
+  bench::measure("hash_symbol", lookups, [&] {
+    u64 total = 0;
+    for (auto index : order)
+      total += symbols[index].hash();
+    bench::keep(total);
+  });
+
+  bench::measure("hash_string", lookups, [&] {
+    u64 total = 0;
+    for (auto index : order)
+      total += std::hash<std::string>()(names[index]);
+    bench::keep(total);
+  });
+
+  auto const threads = std::thread::hardware_concurrency()
+                           ? std::thread::hardware_concurrency()
+                           : 4;
+  char name[64];
+  snprintf(name, sizeof(name), "intern_hit_x%u", threads);
+  bench::measure(name, lookups * threads, [&] {
+    std::vector<std::thread> workers;
+    for (u32 t = 0; t < threads; ++t)
+      workers.emplace_back([&] {
+        for (auto index : order) {
+          auto const &text = names[index];
+          bench::keep(table.intern(string_view(text.data(), text.size())));
+        }
+      });
+    for (auto &worker : workers)
+      worker.join();
+  });
+
+  snprintf(name, sizeof(name), "locked_unordered_map_hit_x%u", threads);
+  bench::measure(name, lookups * threads, [&] {
+    std::vector<std::thread> workers;
+    for (u32 t = 0; t < threads; ++t)
+      workers.emplace_back([&] {
+        for (auto index : order)
+          bench::keep(map.intern(names[index]));
+      });
+    for (auto &worker : workers)
+      worker.join();
+  });
+  return 0;
+}
\ No newline at end of file
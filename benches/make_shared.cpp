@@ -0,0 +1,75 @@
+#include "bench.h"
+
+#include "zinc/shared.h"
+
+#include <vector>
+
+using namespace zinc;
+
+static u64 s_allocations = 0;
+
+auto operator new(size_t size) -> void * {
+  ++s_allocations;
+  if (auto *block = malloc(size ? size : 1))
+    return block;
+  throw std::bad_alloc();
+}
+auto operator delete(void *block) noexcept -> void { free(block); }
+auto operator delete(void *block, size_t) noexcept -> void { free(block); }
+
+struct payload {
+  explicit payload(u64 seed) : value{seed, seed + 1, seed + 2} {}
+  u64 value[3];
+};
+
+template <typename TMake>
+static auto churn(char const *name, u64 count, TMake &&make) -> void {
+  auto const before = s_allocations;
+  for (u64 i = 0; i < count; ++i)
+    bench::keep(make(i)->value[0]);
+  auto const allocations = s_allocations - before;
+
+  bench::measure(name, count, [&] {
+    for (u64 i = 0; i < count; ++i)
+      bench::keep(make(i)->value[0]);
+  });
+  printf("%-48s %10.2f allocations/object\n", name,
+         as<f64>(allocations) / as<f64>(count));
+}
+
+// walks handles created between unrelated allocations, touching both the
+// object and its count like a copy would
+template <typename TMake>
+static auto traverse(char const *name, u64 count, TMake &&make) -> void {
+  std::vector<shared<payload>> handles;
+  std::vector<std::vector<u8>> noise;
+  handles.reserve(count);
+  for (u64 i = 0; i < count; ++i) {
+    handles.push_back(make(i));
+    noise.emplace_back(16 + i % 48);
+  }
+  bench::measure(name, count, [&] {
+    u64 sum = 0;
+    for (auto &handle : handles)
+      sum += handle->value[0] + handle.use_count();
+    bench::keep(sum);
+  });
+}
+
+auto main() -> int {
+  constexpr u64 count = 2'000'000;
+  auto separate = [](u64 i) { return shared<payload>(new payload(i)); };
+  auto inplace = [](u64 i) { return make_shared<payload>(i); };
+
+  churn("separate/churn", count, separate);
+  churn("make_shared/churn", count, inplace);
+
+  auto object_pool = pool(64, 1024);
+  churn("allocate_shared(pool)/churn", count, [&](u64 i) {
+    return allocate_shared<payload>(object_pool, i);
+  });
+
+  traverse("separate/traverse", count, separate);
+  traverse("make_shared/traverse", count, inplace);
+  return 0;
+}
\ No newline at end of file
@@ -0,0 +1,160 @@
+#include "bench.h"
+
+#include "zinc/number.h"
+
+#include <charconv>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace zinc;
+
+// a spread of widths rather than all 20 digit values
+static auto make_ints(u64 count) -> std::vector<u64> {
+  auto random = bench::rng();
+  std::vector<u64> values;
+  for (u64 i = 0; i < count; ++i)
+    values.push_back(random.next() >> random.below(64));
+  return values;
+}
+
+static auto make_floats(u64 count, bool prices) -> std::vector<f64> {
+  auto random = bench::rng();
+  std::vector<f64> values;
+  while (values.size() < count) {
+    if (prices) {
+      values.push_back(as<f64>(random.below(10'000'000)) / 100);
+      continue;
+    }
+    auto const bits = random.next();
+    f64 value;
+    memcpy(&value, &bits, sizeof(value));
+    if (value - value == 0)
+      values.push_back(value);
+  }
+  return values;
+}
+
+// texts packed back to back, each with a terminator for the C functions
+struct texts {
+  std::string m_buffer;
+  std::vector<u32> m_offsets;
+
+  template <typename TFormat> texts(u64 count, TFormat &&format) {
+    char scratch[64];
+    for (u64 i = 0; i < count; ++i) {
+      m_offsets.push_back(as<u32>(m_buffer.size()));
+      m_buffer.append(scratch, format(scratch, i));
+      m_buffer.push_back('\0');
+    }
+    m_offsets.push_back(as<u32>(m_buffer.size()));
+  }
+
+  auto size() const -> u64 { return m_offsets.size() - 1; }
+  auto data(u64 i) const -> char const * {
+    return m_buffer.data() + m_offsets[i];
+  }
+  auto view(u64 i) const -> string_view {
+    return {data(i), as<usize>(m_offsets[i + 1] - m_offsets[i] - 1)};
+  }
+};
+
+template <typename TValue, typename TFormat>
+static auto run_format(char const *name, std::vector<TValue> const &values,
+                       TFormat &&format) -> void {
+  bench::measure(name, values.size(), [&] {
+    char buffer[64];
+    usize total = 0;
+    for (auto value : values)
+      total += format(buffer, value);
+    bench::keep(total);
+  });
+}
+
+template <typename TParse>
+static auto run_parse(char const *name, texts const &inputs, TParse &&parse)
+    -> void {
+  bench::measure(name, inputs.size(), [&] {
+    u64 total = 0;
+    for (u64 i = 0; i < inputs.size(); ++i)
+      total += parse(inputs, i);
+    bench::keep(total);
+  });
+}
+
+static auto run_floats(char const *kind, std::vector<f64> const &values)
+    -> void {
+  char name[64];
+
+  snprintf(name, sizeof(name), "format_%s/zinc", kind);
+  run_format(name, values,
+             [](char *out, f64 value) { return format_float(out, value); });
+  snprintf(name, sizeof(name), "format_%s/snprintf_%%.17g", kind);
+  run_format(name, values, [](char *out, f64 value) {
+    return as<usize>(snprintf(out, 64, "%.17g", value));
+  });
+#if defined(__cpp_lib_to_chars)
+  snprintf(name, sizeof(name), "format_%s/std::to_chars", kind);
+  run_format(name, values, [](char *out, f64 value) {
+    return as<usize>(std::to_chars(out, out + 64, value).ptr - out);
+  });
+#endif
+
+  auto const inputs = texts(values.size(), [&](char *out, u64 i) {
+    return format_float(out, values[i]);
+  });
+  snprintf(name, sizeof(name), "parse_%s/zinc", kind);
+  run_parse(name, inputs, [](texts const &in, u64 i) {
+    return as<u64>(parse_float<f64>(in.view(i)).value_or(0) != 0);
+  });
+  snprintf(name, sizeof(name), "parse_%s/strtod", kind);
+  run_parse(name, inputs, [](texts const &in, u64 i) {
+    return as<u64>(strtod(in.data(i), nullptr) != 0);
+  });
+#if defined(__cpp_lib_to_chars)
+  snprintf(name, sizeof(name), "parse_%s/std::from_chars", kind);
+  run_parse(name, inputs, [](texts const &in, u64 i) {
+    f64 value = 0;
+    auto const text = in.view(i);
+    drop(std::from_chars(text.data(), text.data() + text.length(), value));
+    return as<u64>(value != 0);
+  });
+#endif
+}
+
+auto main() -> int {
+  constexpr u64 count = 1'000'000;
+
+  auto const ints = make_ints(count);
+  run_format("format_u64/zinc", ints,
+             [](char *out, u64 value) { return format_int(out, value); });
+  run_format("format_u64/snprintf", ints, [](char *out, u64 value) {
+    return as<usize>(snprintf(out, 64, "%llu", as<unsigned long long>(value)));
+  });
+  run_format("format_u64/std::to_chars", ints, [](char *out, u64 value) {
+    return as<usize>(std::to_chars(out, out + 64, value).ptr - out);
+  });
+
+  auto const int_texts = texts(count, [&](char *out, u64 i) {
+    return format_int(out, ints[i]);
+  });
+  run_parse("parse_u64/zinc", int_texts, [](texts const &in, u64 i) {
+    return parse_int<u64>(in.view(i)).value_or(0);
+  });
+  run_parse("parse_u64/strtoull", int_texts, [](texts const &in, u64 i) {
+    return as<u64>(strtoull(in.data(i), nullptr, 10));
+  });
+  run_parse("parse_u64/std::from_chars", int_texts,
+            [](texts const &in, u64 i) {
+              u64 value = 0;
+              auto const text = in.view(i);
+              drop(std::from_chars(text.data(), text.data() + text.length(),
+                                   value));
+              return value;
+            });
+
+  run_floats("f64_random", make_floats(count, false));
+  run_floats("f64_prices", make_floats(count, true));
+  return 0;
+}
\ No newline at end of file
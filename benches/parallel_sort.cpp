@@ -0,0 +1,116 @@
+#include "bench.h"
+
+#include "zinc/mt/parallel_sort.h"
+
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace zinc;
+
+struct order {
+  u64 price;
+  u32 id;
+  u32 quantity;
+};
+
+static auto thread_counts() -> std::vector<u32> {
+  auto const cores = std::thread::hardware_concurrency()
+                         ? std::thread::hardware_concurrency()
+                         : 4;
+  std::vector<u32> counts;
+  for (u32 threads = 1; threads < cores; threads *= 2)
+    counts.push_back(threads);
+  counts.push_back(cores);
+  return counts;
+}
+
+template <typename TValue, typename TSort>
+static auto scale(char const *kind, std::vector<TValue> const &input,
+                  TSort &&sort_with) -> void {
+  std::vector<TValue> work;
+  char name[64];
+  for (auto threads : thread_counts()) {
+    snprintf(name, sizeof(name), "%s/x%u", kind, threads);
+    bench::measure(
+        name, input.size(),
+        [&] {
+          work = input;
+          sort_with(work, threads);
+        },
+        3);
+  }
+}
+
+auto main() -> int {
+  constexpr u64 count = 10'000'000;
+  auto random = bench::rng();
+
+  std::vector<u64> integers(count);
+  for (auto &value : integers)
+    value = random.next();
+  std::vector<u64> work;
+  bench::measure(
+      "u64/zinc_sort", count,
+      [&] {
+        work = integers;
+        sort(work.data(), work.size());
+      },
+      3);
+  scale("u64/parallel_sort", integers,
+        [](std::vector<u64> &items, u32 threads) {
+          parallel_sort(items.data(), items.size(), threads);
+        });
+
+  std::vector<std::string> strings(count / 10);
+  for (auto &value : strings)
+    value = std::to_string(random.next());
+  std::vector<std::string> text;
+  bench::measure(
+      "string/zinc_sort", strings.size(),
+      [&] {
+        text = strings;
+        sort(text.data(), text.size(), std::less<std::string>());
+      },
+      3);
+  scale("string/parallel_sort", strings,
+        [](std::vector<std::string> &items, u32 threads) {
+          parallel_sort(items.data(), items.size(), std::less<std::string>(),
+                        threads);
+        });
+
+  std::vector<order> orders(count);
+  for (auto &entry : orders)
+    entry = {random.below(1'000'000), as<u32>(random.next()), 1};
+  auto const by_price = [](order const &a, order const &b) {
+    return a.price < b.price;
+  };
+  std::vector<order> sorted;
+  bench::measure(
+      "order_by_price/std_stable_sort", count,
+      [&] {
+        sorted = orders;
+        std::stable_sort(sorted.begin(), sorted.end(), by_price);
+      },
+      3);
+  scale("order_by_price/parallel_stable_sort", orders,
+        [&by_price](std::vector<order> &items, u32 threads) {
+          parallel_stable_sort(items.data(), items.size(), by_price, threads);
+        });
+
+  // two sorted halves into one
+  auto halves = integers;
+  auto const half = count / 2;
+  sort(halves.data(), half);
+  sort(halves.data() + half, count - half);
+  std::vector<u64> merged(count);
+  for (auto threads : thread_counts()) {
+    char name[64];
+    snprintf(name, sizeof(name), "u64/parallel_merge/x%u", threads);
+    bench::measure(name, count, [&] {
+      parallel_merge(halves.data(), half, halves.data() + half, count - half,
+                     merged.data(), threads);
+    });
+  }
+  return 0;
+}
\ No newline at end of file
@@ -0,0 +1,134 @@
+#include "bench.h"
+
+#include "zinc/range.h"
+
+#include <vector>
+
+using namespace zinc;
+
+static u64 s_allocations = 0;
+
+auto operator new(size_t size) -> void * {
+  ++s_allocations;
+  if (auto *block = malloc(size ? size : 1))
+    return block;
+  throw std::bad_alloc();
+}
+auto operator delete(void *block) noexcept -> void { free(block); }
+auto operator delete(void *block, size_t) noexcept -> void { free(block); }
+
+// times func and counts what one call of it allocates
+template <typename TFunc>
+static auto run(char const *name, u64 items, TFunc &&func) -> void {
+  func();
+  auto const before = s_allocations;
+  func();
+  auto const allocations = s_allocations - before;
+  bench::measure(name, items, func);
+  printf("%-48s %10llu allocations/run\n", name,
+         as<unsigned long long>(allocations));
+}
+
+auto main() -> int {
+  constexpr usize count = 1 << 20;
+  auto random = bench::rng();
+  std::vector<f32> prices(count);
+  for (auto &price : prices)
+    price = as<f32>(random.below(10'000)) / 100.0f;
+
+  auto const with_tax = [](f32 price) { return price * 1.2f; };
+  auto const over_limit = [](f32 price) { return price > 60.0f; };
+  auto const view = array_view<f32>(prices.data(), prices.size());
+
+  sys_allocator<f32> allocator;
+  vector<f32> out(allocator);
+  out.reserve(count);
+  std::vector<f32> std_out;
+  std_out.reserve(count);
+
+  // a step at a time, every step filling a container for the next
+  run("map+filter/materialized", count, [&] {
+    std::vector<f32> taxed;
+    taxed.reserve(count);
+    for (auto price : prices)
+      taxed.push_back(with_tax(price));
+    std::vector<f32> kept;
+    for (auto price : taxed)
+      if (over_limit(price))
+        kept.push_back(price);
+    std_out.assign(kept.begin(), kept.end());
+    bench::keep(std_out.data());
+  });
+
+  run("map+filter/hand_written", count, [&] {
+    std_out.clear();
+    for (auto price : prices) {
+      auto const taxed = with_tax(price);
+      if (over_limit(taxed))
+        std_out.push_back(taxed);
+    }
+    bench::keep(std_out.data());
+  });
+
+  run("map+filter/range", count, [&] {
+    out.clear();
+    from(view).map(with_tax).filter(over_limit).collect_into(out);
+    bench::keep(out.data());
+  });
+
+  // without a filter the chain is indexed and collect_into is one counted
+  // loop the compiler vectorises
+  run("map/hand_written", count, [&] {
+    std_out.resize(count);
+    for (usize i = 0; i < count; ++i)
+      std_out[i] = with_tax(prices[i]);
+    bench::keep(std_out.data());
+  });
+
+  run("map/range", count, [&] {
+    out.clear();
+    from(view).map(with_tax).collect_into(out);
+    bench::keep(out.data());
+  });
+
+  run("map+stride/materialized", count / 2, [&] {
+    std::vector<f32> taxed;
+    taxed.reserve(count);
+    for (auto price : prices)
+      taxed.push_back(with_tax(price));
+    std_out.clear();
+    for (usize i = 0; i < taxed.size(); i += 2)
+      std_out.push_back(taxed[i]);
+    bench::keep(std_out.data());
+  });
+
+  run("map+stride/range", count / 2, [&] {
+    out.clear();
+    from(view).map(with_tax).stride(2).collect_into(out);
+    bench::keep(out.data());
+  });
+
+  run("zip+map/range", count, [&] {
+    out.clear();
+    from(view)
+        .zip(from(view).map(with_tax))
+        .map([](auto pair) { return pair.second - pair.first; })
+        .collect_into(out);
+    bench::keep(out.data());
+  });
+
+  run("chunk+map/range", count / 64, [&] {
+    out.clear();
+    from(view)
+        .chunk(64)
+        .map([](array_view<f32> chunk) {
+          f32 sum = 0;
+          for (auto price : chunk)
+            sum += price;
+          return sum;
+        })
+        .collect_into(out);
+    bench::keep(out.data());
+  });
+  return 0;
+}
\ No newline at end of file
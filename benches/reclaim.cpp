@@ -0,0 +1,266 @@
+#include "bench.h"
+
+#include "zinc/mt/concurrent_pool.h"
+#include "zinc/mt/epoch.h"
+#include "zinc/mt/hazard.h"
+
+#include <thread>
+#include <vector>
+
+using namespace zinc;
+
+struct stack_node {
+  u64 value;
+  stack_node *next;
+};
+
+struct queue_node {
+  u64 value;
+  std::atomic<queue_node *> next;
+};
+
+// nodes come from the heap or from a shared pool, pooled nodes go back to it
+// in batches when their domain reclaims them
+template <bool pooled> struct node_source {
+  template <typename TNode> static auto create() -> TNode * {
+    if constexpr (pooled)
+      return nodes().template construct<TNode>();
+    else
+      return new TNode();
+  }
+
+  template <typename TNode> static void destroy(TNode *node) {
+    if constexpr (pooled)
+      nodes().destroy(node);
+    else
+      delete node;
+  }
+
+  template <typename TDomain, typename TNode>
+  static void retire(TDomain &domain, TNode *node) {
+    if constexpr (pooled)
+      domain.retire(nodes(), node);
+    else
+      domain.retire(node);
+  }
+
+  static auto nodes() -> concurrent_pool & {
+    static concurrent_pool pool(sizeof(queue_node), 1 << 16);
+    return pool;
+  }
+};
+
+// never frees a node while the benchmark runs, the cost of the structure
+// without any reclamation at all
+struct leak_reclaim {
+  struct guard {
+    template <typename TNode>
+    auto protect(std::atomic<TNode *> const &source, usize) -> TNode * {
+      return source.load(std::memory_order_acquire);
+    }
+  };
+
+  template <typename TNode> static auto create() -> TNode * {
+    return new TNode();
+  }
+  template <typename TNode> static void destroy(TNode *node) { delete node; }
+  template <typename TNode> static void retire(TNode *node) {
+    leaked().push_back(node);
+  }
+  static void quiesce() {
+    for (auto *node : leaked())
+      ::operator delete(node);
+    leaked().clear();
+  }
+
+  static auto leaked() -> std::vector<vptr> & {
+    static thread_local std::vector<vptr> nodes;
+    return nodes;
+  }
+};
+
+template <bool pooled> struct hazard_reclaim : node_source<pooled> {
+  struct guard {
+    hazard_pointer m_first;
+    hazard_pointer m_second;
+
+    template <typename TNode>
+    auto protect(std::atomic<TNode *> const &source, usize index)
+        -> TNode * {
+      return (index ? m_second : m_first).protect(source);
+    }
+  };
+
+  template <typename TNode> static void retire(TNode *node) {
+    node_source<pooled>::retire(hazard_domain::global(), node);
+  }
+  static void quiesce() { hazard_domain::global().reclaim(); }
+};
+
+template <bool pooled> struct epoch_reclaim : node_source<pooled> {
+  struct guard {
+    epoch_guard m_guard;
+
+    template <typename TNode>
+    auto protect(std::atomic<TNode *> const &source, usize) -> TNode * {
+      return source.load(std::memory_order_acquire);
+    }
+  };
+
+  template <typename TNode> static void retire(TNode *node) {
+    node_source<pooled>::retire(epoch_domain::global(), node);
+  }
+  static void quiesce() { epoch_domain::global().synchronize(); }
+};
+
+// treiber stack
+template <typename TReclaim> struct stack {
+  std::atomic<stack_node *> m_head{nullptr};
+
+  ~stack() {
+    for (auto *it = m_head.load(); it;) {
+      auto *next = it->next;
+      TReclaim::destroy(it);
+      it = next;
+    }
+  }
+
+  void push(u64 value) {
+    auto *node = TReclaim::template create<stack_node>();
+    node->value = value;
+    node->next = m_head.load(std::memory_order_relaxed);
+    while (!m_head.compare_exchange_weak(node->next, node,
+                                         std::memory_order_release,
+                                         std::memory_order_relaxed)) {
+    }
+  }
+
+  auto pop(u64 &value) -> bool {
+    typename TReclaim::guard guard;
+    for (;;) {
+      auto *top = guard.protect(m_head, 0);
+      if (!top)
+        return false;
+      if (m_head.compare_exchange_strong(top, top->next,
+                                         std::memory_order_acq_rel)) {
+        value = top->value;
+        TReclaim::retire(top);
+        return true;
+      }
+    }
+  }
+};
+
+// michael scott queue
+template <typename TReclaim> struct queue {
+  std::atomic<queue_node *> m_head;
+  std::atomic<queue_node *> m_tail;
+
+  queue() {
+    auto *dummy = TReclaim::template create<queue_node>();
+    m_head.store(dummy);
+    m_tail.store(dummy);
+  }
+
+  ~queue() {
+    for (auto *it = m_head.load(); it;) {
+      auto *next = it->next.load();
+      TReclaim::destroy(it);
+      it = next;
+    }
+  }
+
+  void push(u64 value) {
+    auto *node = TReclaim::template create<queue_node>();
+    node->value = value;
+    node->next.store(nullptr, std::memory_order_relaxed);
+
+    typename TReclaim::guard guard;
+    for (;;) {
+      auto *tail = guard.protect(m_tail, 0);
+      auto *next = tail->next.load(std::memory_order_acquire);
+      if (next) {
+        m_tail.compare_exchange_weak(tail, next, std::memory_order_release,
+                                     std::memory_order_relaxed);
+        continue;
+      }
+      if (tail->next.compare_exchange_weak(next, node,
+                                           std::memory_order_release,
+                                           std::memory_order_relaxed)) {
+        m_tail.compare_exchange_strong(tail, node, std::memory_order_release,
+                                       std::memory_order_relaxed);
+        return;
+      }
+    }
+  }
+
+  auto pop(u64 &value) -> bool {
+    typename TReclaim::guard guard;
+    for (;;) {
+      auto *head = guard.protect(m_head, 0);
+      auto *next = guard.protect(head->next, 1);
+      if (head != m_head.load(std::memory_order_acquire))
+        continue;
+      if (!next)
+        return false;
+      auto *tail = m_tail.load(std::memory_order_acquire);
+      if (head == tail) {
+        m_tail.compare_exchange_weak(tail, next, std::memory_order_release,
+                                     std::memory_order_relaxed);
+        continue;
+      }
+      value = next->value;
+      if (m_head.compare_exchange_strong(head, next,
+                                         std::memory_order_acq_rel)) {
+        TReclaim::retire(head);
+        return true;
+      }
+    }
+  }
+};
+
+// every thread pushes and pops in pairs so the structure stays small and the
+// threads keep fighting over the same few nodes
+template <typename TReclaim, template <typename> typename TStructure>
+static auto push_pop(u32 threads, u64 pairs) -> void {
+  TStructure<TReclaim> structure;
+  std::vector<std::thread> workers;
+  for (u32 t = 0; t < threads; ++t)
+    workers.emplace_back([&structure, pairs] {
+      u64 value = 0;
+      for (u64 i = 0; i < pairs; ++i) {
+        structure.push(i);
+        structure.pop(value);
+        bench::keep(value);
+      }
+      TReclaim::quiesce();
+    });
+  for (auto &worker : workers)
+    worker.join();
+  TReclaim::quiesce();
+}
+
+template <typename TReclaim> static auto run(char const *policy) -> void {
+  constexpr u64 pairs = 500'000;
+  auto const threads = std::thread::hardware_concurrency()
+                           ? std::thread::hardware_concurrency()
+                           : 4;
+  char name[64];
+
+  snprintf(name, sizeof(name), "stack/%s_x%u", policy, threads);
+  bench::measure(name, pairs * 2 * threads,
+                 [threads] { push_pop<TReclaim, stack>(threads, pairs); });
+
+  snprintf(name, sizeof(name), "queue/%s_x%u", policy, threads);
+  bench::measure(name, pairs * 2 * threads,
+                 [threads] { push_pop<TReclaim, queue>(threads, pairs); });
+}
+
+auto main() -> int {
+  run<leak_reclaim>("leak");
+  run<hazard_reclaim<false>>("hazard");
+  run<hazard_reclaim<true>>("hazard_pool");
+  run<epoch_reclaim<false>>("epoch");
+  run<epoch_reclaim<true>>("epoch_pool");
+  return 0;
+}
\ No newline at end of file
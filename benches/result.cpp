@@ -0,0 +1,116 @@
+#include "bench.h"
+
+#include "zinc/result.h"
+
+#include <string>
+#include <vector>
+
+using namespace zinc;
+
+// Parses "a,b,c" lines of numbers and sums their fields, failing on a bad
+// digit three calls down, once returning results and once throwing.
+
+enum class parse_error : u8 { bad_digit, empty };
+
+static auto parse_field(char const *&cursor) -> result<u32, parse_error> {
+  if (*cursor == ',' || *cursor == '\0')
+    return Err(parse_error::empty);
+  u32 value = 0;
+  for (; *cursor != ',' && *cursor != '\0'; ++cursor) {
+    if (*cursor < '0' || *cursor > '9')
+      return Err(parse_error::bad_digit);
+    value = value * 10 + as<u32>(*cursor - '0');
+  }
+  return Ok(value);
+}
+
+static auto parse_line(char const *cursor) -> result<u32, parse_error> {
+  ZINC_TRY(auto first, parse_field(cursor));
+  ++cursor;
+  ZINC_TRY(auto second, parse_field(cursor));
+  ++cursor;
+  ZINC_TRY(auto third, parse_field(cursor));
+  return Ok(first + second + third);
+}
+
+struct parse_exception {
+  parse_error error;
+};
+
+static auto parse_field_or_throw(char const *&cursor) -> u32 {
+  if (*cursor == ',' || *cursor == '\0')
+    throw parse_exception{parse_error::empty};
+  u32 value = 0;
+  for (; *cursor != ',' && *cursor != '\0'; ++cursor) {
+    if (*cursor < '0' || *cursor > '9')
+      throw parse_exception{parse_error::bad_digit};
+    value = value * 10 + as<u32>(*cursor - '0');
+  }
+  return value;
+}
+
+static auto parse_line_or_throw(char const *cursor) -> u32 {
+  auto const first = parse_field_or_throw(cursor);
+  ++cursor;
+  auto const second = parse_field_or_throw(cursor);
+  ++cursor;
+  auto const third = parse_field_or_throw(cursor);
+  return first + second + third;
+}
+
+static auto run(std::vector<std::string> const &lines, char const *rate)
+    -> void {
+  char name[64];
+
+  snprintf(name, sizeof(name), "errors=%s/result", rate);
+  bench::measure(name, lines.size(), [&] {
+    u64 total = 0;
+    u64 failed = 0;
+    for (auto const &line : lines) {
+      auto const parsed = parse_line(line.c_str());
+      if (parsed)
+        total += parsed.value();
+      else
+        ++failed;
+    }
+    bench::keep(total);
+    bench::keep(failed);
+  });
+
+  snprintf(name, sizeof(name), "errors=%s/exceptions", rate);
+  bench::measure(name, lines.size(), [&] {
+    u64 total = 0;
+    u64 failed = 0;
+    for (auto const &line : lines) {
+      try {
+        total += parse_line_or_throw(line.c_str());
+      } catch (parse_exception const &) {
+        ++failed;
+      }
+    }
+    bench::keep(total);
+    bench::keep(failed);
+  });
+}
+
+auto main() -> int {
+  constexpr usize count = 200'000;
+  auto random = bench::rng();
+  // one line in every_nth has a bad digit in its last field
+  for (u64 every_nth : {0, 1000, 100, 10, 2}) {
+    std::vector<std::string> lines(count);
+    for (usize i = 0; i < count; ++i) {
+      auto &line = lines[i];
+      line = std::to_string(random.below(100'000)) + "," +
+             std::to_string(random.below(100'000)) + "," +
+             std::to_string(random.below(100'000));
+      if (every_nth && random.below(every_nth) == 0)
+        line.back() = 'x';
+    }
+    char rate[16];
+    snprintf(rate, sizeof(rate), "%.1f%%",
+             every_nth ? 100.0 / as<f64>(every_nth) : 0.0);
+    run(lines, rate);
+  }
+  return 0;
+}
\ No newline at end of file
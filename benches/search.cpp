@@ -0,0 +1,73 @@
+#include "bench.h"
+
+#include "zinc/algorithm.h"
+#include "zinc/search_index.h"
+
+#include <algorithm>
+#include <vector>
+
+using namespace zinc;
+
+// random lookups into a sorted array of count u32 values, about half of
+// them present
+static auto run(usize count) -> void {
+  auto random = bench::rng();
+  std::vector<u32> sorted(count);
+  for (auto &value : sorted)
+    value = as<u32>(random.below(u64(count) * 2));
+  std::sort(sorted.begin(), sorted.end());
+  std::vector<u32> keys(1 << 20);
+  for (auto &key : keys)
+    key = as<u32>(random.below(u64(count) * 2));
+
+  auto const view = array_view<u32>(sorted.data(), sorted.size());
+  eytzinger_index<u32> eytzinger(view);
+  btree_index<u32> btree(view);
+  auto const lookups = as<u64>(keys.size());
+  char name[64];
+
+  snprintf(name, sizeof(name), "%zuKiB/std_lower_bound", count * 4 / 1024);
+  bench::measure(name, lookups, [&] {
+    usize total = 0;
+    for (auto key : keys)
+      total += as<usize>(std::lower_bound(sorted.begin(), sorted.end(), key) -
+                         sorted.begin());
+    bench::keep(total);
+  });
+
+  snprintf(name, sizeof(name), "%zuKiB/lower_bound", count * 4 / 1024);
+  bench::measure(name, lookups, [&] {
+    usize total = 0;
+    for (auto key : keys)
+      total += lower_bound(view, key);
+    bench::keep(total);
+  });
+
+  snprintf(name, sizeof(name), "%zuKiB/eytzinger_index", count * 4 / 1024);
+  bench::measure(name, lookups, [&] {
+    u64 total = 0;
+    for (auto key : keys) {
+      auto const *found = eytzinger.lower_bound(key);
+      total += found ? *found : 0;
+    }
+    bench::keep(total);
+  });
+
+  snprintf(name, sizeof(name), "%zuKiB/btree_index", count * 4 / 1024);
+  bench::measure(name, lookups, [&] {
+    u64 total = 0;
+    for (auto key : keys) {
+      auto const *found = btree.lower_bound(key);
+      total += found ? *found : 0;
+    }
+    bench::keep(total);
+  });
+}
+
+auto main() -> int {
+  // 4KiB sits in L1, 256KiB in L2, 16MiB in L3 on most machines and
+  // 256MiB is out in memory
+  for (usize count = 1 << 10; count <= (1 << 26); count *= 4)
+    run(count);
+  return 0;
+}
\ No newline at end of file
@@ -0,0 +1,101 @@
+#include "bench.h"
+
+#include "zinc/shared.h"
+
+#include <thread>
+#include <vector>
+
+using namespace zinc;
+
+struct payload {
+  u64 value[4];
+};
+
+template <typename TShared> static auto copy_chain(u64 count) -> void {
+  auto root = TShared(new payload{});
+  for (u64 i = 0; i < count; ++i) {
+    auto copy = root;
+    bench::keep(copy);
+  }
+}
+
+template <typename TShared> static auto fan_out(u64 rounds) -> void {
+  auto root = TShared(new payload{});
+  std::vector<TShared> slots(256);
+  for (u64 i = 0; i < rounds; ++i) {
+    for (auto &slot : slots)
+      slot = root;
+    for (auto &slot : slots)
+      slot = nullptr;
+  }
+}
+
+// every thread copies handles to an object it created itself
+template <typename TShared>
+static auto private_copies(u32 threads, u64 count) -> void {
+  std::vector<std::thread> workers;
+  for (u32 t = 0; t < threads; ++t)
+    workers.emplace_back([count] { copy_chain<TShared>(count); });
+  for (auto &worker : workers)
+    worker.join();
+}
+
+// the owner copies most of the time, the other threads now and then
+template <typename TShared>
+static auto mostly_owner(u32 threads, u64 count) -> void {
+  auto root = TShared(new payload{});
+  std::vector<std::thread> workers;
+  for (u32 t = 1; t < threads; ++t)
+    workers.emplace_back([root, count] {
+      for (u64 i = 0; i < count / 64; ++i) {
+        auto copy = root;
+        bench::keep(copy);
+      }
+    });
+  for (u64 i = 0; i < count; ++i) {
+    auto copy = root;
+    bench::keep(copy);
+  }
+  for (auto &worker : workers)
+    worker.join();
+  biased_count::reconcile();
+}
+
+template <typename TShared> static auto run(char const *policy) -> void {
+  constexpr u64 count = 10'000'000;
+  constexpr u64 rounds = 20'000;
+  char name[64];
+
+  snprintf(name, sizeof(name), "%s/copy_chain", policy);
+  bench::measure(name, count, [] { copy_chain<TShared>(count); });
+
+  snprintf(name, sizeof(name), "%s/fan_out_256", policy);
+  bench::measure(name, rounds * 256, [] { fan_out<TShared>(rounds); });
+}
+
+template <typename TShared>
+static auto run_threaded(char const *policy) -> void {
+  constexpr u64 count = 5'000'000;
+  auto const threads = std::thread::hardware_concurrency()
+                           ? std::thread::hardware_concurrency()
+                           : 4;
+  char name[64];
+
+  snprintf(name, sizeof(name), "%s/private_copies_x%u", policy, threads);
+  bench::measure(name, count * threads,
+                 [threads] { private_copies<TShared>(threads, count); });
+
+  snprintf(name, sizeof(name), "%s/mostly_owner_x%u", policy, threads);
+  bench::measure(name, count,
+                 [threads] { mostly_owner<TShared>(threads, count); });
+}
+
+auto main() -> int {
+  run<local_shared<payload>>("local");
+  run<shared<payload>>("atomic");
+  run<biased_shared<payload>>("biased");
+
+  run_threaded<shared<payload>>("atomic");
+  run_threaded<biased_shared<payload>>("biased");
+  return 0;
+}
\ No newline at end of file
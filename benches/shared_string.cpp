@@ -0,0 +1,98 @@
+#include "bench.h"
+
+#include "zinc/shared_string.h"
+
+#include <thread>
+#include <vector>
+
+using namespace zinc;
+
+// hands one payload to every consumer slot, the way a broadcast does
+template <typename TString>
+static auto fan_out(TString const &payload, std::vector<TString> &slots,
+                    u64 rounds) -> void {
+  for (u64 i = 0; i < rounds; ++i) {
+    for (auto &slot : slots)
+      slot = payload;
+    bench::keep(slots.back().data());
+  }
+}
+
+template <typename TString>
+static auto fan_out_threads(TString const &payload, u32 threads, u64 count)
+    -> void {
+  std::vector<std::thread> workers;
+  for (u32 t = 0; t < threads; ++t)
+    workers.emplace_back([&payload, count] {
+      for (u64 i = 0; i < count; ++i) {
+        auto copy = payload;
+        bench::keep(copy.data());
+      }
+    });
+  for (auto &worker : workers)
+    worker.join();
+}
+
+static auto run(usize size) -> void {
+  constexpr u64 rounds = 2'000;
+  constexpr u64 consumers = 64;
+  constexpr u64 copies = 200'000;
+  auto const threads = std::thread::hardware_concurrency()
+                           ? std::thread::hardware_concurrency()
+                           : 4;
+  auto const text = string(size, sys_allocator<char>());
+  auto const shared = shared_string(text.as_string_view());
+  char name[64];
+
+  std::vector<string> strings(consumers);
+  snprintf(name, sizeof(name), "%zu/string/fan_out_%llu", size,
+           as<unsigned long long>(consumers));
+  bench::measure(name, rounds * consumers,
+                 [&] { fan_out(text, strings, rounds); });
+
+  std::vector<shared_string> shareds(consumers);
+  snprintf(name, sizeof(name), "%zu/shared_string/fan_out_%llu", size,
+           as<unsigned long long>(consumers));
+  bench::measure(name, rounds * consumers,
+                 [&] { fan_out(shared, shareds, rounds); });
+
+  snprintf(name, sizeof(name), "%zu/string/copy_x%u", size, threads);
+  bench::measure(name, copies * threads,
+                 [&] { fan_out_threads(text, threads, copies); });
+
+  snprintf(name, sizeof(name), "%zu/shared_string/copy_x%u", size, threads);
+  bench::measure(name, copies * threads,
+                 [&] { fan_out_threads(shared, threads, copies); });
+
+  snprintf(name, sizeof(name), "%zu/shared_string/substr", size);
+  bench::measure(name, copies, [&] {
+    for (u64 i = 0; i < copies; ++i) {
+      auto part = shared.substr(i % size, 16);
+      bench::keep(part.data());
+    }
+  });
+
+  // building from a finished string, copying the bytes or taking the buffer
+  snprintf(name, sizeof(name), "%zu/shared_string/from_view", size);
+  bench::measure(name, rounds, [&] {
+    for (u64 i = 0; i < rounds; ++i) {
+      auto built = string(text);
+      auto result = shared_string(built.as_string_view());
+      bench::keep(result.data());
+    }
+  });
+  snprintf(name, sizeof(name), "%zu/shared_string/adopt", size);
+  bench::measure(name, rounds, [&] {
+    for (u64 i = 0; i < rounds; ++i) {
+      auto built = string(text);
+      auto result = shared_string(std::move(built));
+      bench::keep(result.data());
+    }
+  });
+}
+
+auto main() -> int {
+  for (usize size : {usize(64), usize(4096), usize(256 * 1024)})
+    run(size);
+  return 0;
+}
\ No newline at end of file
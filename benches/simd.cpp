@@ -0,0 +1,111 @@
+#include "bench.h"
+
+#include "zinc/simd.h"
+
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+using namespace zinc;
+
+// about a million values with the needle only in the very last slot, so
+// the searches all walk the whole array
+template <typename TValue> static auto make_values() -> std::vector<TValue> {
+  auto random = bench::rng();
+  std::vector<TValue> values(1 << 20);
+  for (auto &value : values)
+    value = as<TValue>(random.below(100));
+  values.back() = as<TValue>(100);
+  return values;
+}
+
+template <typename TValue>
+static auto run_std(char const *kind, std::vector<TValue> const &values)
+    -> void {
+  auto const bytes = as<u64>(values.size() * sizeof(TValue));
+  auto const copy = values;
+  auto const needle = as<TValue>(100);
+  char name[64];
+
+  snprintf(name, sizeof(name), "%s/std/find", kind);
+  bench::measure_bytes(name, bytes, [&] {
+    bench::keep(std::find(values.begin(), values.end(), needle));
+  });
+  snprintf(name, sizeof(name), "%s/std/count", kind);
+  bench::measure_bytes(name, bytes, [&] {
+    bench::keep(std::count(values.begin(), values.end(), needle));
+  });
+  snprintf(name, sizeof(name), "%s/std/all_of", kind);
+  bench::measure_bytes(name, bytes, [&] {
+    bench::keep(std::all_of(values.begin(), values.end(),
+                            [&](TValue value) { return value < needle; }));
+  });
+  snprintf(name, sizeof(name), "%s/std/minmax_element", kind);
+  bench::measure_bytes(name, bytes, [&] {
+    bench::keep(std::minmax_element(values.begin(), values.end()));
+  });
+  snprintf(name, sizeof(name), "%s/std/accumulate", kind);
+  bench::measure_bytes(name, bytes, [&] {
+    bench::keep(std::accumulate(values.begin(), values.end(),
+                                simd::sum_type<TValue>(0)));
+  });
+  snprintf(name, sizeof(name), "%s/std/mismatch", kind);
+  bench::measure_bytes(name, bytes, [&] {
+    bench::keep(std::mismatch(values.begin(), values.end(), copy.begin()));
+  });
+}
+
+template <typename TValue>
+static auto run(char const *level, char const *kind,
+                std::vector<TValue> const &values) -> void {
+  auto const bytes = as<u64>(values.size() * sizeof(TValue));
+  auto const copy = values;
+  auto const items = array_view<TValue>(values.data(), values.size());
+  auto const same = array_view<TValue>(copy.data(), copy.size());
+  auto const needle = as<TValue>(100);
+  char name[64];
+
+  snprintf(name, sizeof(name), "%s/%s/find", kind, level);
+  bench::measure_bytes(name, bytes,
+                       [&] { bench::keep(simd::find(items, needle)); });
+  snprintf(name, sizeof(name), "%s/%s/count", kind, level);
+  bench::measure_bytes(name, bytes,
+                       [&] { bench::keep(simd::count(items, needle)); });
+  snprintf(name, sizeof(name), "%s/%s/all_of", kind, level);
+  bench::measure_bytes(name, bytes, [&] {
+    bench::keep(simd::all_of(items, simd::less_than(needle)));
+  });
+  snprintf(name, sizeof(name), "%s/%s/min_max", kind, level);
+  bench::measure_bytes(name, bytes, [&] {
+    bench::keep(simd::min_max(items).value().max);
+  });
+  snprintf(name, sizeof(name), "%s/%s/sum", kind, level);
+  bench::measure_bytes(name, bytes,
+                       [&] { bench::keep(simd::sum(items)); });
+  snprintf(name, sizeof(name), "%s/%s/mismatch", kind, level);
+  bench::measure_bytes(name, bytes,
+                       [&] { bench::keep(simd::mismatch(items, same)); });
+}
+
+auto main() -> int {
+  auto const bytes = make_values<u8>();
+  auto const ints = make_values<i32>();
+  auto const longs = make_values<u64>();
+  auto const floats = make_values<f32>();
+  auto const doubles = make_values<f64>();
+
+  run_std("u8", bytes);
+  run_std("i32", ints);
+  run_std("u64", longs);
+  run_std("f32", floats);
+  run_std("f64", doubles);
+
+  bench::for_each_cpu_level([&](char const *level) {
+    run(level, "u8", bytes);
+    run(level, "i32", ints);
+    run(level, "u64", longs);
+    run(level, "f32", floats);
+    run(level, "f64", doubles);
+  });
+  return 0;
+}
\ No newline at end of file
@@ -0,0 +1,101 @@
+#include "bench.h"
+
+#include "zinc/algorithm.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+using namespace zinc;
+
+enum class shape { random, sorted, reversed, few_unique };
+
+static char const *const shape_names[] = {"random", "sorted", "reversed",
+                                          "few_unique"};
+
+template <typename TValue, typename TMake>
+static auto make_input(shape kind, u64 count, TMake &&make)
+    -> std::vector<TValue> {
+  auto random = bench::rng();
+  std::vector<TValue> values(count);
+  for (auto &value : values)
+    value = make(kind == shape::few_unique ? random.below(16) : random.next());
+  if (kind == shape::sorted)
+    std::sort(values.begin(), values.end());
+  else if (kind == shape::reversed)
+    std::sort(values.rbegin(), values.rend());
+  return values;
+}
+
+template <typename TValue, typename TMake>
+static auto run(char const *type, u64 count, TMake &&make) -> void {
+  char name[64];
+  for (u32 kind = 0; kind < 4; ++kind) {
+    auto const input = make_input<TValue>(as<shape>(kind), count, make);
+    std::vector<TValue> work;
+
+    snprintf(name, sizeof(name), "%s/%s/std_sort", type, shape_names[kind]);
+    bench::measure(name, count, [&] {
+      work = input;
+      std::sort(work.begin(), work.end());
+    });
+
+    snprintf(name, sizeof(name), "%s/%s/zinc_sort", type, shape_names[kind]);
+    bench::measure(name, count, [&] {
+      work = input;
+      zinc::sort(work.data(), work.size());
+    });
+
+    // the comparison sort on its own, without the radix dispatch
+    snprintf(name, sizeof(name), "%s/%s/zinc_sort_compare", type,
+             shape_names[kind]);
+    bench::measure(name, count, [&] {
+      work = input;
+      zinc::sort(work.data(), work.size(), std::less<TValue>());
+    });
+  }
+}
+
+struct order {
+  u64 price;
+  u32 id;
+  u32 quantity;
+};
+
+static auto run_by_key(u64 count) -> void {
+  auto random = bench::rng();
+  std::vector<order> input(count);
+  for (auto &entry : input)
+    entry = {random.below(1'000'000), as<u32>(random.next()), 1};
+  std::vector<order> work;
+  auto const by_price = [](order const &a, order const &b) {
+    return a.price < b.price;
+  };
+
+  bench::measure("order_by_price/std_stable_sort", count, [&] {
+    work = input;
+    std::stable_sort(work.begin(), work.end(), by_price);
+  });
+  bench::measure("order_by_price/std_sort", count, [&] {
+    work = input;
+    std::sort(work.begin(), work.end(), by_price);
+  });
+  bench::measure("order_by_price/zinc_sort_by_key", count, [&] {
+    work = input;
+    sort_by_key(work.data(), work.size(),
+                [](order const &entry) { return entry.price; });
+  });
+}
+
+auto main() -> int {
+  constexpr u64 count = 1'000'000;
+  run<u32>("u32", count, [](u64 bits) { return as<u32>(bits); });
+  run<u64>("u64", count, [](u64 bits) { return bits; });
+  run<f64>("f64", count, [](u64 bits) {
+    return as<f64>(as<i64>(bits)) / 1024.0;
+  });
+  run<std::string>("string", count / 4,
+                   [](u64 bits) { return std::to_string(bits); });
+  run_by_key(count);
+  return 0;
+}
\ No newline at end of file
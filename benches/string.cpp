@@ -0,0 +1,86 @@
+#include "bench.h"
+
+#include "zinc/string.h"
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace zinc;
+
+// keys short enough for zinc's inline buffer, the longer ones are past what
+// libstdc++ and msvc keep inline
+static auto make_keys(u64 count, usize min_length, usize max_length)
+    -> std::vector<std::string> {
+  auto random = bench::rng();
+  std::vector<std::string> keys;
+  keys.reserve(count);
+  for (u64 i = 0; i < count; ++i) {
+    auto const length =
+        min_length + as<usize>(random.below(max_length - min_length + 1));
+    std::string key(length, ' ');
+    for (auto &c : key)
+      c = as<char>('a' + random.below(26));
+    keys.push_back(std::move(key));
+  }
+  return keys;
+}
+
+template <typename TString>
+static auto construct(std::vector<std::string> const &keys) -> void {
+  for (auto const &key : keys) {
+    auto value = TString(key.data(), key.size());
+    bench::keep(value);
+  }
+}
+
+template <typename TString>
+static auto copy(std::vector<TString> const &values) -> void {
+  for (auto const &value : values) {
+    auto duplicate = value;
+    bench::keep(duplicate);
+  }
+}
+
+template <typename TString>
+static auto hash(std::vector<TString> const &values) -> void {
+  usize total = 0;
+  for (auto const &value : values)
+    total += std::hash<std::string_view>()(
+        std::string_view(value.data(), value.size()));
+  bench::keep(total);
+}
+
+template <typename TString>
+static auto run(char const *type, char const *keys_name,
+                std::vector<std::string> const &keys) -> void {
+  std::vector<TString> values;
+  values.reserve(keys.size());
+  for (auto const &key : keys)
+    values.emplace_back(key.data(), key.size());
+
+  char name[64];
+  snprintf(name, sizeof(name), "%s/construct_%s", type, keys_name);
+  bench::measure(name, keys.size(), [&] { construct<TString>(keys); });
+
+  snprintf(name, sizeof(name), "%s/copy_%s", type, keys_name);
+  bench::measure(name, keys.size(), [&] { copy(values); });
+
+  snprintf(name, sizeof(name), "%s/hash_%s", type, keys_name);
+  bench::measure(name, keys.size(), [&] { hash(values); });
+}
+
+auto main() -> int {
+  constexpr u64 count = 1'000'000;
+  auto const tiny = make_keys(count, 4, 12);
+  auto const short_keys = make_keys(count, 16, 22);
+  auto const long_keys = make_keys(count, 32, 64);
+
+  run<std::string>("std", "4_12", tiny);
+  run<string>("zinc", "4_12", tiny);
+  run<std::string>("std", "16_22", short_keys);
+  run<string>("zinc", "16_22", short_keys);
+  run<std::string>("std", "32_64", long_keys);
+  run<string>("zinc", "32_64", long_keys);
+  return 0;
+}
\ No newline at end of file
@@ -0,0 +1,185 @@
+#include "bench.h"
+
+#include "zinc/string.h"
+
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace zinc;
+
+static char const *const levels[] = {"DEBUG", "INFO", "WARN", "ERROR"};
+static char const *const paths[] = {"/api/v1/items", "/api/v1/users/profile",
+                                    "/healthz", "/api/v2/search",
+                                    "/static/app.js"};
+
+// access log style lines, space separated fields with key=value pairs and a
+// quoted user agent
+static auto make_log(u64 lines) -> std::string {
+  auto random = bench::rng();
+  std::string log;
+  char line[512];
+  for (u64 i = 0; i < lines; ++i) {
+    auto const length = snprintf(
+        line, sizeof(line),
+        "2026-10-19T12:%02u:%02u.%03uZ %s [worker-%u] request id=%016llx "
+        "path=%s/%u status=%u latency_ms=%u.%u bytes=%u "
+        "user_agent=\"Mozilla/5.0 (X11; Linux x86_64) zinc/%u.%u\"\n",
+        as<u32>(random.below(60)), as<u32>(random.below(60)),
+        as<u32>(random.below(1000)), levels[random.below(4)],
+        as<u32>(random.below(16)),
+        static_cast<unsigned long long>(random.next()),
+        paths[random.below(5)], as<u32>(random.below(100000)),
+        random.below(10) ? 200u : 500u, as<u32>(random.below(400)),
+        as<u32>(random.below(10)), as<u32>(random.below(1 << 20)),
+        as<u32>(random.below(4)), as<u32>(random.below(20)));
+    log.append(line, as<usize>(length));
+  }
+  return log;
+}
+
+static auto run(char const *level, std::string const &log) -> void {
+  auto const view = string_view(log.data(), log.size());
+  auto const bytes = as<u64>(log.size());
+  char name[64];
+
+  snprintf(name, sizeof(name), "zinc_%s/count_lines", level);
+  bench::measure_bytes(name, bytes, [&] { bench::keep(view.count('\n')); });
+
+  snprintf(name, sizeof(name), "zinc_%s/find_status_500", level);
+  bench::measure_bytes(name, bytes, [&] {
+    usize hits = 0;
+    for (auto pos = view.find("status=500"); pos != string_view::npos;
+         pos = view.find("status=500", pos + 1))
+      ++hits;
+    bench::keep(hits);
+  });
+
+  snprintf(name, sizeof(name), "zinc_%s/last_error", level);
+  bench::measure_bytes(name, bytes, [&] {
+    usize hits = 0;
+    auto end = string_view::npos;
+    for (auto pos = view.rfind('E', end); pos != string_view::npos && pos > 0;
+         pos = view.rfind('E', pos - 1))
+      ++hits;
+    bench::keep(hits);
+  });
+
+  snprintf(name, sizeof(name), "zinc_%s/find_first_of_quote_eq", level);
+  bench::measure_bytes(name, bytes, [&] {
+    usize hits = 0;
+    for (auto pos = view.find_first_of("\"=["); pos != string_view::npos;
+         pos = view.find_first_of("\"=[", pos + 1))
+      ++hits;
+    bench::keep(hits);
+  });
+
+  snprintf(name, sizeof(name), "zinc_%s/split_lines", level);
+  bench::measure_bytes(name, bytes, [&] {
+    usize total = 0;
+    for (auto line : view.split('\n'))
+      total += line.length();
+    bench::keep(total);
+  });
+
+  snprintf(name, sizeof(name), "zinc_%s/tokenize_fields", level);
+  bench::measure_bytes(name, bytes, [&] {
+    usize fields = 0;
+    for (auto field : view.tokenize(" \n")) {
+      bench::keep(field);
+      ++fields;
+    }
+    bench::keep(fields);
+  });
+}
+
+static auto run_std(std::string const &log) -> void {
+  auto const view = std::string_view(log);
+  auto const bytes = as<u64>(log.size());
+
+  bench::measure_bytes("std/count_lines", bytes, [&] {
+    usize lines = 0;
+    for (auto c : view)
+      lines += c == '\n';
+    bench::keep(lines);
+  });
+
+  bench::measure_bytes("std/find_status_500", bytes, [&] {
+    usize hits = 0;
+    for (auto pos = view.find("status=500"); pos != std::string_view::npos;
+         pos = view.find("status=500", pos + 1))
+      ++hits;
+    bench::keep(hits);
+  });
+
+  bench::measure_bytes("std/last_error", bytes, [&] {
+    usize hits = 0;
+    for (auto pos = view.rfind('E'); pos != std::string_view::npos && pos > 0;
+         pos = view.rfind('E', pos - 1))
+      ++hits;
+    bench::keep(hits);
+  });
+
+  bench::measure_bytes("std/find_first_of_quote_eq", bytes, [&] {
+    usize hits = 0;
+    for (auto pos = view.find_first_of("\"=[");
+         pos != std::string_view::npos;
+         pos = view.find_first_of("\"=[", pos + 1))
+      ++hits;
+    bench::keep(hits);
+  });
+
+  bench::measure_bytes("std/split_lines", bytes, [&] {
+    usize total = 0;
+    usize start = 0;
+    for (;;) {
+      auto const end = view.find('\n', start);
+      if (end == std::string_view::npos) {
+        total += view.size() - start;
+        break;
+      }
+      total += end - start;
+      start = end + 1;
+    }
+    bench::keep(total);
+  });
+
+  bench::measure_bytes("std/tokenize_fields", bytes, [&] {
+    usize fields = 0;
+    usize start = 0;
+    for (;;) {
+      start = view.find_first_not_of(" \n", start);
+      if (start == std::string_view::npos)
+        break;
+      auto const end = view.find_first_of(" \n", start);
+      bench::keep(view.substr(start, end - start));
+      ++fields;
+      if (end == std::string_view::npos)
+        break;
+      start = end + 1;
+    }
+    bench::keep(fields);
+  });
+
+  // strtok writes into its input, so every run starts from a fresh copy
+  std::vector<char> scratch(log.size() + 1);
+  bench::measure_bytes("strtok/tokenize_fields", bytes, [&] {
+    memcpy(scratch.data(), log.c_str(), log.size() + 1);
+    usize fields = 0;
+    for (auto *field = strtok(scratch.data(), " \n"); field;
+         field = strtok(nullptr, " \n")) {
+      bench::keep(field);
+      ++fields;
+    }
+    bench::keep(fields);
+  });
+}
+
+auto main() -> int {
+  auto const log = make_log(20'000);
+
+  run_std(log);
+  bench::for_each_cpu_level([&](char const *level) { run(level, log); });
+  return 0;
+}
\ No newline at end of file
@@ -0,0 +1,89 @@
+#include "bench.h"
+
+#include "zinc/string_sort.h"
+
+#include <algorithm>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+using namespace zinc;
+
+// long shared prefixes, the case where comparison sorts redo the most work
+static auto make_urls(u64 count) -> std::vector<std::string> {
+  static char const *const hosts[] = {"https://api.example.com/",
+                                      "https://www.example.com/",
+                                      "https://cdn.example.net/"};
+  static char const *const paths[] = {"v1/users/", "v1/orders/",
+                                      "static/img/", "v2/search?q="};
+  auto random = bench::rng();
+  std::vector<std::string> keys;
+  for (u64 i = 0; i < count; ++i)
+    keys.push_back(std::string(hosts[random.below(3)]) +
+                   paths[random.below(4)] +
+                   std::to_string(random.below(1'000'000)));
+  return keys;
+}
+
+static auto make_random(u64 count) -> std::vector<std::string> {
+  auto random = bench::rng();
+  std::vector<std::string> keys;
+  for (u64 i = 0; i < count; ++i) {
+    std::string key(4 + random.below(28), ' ');
+    for (auto &c : key)
+      c = as<char>('a' + random.below(26));
+    keys.push_back(std::move(key));
+  }
+  return keys;
+}
+
+static auto run(char const *kind, std::vector<std::string> const &keys)
+    -> void {
+  std::vector<string_view> source;
+  for (auto const &key : keys)
+    source.push_back(string_view(key.data(), key.size()));
+  auto const threads = std::thread::hardware_concurrency()
+                           ? std::thread::hardware_concurrency()
+                           : 4;
+  std::vector<string_view> work;
+  char name[64];
+
+  snprintf(name, sizeof(name), "%s/std_sort", kind);
+  bench::measure(name, source.size(), [&] {
+    work = source;
+    std::sort(work.begin(), work.end(),
+              [](string_view const &a, string_view const &b) {
+                return std::string_view(a.data(), a.length()) <
+                       std::string_view(b.data(), b.length());
+              });
+  });
+
+  snprintf(name, sizeof(name), "%s/sort_strings", kind);
+  bench::measure(name, source.size(), [&] {
+    work = source;
+    sort_strings(work.data(), work.size());
+  });
+
+  snprintf(name, sizeof(name), "%s/sort_strings_x%u", kind, threads);
+  bench::measure(name, source.size(), [&] {
+    work = source;
+    sort_strings(work.data(), work.size(), threads);
+  });
+
+  std::vector<string> owned;
+  snprintf(name, sizeof(name), "%s/sort_strings_owned", kind);
+  bench::measure(name, source.size(), [&] {
+    owned.clear();
+    for (auto const &key : source)
+      owned.emplace_back(key);
+    sort_strings(owned.data(), owned.size());
+  });
+}
+
+auto main() -> int {
+  constexpr u64 count = 1'000'000;
+  run("urls", make_urls(count));
+  run("random", make_random(count));
+  return 0;
+}
\ No newline at end of file
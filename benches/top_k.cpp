@@ -0,0 +1,103 @@
+#include "bench.h"
+
+#include "zinc/algorithm.h"
+
+#include <algorithm>
+#include <vector>
+
+using namespace zinc;
+
+// the k best scores out of n, every way the library offers
+static auto run(std::vector<f32> const &scores, usize k) -> void {
+  auto const n = scores.size();
+  std::vector<f32> work;
+  char name[64];
+
+  snprintf(name, sizeof(name), "n=%zu/k=%zu/zinc_sort", n, k);
+  bench::measure(
+      name, n,
+      [&] {
+        work = scores;
+        sort(work.data(), work.size());
+        bench::keep(work[n - k]);
+      },
+      3);
+
+  snprintf(name, sizeof(name), "n=%zu/k=%zu/std_partial_sort", n, k);
+  bench::measure(
+      name, n,
+      [&] {
+        work = scores;
+        std::partial_sort(work.begin(), work.begin() + k, work.end(),
+                          std::greater<f32>());
+        bench::keep(work[k - 1]);
+      },
+      3);
+
+  snprintf(name, sizeof(name), "n=%zu/k=%zu/partial_sort", n, k);
+  bench::measure(
+      name, n,
+      [&] {
+        work = scores;
+        partial_sort(work.data(), work.data() + k, work.data() + n,
+                     std::greater<f32>());
+        bench::keep(work[k - 1]);
+      },
+      3);
+
+  snprintf(name, sizeof(name), "n=%zu/k=%zu/std_nth_element", n, k);
+  bench::measure(
+      name, n,
+      [&] {
+        work = scores;
+        std::nth_element(work.begin(), work.begin() + (k - 1), work.end(),
+                         std::greater<f32>());
+        bench::keep(work[k - 1]);
+      },
+      3);
+
+  snprintf(name, sizeof(name), "n=%zu/k=%zu/nth_element", n, k);
+  bench::measure(
+      name, n,
+      [&] {
+        work = scores;
+        nth_element(work.data(), work.data() + (k - 1), work.data() + n,
+                    std::greater<f32>());
+        bench::keep(work[k - 1]);
+      },
+      3);
+
+  // the streaming versions read the scores in place, no copy to sort
+  snprintf(name, sizeof(name), "n=%zu/k=%zu/top_k_one_by_one", n, k);
+  bench::measure(
+      name, n,
+      [&] {
+        top_k<f32, 1000> best(k);
+        for (auto score : scores)
+          best.push(score);
+        bench::keep(best.sorted()[0]);
+      },
+      3);
+
+  snprintf(name, sizeof(name), "n=%zu/k=%zu/top_k_filtered", n, k);
+  bench::measure(
+      name, n,
+      [&] {
+        top_k<f32, 1000> best(k);
+        best.push(scores.data(), scores.size());
+        bench::keep(best.sorted()[0]);
+      },
+      3);
+}
+
+auto main() -> int {
+  auto random = bench::rng();
+  for (usize n : {100'000, 1'000'000, 10'000'000}) {
+    std::vector<f32> scores(n);
+    for (auto &score : scores)
+      score = as<f32>(random.below(1 << 24)) / as<f32>(1 << 24);
+    for (usize k : {10, 100, 1000})
+      run(scores, k);
+  }
+  return 0;
+}
\ No newline at end of file
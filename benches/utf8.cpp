@@ -0,0 +1,120 @@
+#include "bench.h"
+
+#include "zinc/utf8.h"
+
+#include <string>
+#include <vector>
+
+using namespace zinc;
+
+static auto append_code_point(std::string &text, u32 value) -> void {
+  char buffer[4];
+  auto const length = utf32_to_utf8(reinterpret_cast<char32_t *>(&value), 1,
+                                    buffer);
+  text.append(buffer, length.value());
+}
+
+// about a megabyte of text where roughly one code point in `every` comes
+// from [low, high) and the rest are printable ASCII
+static auto make_text(u32 every, u32 low, u32 high) -> std::string {
+  auto random = bench::rng();
+  std::string text;
+  while (text.size() < (1 << 20)) {
+    if (every && random.below(every) == 0)
+      append_code_point(text, low + as<u32>(random.below(high - low)));
+    else
+      text.push_back(as<char>(' ' + random.below(95)));
+  }
+  return text;
+}
+
+// the usual byte at a time validator, what a codebase has before it has
+// a vectorised one
+static auto validate_bytewise(string_view const &text) -> bool {
+  auto const *bytes = reinterpret_cast<u8 const *>(text.data());
+  auto const length = text.length();
+  usize i = 0;
+  while (i < length) {
+    auto const lead = bytes[i];
+    usize size;
+    if (lead < 0x80)
+      size = 1;
+    else if (lead >= 0xC2 && lead < 0xE0)
+      size = 2;
+    else if (lead >= 0xE0 && lead < 0xF0)
+      size = 3;
+    else if (lead >= 0xF0 && lead < 0xF5)
+      size = 4;
+    else
+      return false;
+    if (i + size > length)
+      return false;
+    u32 value = lead & (0x7F >> size);
+    for (usize k = 1; k < size; ++k) {
+      if ((bytes[i + k] & 0xC0) != 0x80)
+        return false;
+      value = (value << 6) | (bytes[i + k] & 0x3F);
+    }
+    static constexpr u32 smallest[] = {0, 0, 0x80, 0x800, 0x10000};
+    if (value < smallest[size] || value > 0x10FFFF ||
+        (value >= 0xD800 && value < 0xE000))
+      return false;
+    i += size;
+  }
+  return true;
+}
+
+static auto run(char const *level, char const *kind, std::string const &text)
+    -> void {
+  auto const view = string_view(text.data(), text.size());
+  auto const bytes = as<u64>(text.size());
+  std::vector<char16_t> utf16(text.size());
+  std::vector<char> utf8(text.size() * 3);
+  auto const units = utf8_to_utf16(view, utf16.data()).value();
+  char name[64];
+
+  snprintf(name, sizeof(name), "%s/%s/validate", kind, level);
+  bench::measure_bytes(name, bytes, [&] { bench::keep(is_valid_utf8(view)); });
+
+  snprintf(name, sizeof(name), "%s/%s/count_code_points", kind, level);
+  bench::measure_bytes(name, bytes,
+                       [&] { bench::keep(count_code_points(view)); });
+
+  snprintf(name, sizeof(name), "%s/%s/utf8_to_utf16", kind, level);
+  bench::measure_bytes(name, bytes, [&] {
+    bench::keep(utf8_to_utf16(view, utf16.data()).value_or(0));
+  });
+
+  snprintf(name, sizeof(name), "%s/%s/utf16_to_utf8", kind, level);
+  bench::measure_bytes(name, bytes, [&] {
+    bench::keep(utf16_to_utf8(utf16.data(), units, utf8.data()).value_or(0));
+  });
+}
+
+auto main() -> int {
+  struct sample {
+    char const *kind;
+    std::string text;
+  };
+  sample const samples[] = {
+      {"ascii", make_text(0, 0, 0)},
+      {"latin", make_text(12, 0xA0, 0x180)},
+      {"cyrillic", make_text(2, 0x400, 0x460)},
+      {"cjk", make_text(1, 0x4E00, 0x9FA0)},
+      {"emoji", make_text(6, 0x1F600, 0x1F650)},
+  };
+
+  for (auto const &sample : samples) {
+    char name[64];
+    snprintf(name, sizeof(name), "%s/bytewise/validate", sample.kind);
+    auto const view = string_view(sample.text.data(), sample.text.size());
+    bench::measure_bytes(name, sample.text.size(),
+                         [&] { bench::keep(validate_bytewise(view)); });
+  }
+
+  bench::for_each_cpu_level([&](char const *level) {
+    for (auto const &sample : samples)
+      run(level, sample.kind, sample.text);
+  });
+  return 0;
+}
\ No newline at end of file
@@ -1,28 +1,961 @@
 #pragma once
 
 #include "base.h"
+#include "bits.h"
+#include "cpu.h"
+#include "simd.h"
+#include "static_vector.h"
 
 #include <algorithm>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
 
 namespace zinc {
-// TODO: Actually reimplement this
+namespace details {
+// Pattern-defeating quicksort, after Orson Peters' pdqsort. Quicksort with
+// ninther pivots that notices sorted and reversed runs, breaks up patterns
+// that make it go quadratic and falls back to heapsort if that keeps
+// happening.
+constexpr usize insertion_sort_threshold = 24;
+constexpr usize ninther_threshold = 128;
+constexpr usize partial_insertion_limit = 8;
+constexpr usize partition_block = 64;
+
+// The block partition decides where elements go without branching on the
+// comparison, which only pays off when comparing is cheap and predictable
+template <typename TValue, typename TCompare>
+struct is_branchless_compare
+    : std::integral_constant<
+          bool, std::is_arithmetic<TValue>::value &&
+                    (std::is_same<TCompare, std::less<TValue>>::value ||
+                     std::is_same<TCompare, std::greater<TValue>>::value ||
+                     std::is_same<TCompare, std::less<>>::value ||
+                     std::is_same<TCompare, std::greater<>>::value)> {};
+
+template <typename TValue, typename TCompare>
+inline auto insertion_sort(TValue *begin, TValue *end, TCompare &compare)
+    -> void {
+  if (begin == end)
+    return;
+  for (auto *current = begin + 1; current != end; ++current) {
+    auto *sift = current;
+    auto *previous = current - 1;
+    if (compare(*sift, *previous)) {
+      auto held = std::move(*sift);
+      do {
+        *sift-- = std::move(*previous);
+      } while (sift != begin && compare(held, *--previous));
+      *sift = std::move(held);
+    }
+  }
+}
+
+// the element before begin is no greater than any in the range, so it stops
+// the scan without a bounds check
+template <typename TValue, typename TCompare>
+inline auto unguarded_insertion_sort(TValue *begin, TValue *end,
+                                     TCompare &compare) -> void {
+  if (begin == end)
+    return;
+  for (auto *current = begin + 1; current != end; ++current) {
+    auto *sift = current;
+    auto *previous = current - 1;
+    if (compare(*sift, *previous)) {
+      auto held = std::move(*sift);
+      do {
+        *sift-- = std::move(*previous);
+      } while (compare(held, *--previous));
+      *sift = std::move(held);
+    }
+  }
+}
+
+// gives up, with the range left partly sorted, once it has moved more than
+// a few elements
+template <typename TValue, typename TCompare>
+inline auto partial_insertion_sort(TValue *begin, TValue *end,
+                                   TCompare &compare) -> bool {
+  if (begin == end)
+    return true;
+  usize moved = 0;
+  for (auto *current = begin + 1; current != end; ++current) {
+    if (moved > partial_insertion_limit)
+      return false;
+    auto *sift = current;
+    auto *previous = current - 1;
+    if (compare(*sift, *previous)) {
+      auto held = std::move(*sift);
+      do {
+        *sift-- = std::move(*previous);
+      } while (sift != begin && compare(held, *--previous));
+      *sift = std::move(held);
+      moved += as<usize>(current - sift);
+    }
+  }
+  return true;
+}
+
+template <typename TValue, typename TCompare>
+inline auto sort2(TValue *a, TValue *b, TCompare &compare) -> void {
+  if (compare(*b, *a))
+    std::iter_swap(a, b);
+}
+
+template <typename TValue, typename TCompare>
+inline auto sort3(TValue *a, TValue *b, TValue *c, TCompare &compare)
+    -> void {
+  sort2(a, b, compare);
+  sort2(b, c, compare);
+  sort2(a, b, compare);
+}
+
+template <typename TValue>
+inline auto swap_offsets(TValue *first, TValue *last, u8 const *left,
+                         u8 const *right, usize count, bool use_swaps)
+    -> void {
+  // a plain swap per pair keeps descending inputs linear
+  if (use_swaps) {
+    for (usize i = 0; i < count; ++i)
+      std::iter_swap(first + left[i], last - right[i]);
+  } else if (count > 0) {
+    auto *l = first + left[0];
+    auto *r = last - right[0];
+    auto held = std::move(*l);
+    *l = std::move(*r);
+    for (usize i = 1; i < count; ++i) {
+      l = first + left[i];
+      *r = std::move(*l);
+      r = last - right[i];
+      *l = std::move(*r);
+    }
+    *r = std::move(held);
+  }
+}
+
+// Partitions around *begin, equal elements go right. Returns where the
+// pivot ended up and whether the range was already partitioned.
+template <typename TValue, typename TCompare>
+inline auto partition_right(TValue *begin, TValue *end, TCompare &compare)
+    -> std::pair<TValue *, bool> {
+  auto pivot = std::move(*begin);
+  auto *first = begin;
+  auto *last = end;
+  while (compare(*++first, pivot))
+    ;
+  if (first - 1 == begin)
+    while (first < last && !compare(*--last, pivot))
+      ;
+  else
+    while (!compare(*--last, pivot))
+      ;
+
+  auto const already_partitioned = first >= last;
+  while (first < last) {
+    std::iter_swap(first, last);
+    while (compare(*++first, pivot))
+      ;
+    while (!compare(*--last, pivot))
+      ;
+  }
+
+  auto *pivot_position = first - 1;
+  *begin = std::move(*pivot_position);
+  *pivot_position = std::move(pivot);
+  return {pivot_position, already_partitioned};
+}
+
+// Same as partition_right, but first collects the offsets of misplaced
+// elements a block at a time and only then swaps them
+template <typename TValue, typename TCompare>
+inline auto partition_right_branchless(TValue *begin, TValue *end,
+                                       TCompare &compare)
+    -> std::pair<TValue *, bool> {
+  auto pivot = std::move(*begin);
+  auto *first = begin;
+  auto *last = end;
+  while (compare(*++first, pivot))
+    ;
+  if (first - 1 == begin)
+    while (first < last && !compare(*--last, pivot))
+      ;
+  else
+    while (!compare(*--last, pivot))
+      ;
+
+  auto const already_partitioned = first >= last;
+  if (!already_partitioned) {
+    std::iter_swap(first, last);
+    ++first;
+
+    alignas(64) u8 left_offsets[partition_block];
+    alignas(64) u8 right_offsets[partition_block];
+    auto *left_base = first;
+    auto *right_base = last;
+    usize left_count = 0, right_count = 0;
+    usize left_start = 0, right_start = 0;
+
+    while (first < last) {
+      auto const unknown = as<usize>(last - first);
+      auto const left_split =
+          left_count == 0 ? (right_count == 0 ? unknown / 2 : unknown) : 0;
+      auto const right_split = right_count == 0 ? unknown - left_split : 0;
+
+      auto const left_take =
+          left_split < partition_block ? left_split : partition_block;
+      for (usize i = 0; i < left_take; ++i) {
+        left_offsets[left_count] = as<u8>(i);
+        left_count += !compare(*first, pivot);
+        ++first;
+      }
+      auto const right_take =
+          right_split < partition_block ? right_split : partition_block;
+      for (usize i = 0; i < right_take;) {
+        right_offsets[right_count] = as<u8>(++i);
+        right_count += compare(*--last, pivot);
+      }
+
+      auto const count = left_count < right_count ? left_count : right_count;
+      swap_offsets(left_base, right_base, left_offsets + left_start,
+                   right_offsets + right_start, count,
+                   left_count == right_count);
+      left_count -= count;
+      right_count -= count;
+      left_start += count;
+      right_start += count;
+      if (left_count == 0) {
+        left_start = 0;
+        left_base = first;
+      }
+      if (right_count == 0) {
+        right_start = 0;
+        right_base = last;
+      }
+    }
+
+    // one side may still hold misplaced elements, they go next to the
+    // boundary
+    if (left_count) {
+      auto const *offsets = left_offsets + left_start;
+      while (left_count--)
+        std::iter_swap(left_base + offsets[left_count], --last);
+      first = last;
+    }
+    if (right_count) {
+      auto const *offsets = right_offsets + right_start;
+      while (right_count--)
+        std::iter_swap(right_base - offsets[right_count], first), ++first;
+      last = first;
+    }
+  }
+
+  auto *pivot_position = first - 1;
+  *begin = std::move(*pivot_position);
+  *pivot_position = std::move(pivot);
+  return {pivot_position, already_partitioned};
+}
+
+// Partitions around *begin with equal elements going left. Used when the
+// pivot equals the element before the range, everything equal to it is
+// then in its final place.
+template <typename TValue, typename TCompare>
+inline auto partition_left(TValue *begin, TValue *end, TCompare &compare)
+    -> TValue * {
+  auto pivot = std::move(*begin);
+  auto *first = begin;
+  auto *last = end;
+  while (compare(pivot, *--last))
+    ;
+  if (last + 1 == end)
+    while (first < last && !compare(pivot, *++first))
+      ;
+  else
+    while (!compare(pivot, *++first))
+      ;
+
+  while (first < last) {
+    std::iter_swap(first, last);
+    while (compare(pivot, *--last))
+      ;
+    while (!compare(pivot, *++first))
+      ;
+  }
+
+  auto *pivot_position = last;
+  *begin = std::move(*pivot_position);
+  *pivot_position = std::move(pivot);
+  return pivot_position;
+}
+
+template <bool branchless, typename TValue, typename TCompare>
+inline auto pdqsort_loop(TValue *begin, TValue *end, TCompare &compare,
+                         u32 bad_allowed, bool leftmost) -> void {
+  for (;;) {
+    auto const size = as<usize>(end - begin);
+    if (size < insertion_sort_threshold) {
+      if (leftmost)
+        insertion_sort(begin, end, compare);
+      else
+        unguarded_insertion_sort(begin, end, compare);
+      return;
+    }
+
+    auto const half = size / 2;
+    if (size > ninther_threshold) {
+      sort3(begin, begin + half, end - 1, compare);
+      sort3(begin + 1, begin + (half - 1), end - 2, compare);
+      sort3(begin + 2, begin + (half + 1), end - 3, compare);
+      sort3(begin + (half - 1), begin + half, begin + (half + 1), compare);
+      std::iter_swap(begin, begin + half);
+    } else {
+      sort3(begin + half, begin, end - 1, compare);
+    }
+
+    // a pivot equal to the element before the range means a run of equal
+    // elements, put them all in place at once
+    if (!leftmost && !compare(*(begin - 1), *begin)) {
+      begin = partition_left(begin, end, compare) + 1;
+      continue;
+    }
+
+    auto const partitioned =
+        branchless ? partition_right_branchless(begin, end, compare)
+                   : partition_right(begin, end, compare);
+    auto *pivot_position = partitioned.first;
+    auto const left_size = as<usize>(pivot_position - begin);
+    auto const right_size = as<usize>(end - (pivot_position + 1));
+
+    if (left_size < size / 8 || right_size < size / 8) {
+      if (--bad_allowed == 0) {
+        std::make_heap(begin, end, compare);
+        std::sort_heap(begin, end, compare);
+        return;
+      }
+      // shuffle a few elements around to break up whatever pattern chose
+      // the bad pivot
+      if (left_size >= insertion_sort_threshold) {
+        std::iter_swap(begin, begin + left_size / 4);
+        std::iter_swap(pivot_position - 1, pivot_position - left_size / 4);
+        if (left_size > ninther_threshold) {
+          std::iter_swap(begin + 1, begin + (left_size / 4 + 1));
+          std::iter_swap(begin + 2, begin + (left_size / 4 + 2));
+          std::iter_swap(pivot_position - 2,
+                         pivot_position - (left_size / 4 + 1));
+          std::iter_swap(pivot_position - 3,
+                         pivot_position - (left_size / 4 + 2));
+        }
+      }
+      if (right_size >= insertion_sort_threshold) {
+        std::iter_swap(pivot_position + 1,
+                       pivot_position + (1 + right_size / 4));
+        std::iter_swap(end - 1, end - right_size / 4);
+        if (right_size > ninther_threshold) {
+          std::iter_swap(pivot_position + 2,
+                         pivot_position + (2 + right_size / 4));
+          std::iter_swap(pivot_position + 3,
+                         pivot_position + (3 + right_size / 4));
+          std::iter_swap(end - 2, end - (1 + right_size / 4));
+          std::iter_swap(end - 3, end - (2 + right_size / 4));
+        }
+      }
+    } else if (partitioned.second &&
+               partial_insertion_sort(begin, pivot_position, compare) &&
+               partial_insertion_sort(pivot_position + 1, end, compare)) {
+      // it looked sorted and it was
+      return;
+    }
+
+    pdqsort_loop<branchless>(begin, pivot_position, compare, bad_allowed,
+                             leftmost);
+    begin = pivot_position + 1;
+    leftmost = false;
+  }
+}
+
+template <typename TValue, typename TCompare>
+inline auto pdqsort(TValue *begin, TValue *end, TCompare &compare) -> void {
+  if (end - begin < 2)
+    return;
+  auto const size = as<u64>(end - begin);
+  pdqsort_loop<is_branchless_compare<TValue, TCompare>::value>(
+      begin, end, compare, 64 - count_leading_zeros(size), true);
+}
+
+// Gathers the least stop - begin elements into [begin, stop) as a max
+// heap. Anything not below the top is rejected with one comparison, so it
+// is cheap when the heap is small next to the range.
+template <typename TValue, typename TCompare>
+inline auto select_into_heap(TValue *begin, TValue *stop, TValue *end,
+                             TCompare &compare) -> void {
+  std::make_heap(begin, stop, compare);
+  for (auto *current = stop; current < end; ++current) {
+    if (compare(*current, *begin)) {
+      std::pop_heap(begin, stop, compare);
+      std::iter_swap(stop - 1, current);
+      std::push_heap(begin, stop, compare);
+    }
+  }
+}
+
+// Puts the element that belongs at nth there with nothing greater before
+// it and nothing less after it. O(n log n) however the input looks.
+template <typename TValue, typename TCompare>
+inline auto heap_select(TValue *begin, TValue *nth, TValue *end,
+                        TCompare &compare) -> void {
+  select_into_heap(begin, nth + 1, end, compare);
+  std::pop_heap(begin, nth + 1, compare);
+}
+
+// Introselect: quickselect with the pivots and partitions of pdqsort,
+// only ever following the side nth is on. Linear on average, and when the
+// pivots keep coming out bad it hands over to heap_select.
+template <typename TValue, typename TCompare>
+inline auto introselect(TValue *begin, TValue *nth, TValue *end,
+                        TCompare &compare) -> void {
+  constexpr bool branchless = is_branchless_compare<TValue, TCompare>::value;
+  if (end - begin < 2)
+    return;
+  u32 bad_allowed = 64 - count_leading_zeros(as<u64>(end - begin));
+  auto leftmost = true;
+  for (;;) {
+    auto const size = as<usize>(end - begin);
+    if (size < insertion_sort_threshold) {
+      if (leftmost)
+        insertion_sort(begin, end, compare);
+      else
+        unguarded_insertion_sort(begin, end, compare);
+      return;
+    }
+
+    auto const half = size / 2;
+    if (size > ninther_threshold) {
+      sort3(begin, begin + half, end - 1, compare);
+      sort3(begin + 1, begin + (half - 1), end - 2, compare);
+      sort3(begin + 2, begin + (half + 1), end - 3, compare);
+      sort3(begin + (half - 1), begin + half, begin + (half + 1), compare);
+      std::iter_swap(begin, begin + half);
+    } else {
+      sort3(begin + half, begin, end - 1, compare);
+    }
+
+    // the run equal to the element before the range is already in place
+    if (!leftmost && !compare(*(begin - 1), *begin)) {
+      auto *const equal_end = partition_left(begin, end, compare) + 1;
+      if (nth < equal_end)
+        return;
+      begin = equal_end;
+      continue;
+    }
+
+    auto *const pivot_position =
+        (branchless ? partition_right_branchless(begin, end, compare)
+                    : partition_right(begin, end, compare))
+            .first;
+    if (pivot_position == nth)
+      return;
+
+    auto const left_size = as<usize>(pivot_position - begin);
+    auto const right_size = as<usize>(end - (pivot_position + 1));
+    if ((left_size < size / 8 || right_size < size / 8) &&
+        --bad_allowed == 0) {
+      heap_select(begin, nth, end, compare);
+      return;
+    }
+
+    if (nth < pivot_position) {
+      end = pivot_position;
+    } else {
+      begin = pivot_position + 1;
+      leftmost = false;
+    }
+  }
+}
+
+// Radix keys: unsigned integers that order the same way as the original
+// keys. Signed integers flip the sign bit, floats flip every bit when
+// negative and only the sign bit otherwise. -0.0 sorts before 0.0 and NaNs
+// go to the ends by their sign.
+template <typename TKey>
+inline auto radix_key(TKey key)
+    -> std::enable_if_t<std::is_integral<TKey>::value,
+                        std::make_unsigned_t<TKey>> {
+  using unsigned_key = std::make_unsigned_t<TKey>;
+  if constexpr (std::is_signed<TKey>::value)
+    return as<unsigned_key>(as<unsigned_key>(key) ^
+                            (unsigned_key(1) << (sizeof(TKey) * 8 - 1)));
+  else
+    return key;
+}
+
+inline auto radix_key(f32 key) -> u32 {
+  u32 bits;
+  memcpy(&bits, &key, sizeof(bits));
+  return bits >> 31 ? ~bits : bits | 0x80000000u;
+}
+
+inline auto radix_key(f64 key) -> u64 {
+  u64 bits;
+  memcpy(&bits, &key, sizeof(bits));
+  return bits >> 63 ? ~bits : bits | 0x8000000000000000ull;
+}
+
+template <typename TKey, typename = void>
+struct is_radix_key : std::false_type {};
+template <typename TKey>
+struct is_radix_key<
+    TKey, std::enable_if_t<(std::is_integral<TKey>::value &&
+                            !std::is_same<TKey, bool>::value) ||
+                           std::is_same<TKey, f32>::value ||
+                           std::is_same<TKey, f64>::value>> : std::true_type {
+};
+
+// Orders keys by their radix keys, so comparison sorts agree with the radix
+// sort on floats, where operator< is false for every NaN.
+struct radix_less {
+  template <typename TKey> auto operator()(TKey a, TKey b) const -> bool {
+    return radix_key(a) < radix_key(b);
+  }
+};
+
+template <typename TValue>
+struct is_branchless_compare<TValue, radix_less>
+    : std::is_arithmetic<TValue> {};
+
+// below this pdqsort is faster than the fixed passes of a radix sort
+constexpr usize radix_sort_threshold = 1024;
+
+// Stable LSD radix sort, one byte per pass. All histograms come from a
+// single read of the keys and passes where every key has the same byte are
+// skipped, so narrow values in wide types cost fewer passes.
+template <typename TValue, typename TKeyOf>
+inline auto radix_sort(TValue *begin, usize count, TKeyOf &key_of,
+                       TValue *buffer) -> void {
+  using key_type = decltype(radix_key(key_of(*begin)));
+  constexpr usize passes = sizeof(key_type);
+
+  usize counts[passes][256] = {};
+  for (usize i = 0; i < count; ++i) {
+    auto const key = radix_key(key_of(begin[i]));
+    for (usize pass = 0; pass < passes; ++pass)
+      ++counts[pass][(key >> (pass * 8)) & 0xFF];
+  }
+
+  auto *from = begin;
+  auto *to = buffer;
+  auto const first_key = radix_key(key_of(*begin));
+  for (usize pass = 0; pass < passes; ++pass) {
+    auto *histogram = counts[pass];
+    if (histogram[(first_key >> (pass * 8)) & 0xFF] == count)
+      continue;
+    usize start = 0;
+    for (usize digit = 0; digit < 256; ++digit) {
+      auto const size = histogram[digit];
+      histogram[digit] = start;
+      start += size;
+    }
+    for (usize i = 0; i < count; ++i) {
+      auto const digit = (radix_key(key_of(from[i])) >> (pass * 8)) & 0xFF;
+      to[histogram[digit]++] = from[i];
+    }
+    std::swap(from, to);
+  }
+  if (from != begin)
+    memcpy(static_cast<void *>(begin), from, count * sizeof(TValue));
+}
+
+// Past this many bytes every LSD pass scatters over more memory than the
+// caches hold, so large inputs are first split on their top byte and the
+// buckets, which fit, are finished one at a time.
+constexpr usize radix_split_bytes = 1 << 21;
+
+// Stable like the LSD passes. Sorting a bucket inside the buffer and
+// copying it back costs less than a pass over the whole array would.
+template <typename TValue, typename TKeyOf>
+inline auto radix_split(TValue *begin, usize count, TKeyOf &key_of,
+                        TValue *buffer) -> void {
+  using key_type = decltype(radix_key(key_of(*begin)));
+  constexpr usize shift = (sizeof(key_type) - 1) * 8;
+
+  usize starts[257] = {};
+  for (usize i = 0; i < count; ++i)
+    ++starts[(radix_key(key_of(begin[i])) >> shift) + 1];
+  for (usize digit = 0; digit < 256; ++digit)
+    starts[digit + 1] += starts[digit];
+  usize next[256];
+  memcpy(next, starts, sizeof(next));
+  for (usize i = 0; i < count; ++i)
+    buffer[next[radix_key(key_of(begin[i])) >> shift]++] = begin[i];
+
+  for (usize digit = 0; digit < 256; ++digit) {
+    auto const size = starts[digit + 1] - starts[digit];
+    auto *bucket = buffer + starts[digit];
+    if (size > 1)
+      radix_sort(bucket, size, key_of, begin + starts[digit]);
+    memcpy(static_cast<void *>(begin + starts[digit]), bucket,
+           size * sizeof(TValue));
+  }
+}
+
+template <typename TValue, typename TKeyOf>
+inline auto radix_sort(TValue *begin, usize count, TKeyOf &key_of) -> void {
+  using key_type = decltype(radix_key(key_of(*begin)));
+  auto *buffer = static_cast<TValue *>(::operator new(count * sizeof(TValue)));
+  if (sizeof(key_type) > 1 && count * sizeof(TValue) > radix_split_bytes)
+    radix_split(begin, count, key_of, buffer);
+  else
+    radix_sort(begin, count, key_of, buffer);
+  ::operator delete(buffer);
+}
+
+// Finishes inputs that are already ascending or descending, which the
+// fixed passes of the radix sort would not notice. Both scans stop at the
+// first element out of line, so other inputs pay for a few comparisons.
+// Reversing a descending run with equal keys in it would reorder them, so
+// stable callers only take strictly descending ones.
+template <typename TValue, typename TKeyOf>
+inline auto finish_presorted(TValue *begin, usize count, TKeyOf &key_of,
+                             bool stable) -> bool {
+  auto const less = [&key_of](TValue const &a, TValue const &b) {
+    return radix_less()(key_of(a), key_of(b));
+  };
+  usize i = 1;
+  while (i < count && !less(begin[i], begin[i - 1]))
+    ++i;
+  if (i == count)
+    return true;
+  if (i > 1)
+    return false;
+  if (stable)
+    while (i < count && less(begin[i], begin[i - 1]))
+      ++i;
+  else
+    while (i < count && !less(begin[i - 1], begin[i]))
+      ++i;
+  if (i != count)
+    return false;
+  std::reverse(begin, begin + count);
+  return true;
+}
+
+struct identity_key {
+  template <typename TValue>
+  auto operator()(TValue const &value) const -> TValue const & {
+    return value;
+  }
+};
+} // namespace details
+
+// Sorts in place, not stable. The comparison must be a strict weak order.
 template <typename TValue, typename TCompare>
 inline auto sort(TValue *begin, TValue *end, TCompare compare) -> void {
-  std::sort(begin, end, compare);
+  details::pdqsort(begin, end, compare);
 }
 
 template <typename TValue, typename TCompare>
 inline auto sort(TValue *begin, usize count, TCompare compare) -> void {
-  std::sort(begin, begin + count, compare);
+  details::pdqsort(begin, begin + count, compare);
 }
 
-template <typename TValue, typename TCompare>
+// Ascending order. Large arrays of integers and floats take the radix sort.
+// Floats are ordered like radix_key orders them at every size, so NaNs go
+// to the ends and -0.0 sorts before 0.0.
+template <typename TValue>
 inline auto sort(TValue *begin, TValue *end) -> void {
-  std::sort(begin, end);
+  auto const count = as<usize>(end - begin);
+  if constexpr (details::is_radix_key<TValue>::value) {
+    if (count >= details::radix_sort_threshold) {
+      details::identity_key key_of;
+      if (!details::finish_presorted(begin, count, key_of, false))
+        details::radix_sort(begin, count, key_of);
+      return;
+    }
+  }
+  if constexpr (std::is_floating_point<TValue>::value) {
+    details::radix_less compare;
+    details::pdqsort(begin, end, compare);
+  } else {
+    std::less<TValue> compare;
+    details::pdqsort(begin, end, compare);
+  }
 }
 
-template <typename TValue, typename TCompare>
+template <typename TValue>
 inline auto sort(TValue *begin, usize count) -> void {
-  std::sort(begin, begin + count);
+  sort(begin, begin + count);
+}
+
+// Ascending by key_of(value). Integer and float keys of trivially copyable
+// values are sorted stably, in radix_key order, by the radix sort or below
+// its threshold by a merge sort. Anything else is compared with operator<
+// and is not stable.
+template <typename TValue, typename TKeyOf>
+inline auto sort_by_key(TValue *begin, TValue *end, TKeyOf key_of) -> void {
+  using key_type = std::decay_t<decltype(key_of(*begin))>;
+  auto const count = as<usize>(end - begin);
+  if constexpr (details::is_radix_key<key_type>::value &&
+                std::is_trivially_copyable<TValue>::value) {
+    if (count >= details::radix_sort_threshold) {
+      if (!details::finish_presorted(begin, count, key_of, true))
+        details::radix_sort(begin, count, key_of);
+    } else {
+      std::stable_sort(begin, end, [&key_of](TValue const &a,
+                                             TValue const &b) {
+        return details::radix_less()(key_of(a), key_of(b));
+      });
+    }
+    return;
+  }
+  auto compare = [&key_of](TValue const &a, TValue const &b) {
+    return key_of(a) < key_of(b);
+  };
+  details::pdqsort(begin, end, compare);
+}
+
+template <typename TValue, typename TKeyOf>
+inline auto sort_by_key(TValue *begin, usize count, TKeyOf key_of) -> void {
+  sort_by_key(begin, begin + count, key_of);
+}
+
+// Reorders so the element at nth is the one a sort would put there, with
+// none greater before it and none less after it. Not stable.
+template <typename TValue, typename TCompare>
+inline auto nth_element(TValue *begin, TValue *nth, TValue *end,
+                        TCompare compare) -> void {
+  if (nth < end)
+    details::introselect(begin, nth, end, compare);
 }
+
+template <typename TValue>
+inline auto nth_element(TValue *begin, TValue *nth, TValue *end) -> void {
+  nth_element(begin, nth, end, std::less<TValue>());
+}
+
+// Sorts the least middle - begin elements into [begin, middle), the rest
+// are left after them in no particular order. A few out of many are
+// gathered in a heap, which turns most elements away after one comparison,
+// otherwise introselect picks them and only they are sorted.
+template <typename TValue, typename TCompare>
+inline auto partial_sort(TValue *begin, TValue *middle, TValue *end,
+                         TCompare compare) -> void {
+  if (middle == begin)
+    return;
+  if (as<usize>(middle - begin) <= as<usize>(end - begin) / 256) {
+    details::select_into_heap(begin, middle, end, compare);
+    std::sort_heap(begin, middle, compare);
+    return;
+  }
+  if (middle == end) {
+    details::pdqsort(begin, end, compare);
+    return;
+  }
+  details::introselect(begin, middle - 1, end, compare);
+  details::pdqsort(begin, middle - 1, compare);
+}
+
+template <typename TValue>
+inline auto partial_sort(TValue *begin, TValue *middle, TValue *end)
+    -> void {
+  partial_sort(begin, middle, end, std::less<TValue>());
+}
+
+namespace details {
+// Halves the range with a conditional move instead of a branch, so there
+// is no misprediction per level to wait out. Both places the next probe
+// can land are prefetched, which overlaps the cache miss of the next level
+// with the comparison of this one.
+template <typename TValue, typename TKey, typename TCompare>
+inline auto branchless_lower_bound(TValue const *items, usize count,
+                                   TKey const &key, TCompare &compare)
+    -> usize {
+  if (count == 0)
+    return 0;
+  auto const *base = items;
+  while (count > 1) {
+    auto const half = count / 2;
+    auto const next = (count - half) / 2;
+    prefetch(base + next);
+    prefetch(base + half + next);
+    base = compare(base[half], key) ? base + half : base;
+    count -= half;
+  }
+  return as<usize>(base - items) + compare(*base, key);
+}
+
+template <typename TValue, typename TKey, typename TCompare>
+inline auto branchless_upper_bound(TValue const *items, usize count,
+                                   TKey const &key, TCompare &compare)
+    -> usize {
+  if (count == 0)
+    return 0;
+  auto const *base = items;
+  while (count > 1) {
+    auto const half = count / 2;
+    auto const next = (count - half) / 2;
+    prefetch(base + next);
+    prefetch(base + half + next);
+    base = !compare(key, base[half]) ? base + half : base;
+    count -= half;
+  }
+  return as<usize>(base - items) + !compare(key, *base);
+}
+} // namespace details
+
+// Index of the first element of sorted items not less than key, or
+// items.size() when there is none
+template <typename TValue, typename TKey, typename TCompare>
+inline auto lower_bound(array_view<TValue> items, TKey const &key,
+                        TCompare compare) -> usize {
+  return details::branchless_lower_bound(items.data(), items.size(), key,
+                                         compare);
+}
+
+template <typename TValue>
+inline auto lower_bound(array_view<TValue> items,
+                        typename array_view<TValue>::value_type const &key)
+    -> usize {
+  std::less<TValue> compare;
+  return details::branchless_lower_bound(items.data(), items.size(), key,
+                                         compare);
+}
+
+// Index of the first element of sorted items greater than key, or
+// items.size() when there is none
+template <typename TValue, typename TKey, typename TCompare>
+inline auto upper_bound(array_view<TValue> items, TKey const &key,
+                        TCompare compare) -> usize {
+  return details::branchless_upper_bound(items.data(), items.size(), key,
+                                         compare);
+}
+
+template <typename TValue>
+inline auto upper_bound(array_view<TValue> items,
+                        typename array_view<TValue>::value_type const &key)
+    -> usize {
+  std::less<TValue> compare;
+  return details::branchless_upper_bound(items.data(), items.size(), key,
+                                         compare);
+}
+
+namespace details {
+// Candidates that cannot beat the threshold are skipped a vector at a time
+// when the order is the plain < or > of an arithmetic type
+template <typename TValue, typename TCompare>
+constexpr bool filters_with_simd =
+    simd::details::is_lane_type<TValue> &&
+    (std::is_same<TCompare, std::less<TValue>>::value ||
+     std::is_same<TCompare, std::greater<TValue>>::value);
+} // namespace details
+
+// Streaming selection: keeps the k greatest values pushed so far under
+// compare, or with std::greater the k least. They sit in a heap with the
+// weakest of them on top, which is the bar a new value has to clear once
+// k are held. Equal values do not displace each other, the first ones in
+// stay.
+template <typename TValue, usize TCapacity,
+          typename TCompare = std::less<TValue>>
+class top_k {
+public:
+  explicit top_k(usize k = TCapacity, TCompare compare = TCompare())
+      : m_k(k), m_compare(compare) {
+    ZINC_ASSERTF(k <= TCapacity, "top_k: k is larger than the capacity");
+  }
+
+  void push(TValue const &value) {
+    if (m_values.size() < m_k) {
+      m_values.push_back(value);
+      sift_up(m_values.size() - 1);
+    } else if (m_k && m_compare(m_values[0], value)) {
+      replace_top(value);
+    }
+  }
+
+  // Offers every value in turn. Once k are held, plain arithmetic orders
+  // scan ahead with zinc::simd for the next value above the threshold, so
+  // most candidates are never looked at one by one.
+  void push(TValue const *values, usize count) {
+    usize i = 0;
+    while (i < count && m_values.size() < m_k)
+      push(values[i++]);
+    if (m_k == 0)
+      return;
+    if constexpr (details::filters_with_simd<TValue, TCompare>) {
+      while (i < count) {
+        auto const rest = array_view<TValue>(values + i, count - i);
+        auto const next =
+            std::is_same<TCompare, std::less<TValue>>::value
+                ? simd::find_if(rest, simd::greater_than(m_values[0]))
+                : simd::find_if(rest, simd::less_than(m_values[0]));
+        if (next == simd::npos)
+          return;
+        i += next;
+        replace_top(values[i++]);
+      }
+    } else {
+      for (; i < count; ++i)
+        push(values[i]);
+    }
+  }
+
+  // the weakest value held, which anything new has to beat once full()
+  [[nodiscard]] auto threshold() const -> TValue const & {
+    ZINC_ASSERTF(!m_values.empty(), "top_k::threshold: empty");
+    return m_values[0];
+  }
+
+  [[nodiscard]] auto full() const -> bool { return m_values.size() == m_k; }
+  [[nodiscard]] auto size() const -> usize { return m_values.size(); }
+  [[nodiscard]] auto empty() const -> bool { return m_values.empty(); }
+
+  // in heap order
+  [[nodiscard]] auto values() const -> array_view<TValue> {
+    return array_view<TValue>(m_values.data(), m_values.size());
+  }
+
+  // Sorts the held values ascending under compare, best last. An ascending
+  // array is still a valid heap, so pushing can carry on afterwards.
+  auto sorted() -> array_view<TValue> {
+    details::pdqsort(m_values.begin(), m_values.end(), m_compare);
+    return values();
+  }
+
+  void clear() { m_values.clear(); }
+
+private:
+  void sift_up(usize index) {
+    auto *const heap = m_values.data();
+    auto value = std::move(heap[index]);
+    while (index > 0) {
+      auto const parent = (index - 1) / 2;
+      if (!m_compare(value, heap[parent]))
+        break;
+      heap[index] = std::move(heap[parent]);
+      index = parent;
+    }
+    heap[index] = std::move(value);
+  }
+
+  void replace_top(TValue const &value) {
+    auto *const heap = m_values.data();
+    auto const size = m_values.size();
+    usize index = 0;
+    for (;;) {
+      auto child = 2 * index + 1;
+      if (child >= size)
+        break;
+      if (child + 1 < size && m_compare(heap[child + 1], heap[child]))
+        ++child;
+      if (!m_compare(heap[child], value))
+        break;
+      heap[index] = std::move(heap[child]);
+      index = child;
+    }
+    heap[index] = value;
+  }
+
+  static_vector<TValue, TCapacity> m_values;
+  usize m_k;
+  TCompare m_compare;
+};
 } // namespace zinc
\ No newline at end of file
@@ -15,6 +15,7 @@ struct pool {
 
   auto allocate() -> vptr;
   void deallocate(vptr block);
+  void deallocate(vptr const *blocks, usize count);
 
   template <typename TValue> auto construct() -> TValue * {
     ZINC_ASSERT(sizeof(TValue) <= m_granularity);
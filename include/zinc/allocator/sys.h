@@ -28,7 +28,9 @@ public:
   [[nodiscard]] auto allocate(usize size, const vptr = nullptr) -> TValue * {
     return static_cast<TValue *>(::operator new(size * sizeof(TValue)));
   }
-  void deallocate(TValue *ptr, usize size) noexcept { ::delete (ptr); }
+  void deallocate(TValue *ptr, usize /*size*/) noexcept {
+    ::operator delete(ptr);
+  }
 
   // We have to use a template, as we can't specialize a function in C++17
   template <typename TProxy = TValue,
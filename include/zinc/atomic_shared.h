@@ -0,0 +1,246 @@
+#pragma once
+
+#include "zinc/base.h"
+#include "zinc/debug.h"
+#include "zinc/shared.h"
+
+// Borrows are packed into the top 16 bits of the node pointer, which needs
+// every heap address to leave them clear. Android on arm64 tags heap
+// pointers in the top byte, so there the slot holds a plain pointer that
+// readers guard with a hazard pointer instead. Set this to 0 to do the same
+// elsewhere, such as where the kernel hands out 57-bit addresses.
+#ifndef ZINC_CONFIG_ATOMIC_SHARED_PACKED
+#if ZINC_PLATFORM_ANDROID && ZINC_CPU_ARM && ZINC_ARCH_64BIT
+#define ZINC_CONFIG_ATOMIC_SHARED_PACKED 0
+#else
+#define ZINC_CONFIG_ATOMIC_SHARED_PACKED 1
+#endif
+#endif
+
+#if !ZINC_CONFIG_ATOMIC_SHARED_PACKED
+#include "zinc/mt/hazard.h"
+#endif
+
+namespace zinc {
+// A shared handle that can be loaded and replaced from many threads without
+// a lock, using split reference counting. The slot points at a small node
+// holding the current shared value, with a count of borrowed references
+// packed into the unused high bits of the pointer. Readers borrow with a
+// single fetch_add, copy the value and hand the borrow back; a writer that
+// swaps the node out transfers outstanding borrows onto the node's own
+// count so it stays alive until the last reader is done with it.
+template <typename T, typename D = void (*)(T *),
+          typename TCount = atomic_count>
+struct atomic_shared : public zinc::non_copyable {
+public:
+  using value_type = shared<T, D, TCount>;
+
+#if ZINC_CONFIG_ATOMIC_SHARED_PACKED
+  static constexpr bool is_always_lock_free =
+      std::atomic<u64>::is_always_lock_free;
+
+  atomic_shared() = default;
+  explicit atomic_shared(value_type desired)
+      : m_packed(pack(make_node(std::move(desired)), 0)) {}
+  ~atomic_shared() {
+    auto const packed = m_packed.load(std::memory_order_acquire);
+    ZINC_ASSERT(borrows_of(packed) == 0);
+    release_node(node_of(packed));
+  }
+
+  [[nodiscard]] auto load() const -> value_type {
+    auto packed = m_packed.fetch_add(borrow, std::memory_order_acquire);
+    ZINC_ASSERTF(borrows_of(packed) + 1 < max_borrows,
+                 "too many concurrent atomic_shared readers");
+    auto *current = node_of(packed);
+    auto value = current ? current->m_value : value_type();
+    give_back(current, packed + borrow);
+    return value;
+  }
+
+  void store(value_type desired) { exchange(std::move(desired)); }
+
+  auto exchange(value_type desired) -> value_type {
+    auto *fresh = make_node(std::move(desired));
+    auto const packed =
+        m_packed.exchange(pack(fresh, 0), std::memory_order_acq_rel);
+    return take(node_of(packed), borrows_of(packed));
+  }
+
+  // succeeds if the slot shares ownership with and points at the same
+  // object as expected, otherwise expected is updated to the current value
+  auto compare_exchange(value_type &expected, value_type desired) -> bool {
+    auto packed = m_packed.fetch_add(borrow, std::memory_order_acquire) +
+                  borrow;
+    auto *current = node_of(packed);
+    if (!matches(current, expected)) {
+      expected = current ? current->m_value : value_type();
+      give_back(current, packed);
+      return false;
+    }
+
+    auto *fresh = make_node(std::move(desired));
+    while (!m_packed.compare_exchange_weak(packed, pack(fresh, 0),
+                                           std::memory_order_acq_rel,
+                                           std::memory_order_acquire)) {
+      if (node_of(packed) == current)
+        continue;
+      // someone else replaced the value in the meantime, start over
+      if (fresh) {
+        desired = std::move(fresh->m_value);
+        delete fresh;
+      }
+      release_node(current);
+      return compare_exchange(expected, std::move(desired));
+    }
+    // our own borrow stays with us and is dropped together with the slot's
+    // reference
+    take(current, borrows_of(packed) - 1);
+    return true;
+  }
+
+#else
+  static constexpr bool is_always_lock_free =
+      std::atomic<vptr>::is_always_lock_free;
+
+  atomic_shared() = default;
+  explicit atomic_shared(value_type desired)
+      : m_node(make_node(std::move(desired))) {}
+  ~atomic_shared() { delete m_node.load(std::memory_order_acquire); }
+
+  [[nodiscard]] auto load() const -> value_type {
+    hazard_pointer guard;
+    auto *current = guard.protect(m_node);
+    return current ? current->m_value : value_type();
+  }
+
+  void store(value_type desired) { exchange(std::move(desired)); }
+
+  auto exchange(value_type desired) -> value_type {
+    auto *fresh = make_node(std::move(desired));
+    return take(m_node.exchange(fresh, std::memory_order_acq_rel));
+  }
+
+  // succeeds if the slot shares ownership with and points at the same
+  // object as expected, otherwise expected is updated to the current value
+  auto compare_exchange(value_type &expected, value_type desired) -> bool {
+    hazard_pointer guard;
+    auto *current = guard.protect(m_node);
+    node *fresh = nullptr;
+    while (matches(current, expected)) {
+      if (!fresh)
+        fresh = make_node(std::move(desired));
+      // the guard keeps current from being freed and reused, so a match
+      // is the node that was checked
+      if (m_node.compare_exchange_strong(current, fresh,
+                                         std::memory_order_acq_rel,
+                                         std::memory_order_acquire)) {
+        take(current);
+        return true;
+      }
+      current = guard.protect(m_node);
+    }
+    expected = current ? current->m_value : value_type();
+    delete fresh;
+    return false;
+  }
+
+#endif
+  auto operator=(value_type desired) -> atomic_shared & {
+    store(std::move(desired));
+    return *this;
+  }
+  operator value_type() const { return load(); }
+
+private:
+  struct node {
+    explicit node(value_type &&value) : m_value(std::move(value)) {}
+
+#if ZINC_CONFIG_ATOMIC_SHARED_PACKED
+    std::atomic<usize> m_refs{1};
+#endif
+    value_type m_value;
+  };
+
+  static auto make_node(value_type &&value) -> node * {
+    return value ? new node(std::move(value)) : nullptr;
+  }
+
+  static auto matches(node const *current, value_type const &expected)
+      -> bool {
+    if (!current)
+      return !expected;
+    return current->m_value.m_handle == expected.m_handle &&
+           current->m_value.m_count == expected.m_count;
+  }
+
+#if ZINC_CONFIG_ATOMIC_SHARED_PACKED
+  static constexpr u32 pointer_bits = ZINC_ARCH_64BIT ? 48 : 32;
+  static constexpr u64 pointer_mask = (u64(1) << pointer_bits) - 1;
+  static constexpr u64 borrow = u64(1) << pointer_bits;
+  static constexpr u64 max_borrows = u64(1) << (64 - pointer_bits);
+
+  // checked in release builds too, the bits cut off a wider address would
+  // otherwise be lost and the node freed at the wrong address
+  static auto pack(node *pointer, u64 borrows) -> u64 {
+    auto const address = as<u64>(reinterpret_cast<uptr>(pointer));
+    if ((address & ~pointer_mask) != 0)
+      address_too_wide();
+    return address | (borrows << pointer_bits);
+  }
+  [[noreturn]] static void address_too_wide() {
+    DebugMessage(__FILE__, __LINE__,
+                 "atomic_shared node address uses its top 16 bits, build "
+                 "with ZINC_CONFIG_ATOMIC_SHARED_PACKED set to 0");
+    std::abort();
+  }
+  static auto node_of(u64 packed) -> node * {
+    return reinterpret_cast<node *>(as<uptr>(packed & pointer_mask));
+  }
+  static auto borrows_of(u64 packed) -> u64 { return packed >> pointer_bits; }
+
+  static auto release_node(node *current) -> void {
+    if (current && current->m_refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+      delete current;
+  }
+
+  // returns a borrow taken with load, if the node has been swapped out in
+  // the meantime the writer moved the borrow onto the node's count
+  auto give_back(node *current, u64 packed) const -> void {
+    while (node_of(packed) == current) {
+      if (m_packed.compare_exchange_weak(packed, packed - borrow,
+                                         std::memory_order_release,
+                                         std::memory_order_relaxed))
+        return;
+    }
+    release_node(current);
+  }
+
+  // called by the writer that unlinked current, takes over the slot's
+  // reference and any borrows still outstanding
+  static auto take(node *current, u64 borrows) -> value_type {
+    if (!current)
+      return value_type();
+    if (borrows)
+      current->m_refs.fetch_add(borrows, std::memory_order_relaxed);
+    auto value = current->m_value;
+    release_node(current);
+    return value;
+  }
+
+  mutable std::atomic<u64> m_packed{0};
+#else
+  // called by the writer that unlinked current, the node is freed once no
+  // reader's hazard pointer names it
+  static auto take(node *current) -> value_type {
+    if (!current)
+      return value_type();
+    auto value = current->m_value;
+    hazard_domain::global().retire(current);
+    return value;
+  }
+
+  std::atomic<node *> m_node{nullptr};
+#endif
+};
+} // namespace zinc
\ No newline at end of file
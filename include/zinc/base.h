@@ -46,6 +46,35 @@ struct non_copyable {
   auto operator=(const non_copyable &) -> non_copyable & = delete;
 };
 
+// Whether a TValue can be moved to new memory by copying its bytes and
+// forgetting the old ones, without running its move constructor or its
+// destructor. Containers use it to move elements with memcpy. Types that
+// own memory through plain pointers are, even though their moves are not
+// trivial; specialise this for them.
+template <typename TValue>
+struct is_trivially_relocatable : std::is_trivially_copyable<TValue> {};
+
+template <typename TValue>
+inline constexpr bool is_trivially_relocatable_v =
+    is_trivially_relocatable<TValue>::value;
+
+// A niche is a value of TValue that option<TValue> can use to mean None,
+// so it needs no flag next to the value. Specialisations set available
+// and provide none(), which makes that value, and is_none(value). The
+// niche can never be held by a full option, so only give types one whose
+// niche is not a value anybody means to keep, such as a null pointer.
+template <typename TValue> struct niche_traits {
+  static constexpr bool available = false;
+};
+
+template <typename TValue> struct niche_traits<TValue *> {
+  static constexpr bool available = true;
+  static constexpr auto none() noexcept -> TValue * { return nullptr; }
+  static constexpr auto is_none(TValue *value) noexcept -> bool {
+    return value == nullptr;
+  }
+};
+
 // checked_delete
 template <class TValue> inline void checked_delete(TValue *x) noexcept {
   // intentionally complex - simplification causes regressions
@@ -0,0 +1,118 @@
+#pragma once
+
+#include "base.h"
+
+#if ZINC_COMPILER_MSVC && !ZINC_COMPILER_CLANG_CL
+#include <intrin.h>
+#endif
+
+namespace zinc {
+// value must not be zero for the zero counting functions
+[[nodiscard]] inline auto count_trailing_zeros(u32 value) -> u32 {
+#if ZINC_COMPILER_MSVC && !ZINC_COMPILER_CLANG_CL
+  unsigned long index;
+  _BitScanForward(&index, value);
+  return as<u32>(index);
+#else
+  return as<u32>(__builtin_ctz(value));
+#endif
+}
+
+[[nodiscard]] inline auto count_trailing_zeros(u64 value) -> u32 {
+#if ZINC_COMPILER_MSVC && !ZINC_COMPILER_CLANG_CL && ZINC_ARCH_64BIT
+  unsigned long index;
+  _BitScanForward64(&index, value);
+  return as<u32>(index);
+#elif ZINC_COMPILER_MSVC && !ZINC_COMPILER_CLANG_CL
+  auto const low = as<u32>(value);
+  return low ? count_trailing_zeros(low)
+             : 32 + count_trailing_zeros(as<u32>(value >> 32));
+#else
+  return as<u32>(__builtin_ctzll(value));
+#endif
+}
+
+[[nodiscard]] inline auto count_leading_zeros(u32 value) -> u32 {
+#if ZINC_COMPILER_MSVC && !ZINC_COMPILER_CLANG_CL
+  unsigned long index;
+  _BitScanReverse(&index, value);
+  return 31 - as<u32>(index);
+#else
+  return as<u32>(__builtin_clz(value));
+#endif
+}
+
+[[nodiscard]] inline auto count_leading_zeros(u64 value) -> u32 {
+#if ZINC_COMPILER_MSVC && !ZINC_COMPILER_CLANG_CL && ZINC_ARCH_64BIT
+  unsigned long index;
+  _BitScanReverse64(&index, value);
+  return 63 - as<u32>(index);
+#elif ZINC_COMPILER_MSVC && !ZINC_COMPILER_CLANG_CL
+  auto const high = as<u32>(value >> 32);
+  return high ? count_leading_zeros(high)
+              : 32 + count_leading_zeros(as<u32>(value));
+#else
+  return as<u32>(__builtin_clzll(value));
+#endif
+}
+
+[[nodiscard]] inline auto popcount(u32 value) -> u32 {
+#if ZINC_COMPILER_MSVC && !ZINC_COMPILER_CLANG_CL
+  value = value - ((value >> 1) & 0x55555555);
+  value = (value & 0x33333333) + ((value >> 2) & 0x33333333);
+  return (((value + (value >> 4)) & 0x0f0f0f0f) * 0x01010101) >> 24;
+#else
+  return as<u32>(__builtin_popcount(value));
+#endif
+}
+
+[[nodiscard]] inline auto popcount(u64 value) -> u32 {
+#if ZINC_COMPILER_MSVC && !ZINC_COMPILER_CLANG_CL
+  return popcount(as<u32>(value)) + popcount(as<u32>(value >> 32));
+#else
+  return as<u32>(__builtin_popcountll(value));
+#endif
+}
+[[nodiscard]] inline auto byte_swap(u32 value) -> u32 {
+#if ZINC_COMPILER_MSVC && !ZINC_COMPILER_CLANG_CL
+  return _byteswap_ulong(value);
+#else
+  return __builtin_bswap32(value);
+#endif
+}
+
+[[nodiscard]] inline auto byte_swap(u64 value) -> u64 {
+#if ZINC_COMPILER_MSVC && !ZINC_COMPILER_CLANG_CL
+  return _byteswap_uint64(value);
+#else
+  return __builtin_bswap64(value);
+#endif
+}
+
+struct u128 {
+  u64 low;
+  u64 high;
+};
+
+// full 128 bit product of two 64 bit values
+[[nodiscard]] inline auto wide_multiply(u64 a, u64 b) -> u128 {
+#if defined(__SIZEOF_INT128__)
+  auto const product = as<unsigned __int128>(a) * b;
+  return {as<u64>(product), as<u64>(product >> 64)};
+#elif ZINC_COMPILER_MSVC && !ZINC_COMPILER_CLANG_CL && ZINC_ARCH_64BIT &&      \
+    ZINC_CPU_X86
+  u64 high;
+  auto const low = _umul128(a, b, &high);
+  return {low, high};
+#else
+  auto const a_low = a & 0xFFFFFFFF, a_high = a >> 32;
+  auto const b_low = b & 0xFFFFFFFF, b_high = b >> 32;
+  auto const low_low = a_low * b_low;
+  auto const high_low = a_high * b_low;
+  auto const low_high = a_low * b_high;
+  auto const middle = (low_low >> 32) + (high_low & 0xFFFFFFFF) + low_high;
+  return {(middle << 32) | (low_low & 0xFFFFFFFF),
+          a_high * b_high + (high_low >> 32) + (middle >> 32)};
+#endif
+}
+} // namespace zinc
\ No newline at end of file
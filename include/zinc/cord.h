@@ -0,0 +1,126 @@
+#pragma once
+
+#include "base.h"
+#include "shared.h"
+#include "string.h"
+
+namespace zinc {
+namespace details {
+// A reference counted block of bytes. The used part grows towards both ends,
+// a cord that holds the only reference extends it in place instead of
+// starting a new buffer.
+struct cord_buffer {
+  atomic_count m_refs;
+  usize m_capacity;
+  usize m_begin;
+  usize m_end;
+
+  auto bytes() -> char * { return reinterpret_cast<char *>(this + 1); }
+};
+
+struct cord_piece {
+  cord_buffer *m_buffer;
+  usize m_offset;
+  usize m_length;
+};
+} // namespace details
+
+// A string made of pieces of shared buffers. Appending or prepending never
+// moves bytes that are already in the cord, copies and substrings share the
+// buffers instead of copying them, and the contents can be walked chunk by
+// chunk, ready for a scatter write, without ever flattening them.
+struct cord {
+public:
+  using size_type = usize;
+
+  static constexpr size_type npos = ~size_type(0);
+
+  struct chunk_iterator {
+    cord const *m_cord;
+    size_type m_index;
+
+    auto operator*() const -> string_view { return m_cord->chunk(m_index); }
+    auto operator++() -> chunk_iterator & {
+      ++m_index;
+      return *this;
+    }
+    auto operator==(chunk_iterator const &other) const -> bool {
+      return m_index == other.m_index;
+    }
+    auto operator!=(chunk_iterator const &other) const -> bool {
+      return m_index != other.m_index;
+    }
+  };
+
+  struct chunk_range {
+    cord const *m_cord;
+
+    [[nodiscard]] auto begin() const -> chunk_iterator { return {m_cord, 0}; }
+    [[nodiscard]] auto end() const -> chunk_iterator {
+      return {m_cord, m_cord->chunk_count()};
+    }
+  };
+
+  cord() = default;
+  explicit cord(string_view const &text) { append(text); }
+  cord(cord const &other);
+  cord(cord &&other) noexcept;
+  ~cord();
+
+  auto operator=(cord const &other) -> cord &;
+  auto operator=(cord &&other) noexcept -> cord &;
+
+  [[nodiscard]] auto length() const -> size_type { return m_length; }
+  [[nodiscard]] auto empty() const -> bool { return m_length == 0; }
+  [[nodiscard]] auto chunk_count() const -> size_type { return m_count; }
+  [[nodiscard]] auto chunk(size_type index) const -> string_view {
+    ZINC_ASSERT(index < m_count);
+    auto const &found = piece(index);
+    return {found.m_buffer->bytes() + found.m_offset, found.m_length};
+  }
+  [[nodiscard]] auto chunks() const -> chunk_range { return {this}; }
+
+  void clear();
+
+  void append(string_view const &text);
+  void append(cord const &other);
+  void prepend(string_view const &text);
+  void prepend(cord const &other);
+
+  // shares the buffers, only the piece list is new
+  [[nodiscard]] auto substr(size_type pos, size_type count = npos) const
+      -> cord;
+
+  // writes every byte to out, which must hold length() of them
+  auto copy_to(char *out) const -> size_type;
+
+  template <typename TAllocator = sys_allocator<char>>
+  [[nodiscard]] auto flatten(TAllocator const &allocator = TAllocator()) const
+      -> basic_string<char, TAllocator> {
+    basic_string<char, TAllocator> result(m_length, allocator);
+    copy_to(result.data());
+    return result;
+  }
+
+private:
+  using piece_type = details::cord_piece;
+
+  auto piece(size_type index) -> piece_type & {
+    return m_pieces[(m_head + index) & (m_capacity - 1)];
+  }
+  auto piece(size_type index) const -> piece_type const & {
+    return m_pieces[(m_head + index) & (m_capacity - 1)];
+  }
+
+  void reserve_pieces(size_type count);
+  void push_back(piece_type const &value);
+  void push_front(piece_type const &value);
+  auto new_buffer(size_type needed) const -> details::cord_buffer *;
+
+  piece_type *m_pieces{nullptr};
+  size_type m_head{0};
+  size_type m_count{0};
+  size_type m_capacity{0};
+  size_type m_length{0};
+};
+} // namespace zinc
\ No newline at end of file
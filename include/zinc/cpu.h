@@ -0,0 +1,60 @@
+#pragma once
+
+#include "base.h"
+
+// marks a function that may use instructions beyond the baseline the
+// translation unit is compiled for, only call it after checking cpu()
+#if ZINC_COMPILER_GCC || ZINC_COMPILER_CLANG
+#define ZINC_TARGET(features) __attribute__((target(features)))
+#else
+#define ZINC_TARGET(features)
+#endif
+
+// inlines everything the function calls, for kernels built out of many
+// small lane functions that should end up as one loop
+#if ZINC_COMPILER_GCC || ZINC_COMPILER_CLANG
+#define ZINC_FLATTEN __attribute__((flatten))
+#else
+#define ZINC_FLATTEN
+#endif
+
+#if ZINC_COMPILER_MSVC && !ZINC_COMPILER_CLANG_CL && ZINC_CPU_X86
+#include <xmmintrin.h>
+#endif
+
+namespace zinc {
+// Instruction set extensions the running processor and operating system
+// support. Kernels with wider variants check these at call time, so one
+// binary runs everywhere and still uses what the machine has.
+struct cpu_features {
+  bool sse2{false};
+  bool ssse3{false};
+  bool sse41{false};
+  bool sse42{false};
+  bool popcnt{false};
+  bool avx2{false};
+  bool bmi2{false};
+  bool avx512f{false};
+  bool avx512bw{false};
+  bool neon{false};
+};
+
+[[nodiscard]] auto cpu() -> cpu_features const &;
+
+// turns off every feature not set in allowed, for comparing kernels in tests
+// and benchmarks. not thread safe, call it before anything is dispatched
+void restrict_cpu_features(cpu_features const &allowed);
+
+// starts loading the cache line holding address, for loops that know
+// where they will read a few iterations before they get there. never
+// faults, so it is fine to point past the end of an array.
+inline void prefetch(void const *address) {
+#if ZINC_COMPILER_GCC || ZINC_COMPILER_CLANG
+  __builtin_prefetch(address);
+#elif ZINC_COMPILER_MSVC && ZINC_CPU_X86
+  _mm_prefetch(static_cast<char const *>(address), _MM_HINT_T0);
+#else
+  (void)address;
+#endif
+}
+} // namespace zinc
\ No newline at end of file
@@ -5,7 +5,10 @@
 namespace zinc {
 using AssertCallback = void(char const *, char const *, u32);
 
-void DebugMessage(char const *sourcefile, u32 line, char const *fmt...);
+// Hands text to the assert handler as it is, it is never read as a format
+// string. ZINC_ASSERTF(ok, ZINC_FMT("..."), args...) formats its message
+// first, through the overload in format.h.
+void DebugMessage(char const *sourcefile, u32 line, char const *text);
 void SetAssertCallback(AssertCallback *callback);
 } // namespace zinc
 
@@ -42,4 +45,4 @@ void SetAssertCallback(AssertCallback *callback);
 #define ZINC_ASSERTF(_e, ...)
 #endif
 
-#define zinc_unreachable() ZINC_ASSERT(0, "unreachable code");
\ No newline at end of file
+#define zinc_unreachable() ZINC_ASSERTF(0, "unreachable code");
\ No newline at end of file
@@ -0,0 +1,389 @@
+#pragma once
+
+#include "base.h"
+#include "number.h"
+#include "string.h"
+#include "time.h"
+
+#include <cstring>
+
+// Wraps a string literal so format can parse it at compile time, mistakes in
+// the pattern are build errors:
+//
+//   zinc::format(out, ZINC_FMT("{:>8} took {}\n"), name, elapsed);
+#define ZINC_FMT(text)                                                         \
+  [] {                                                                         \
+    struct pattern : ::zinc::format_pattern {                                  \
+      static constexpr auto data() -> char const * { return text; }            \
+      static constexpr auto size() -> ::usize {                                \
+        return sizeof(text) - 1;                                               \
+      }                                                                        \
+    };                                                                         \
+    return pattern{};                                                          \
+  }()
+
+namespace zinc {
+// base of the types ZINC_FMT makes
+struct format_pattern {};
+
+// what follows the colon in a {:...} field, [[fill]align][0][width]
+// [.precision][type]
+struct format_spec {
+  char fill = ' ';
+  char align = 0;
+  bool zero_pad = false;
+  u32 width = 0;
+  i32 precision = -1;
+  char type = 0;
+};
+
+// Specialise this to format your own types, write gets the field's spec and
+// a sink to call append(char const *, usize) on:
+//
+//   template <> struct zinc::formatter<point> {
+//     template <typename TSink>
+//     static void write(TSink &sink, point const &p, format_spec const &) {
+//       zinc::format(sink, ZINC_FMT("({}, {})"), p.x, p.y);
+//     }
+//   };
+template <typename TValue, typename = void> struct formatter;
+
+// Sink over a caller's buffer. Output past the end is dropped but still
+// counted, so length() says how much room the whole text needed.
+struct format_buffer {
+  format_buffer(char *data, usize capacity)
+      : m_data(data), m_capacity(capacity) {}
+
+  auto append(char const *text, usize length) -> void {
+    if (m_length < m_capacity) {
+      auto const room = m_capacity - m_length;
+      memcpy(m_data + m_length, text, length < room ? length : room);
+    }
+    m_length += length;
+  }
+
+  [[nodiscard]] auto length() const -> usize { return m_length; }
+  [[nodiscard]] auto truncated() const -> bool {
+    return m_length > m_capacity;
+  }
+
+private:
+  char *m_data;
+  usize m_capacity;
+  usize m_length = 0;
+};
+
+namespace details {
+// not constexpr, so reaching it while compiling a pattern stops the build
+// with the message in the diagnostic
+inline void format_error(char const *) {}
+
+constexpr u32 literal_piece = ~u32(0);
+
+struct format_piece {
+  u32 offset = 0;
+  u32 length = 0;
+  u32 field = literal_piece;
+  format_spec spec{};
+};
+
+constexpr auto is_format_align(char c) -> bool {
+  return c == '<' || c == '>' || c == '^';
+}
+
+constexpr auto parse_format_spec(char const *text, usize size, usize i,
+                                 format_spec &spec) -> usize {
+  if (i + 1 < size && is_format_align(text[i + 1])) {
+    if (text[i] == '{' || text[i] == '}')
+      format_error("braces can't be used as fill");
+    spec.fill = text[i];
+    spec.align = text[i + 1];
+    i += 2;
+  } else if (i < size && is_format_align(text[i])) {
+    spec.align = text[i++];
+  }
+
+  if (i < size && text[i] == '0') {
+    spec.zero_pad = spec.align == 0;
+    ++i;
+  }
+  for (; i < size && text[i] >= '0' && text[i] <= '9'; ++i)
+    spec.width = spec.width * 10 + as<u32>(text[i] - '0');
+
+  if (i < size && text[i] == '.') {
+    if (++i == size || text[i] < '0' || text[i] > '9')
+      format_error("expected digits after . in a format spec");
+    spec.precision = 0;
+    for (; i < size && text[i] >= '0' && text[i] <= '9'; ++i)
+      spec.precision = spec.precision * 10 + (text[i] - '0');
+  }
+
+  if (i < size && text[i] != '}')
+    spec.type = text[i++];
+  return i;
+}
+
+// Splits the pattern into literal runs and fields, and only counts them
+// when out is null. {{ and }} end a literal run on their first brace.
+constexpr auto parse_format(char const *text, usize size, format_piece *out)
+    -> usize {
+  usize count = 0;
+  u32 fields = 0;
+  usize start = 0;
+  auto literal = [&](usize end) {
+    if (end > start) {
+      if (out)
+        out[count] = {as<u32>(start), as<u32>(end - start), literal_piece, {}};
+      ++count;
+    }
+  };
+
+  usize i = 0;
+  while (i < size) {
+    auto const c = text[i];
+    if (c != '{' && c != '}') {
+      ++i;
+      continue;
+    }
+    if (i + 1 < size && text[i + 1] == c) {
+      literal(i + 1);
+      start = i += 2;
+      continue;
+    }
+    if (c == '}')
+      format_error("unmatched } in format string");
+
+    literal(i);
+    format_spec spec{};
+    if (++i < size && text[i] == ':')
+      i = parse_format_spec(text, size, i + 1, spec);
+    if (i >= size || text[i] != '}')
+      format_error("expected } to close the field");
+    if (out)
+      out[count] = {0, 0, fields, spec};
+    ++count;
+    ++fields;
+    start = ++i;
+  }
+  literal(size);
+  return count;
+}
+
+template <usize N> struct format_program {
+  format_piece pieces[N > 0 ? N : 1]{};
+  usize fields = 0;
+};
+
+template <typename TPattern> struct compiled_format {
+  static constexpr usize size =
+      parse_format(TPattern::data(), TPattern::size(), nullptr);
+
+  static constexpr auto program = [] {
+    format_program<size> result{};
+    parse_format(TPattern::data(), TPattern::size(), result.pieces);
+    for (usize i = 0; i < size; ++i)
+      result.fields += result.pieces[i].field != literal_piece;
+    return result;
+  }();
+};
+
+template <typename TValue>
+constexpr bool is_format_int = std::is_integral_v<TValue> &&
+                               !std::is_same_v<TValue, bool> &&
+                               !std::is_same_v<TValue, char>;
+
+template <typename TValue>
+constexpr bool is_format_text =
+    std::is_convertible_v<TValue const &, string_view> &&
+    !std::is_same_v<TValue, std::nullptr_t>;
+
+// rejects specs that mean nothing for the argument's type
+template <typename TValue>
+constexpr auto format_spec_fits(format_spec const &spec) -> bool {
+  if constexpr (is_format_int<TValue>)
+    return spec.precision < 0 &&
+           (spec.type == 0 || spec.type == 'd' || spec.type == 'x' ||
+            spec.type == 'X' || spec.type == 'b' || spec.type == 'o');
+  else if constexpr (std::is_floating_point_v<TValue>)
+    return spec.precision <= 64 &&
+           (spec.type == 0 || spec.type == 'f' || spec.type == 'e');
+  else if constexpr (std::is_same_v<TValue, bool> ||
+                     std::is_same_v<TValue, char> ||
+                     (std::is_pointer_v<TValue> && !is_format_text<TValue>))
+    return spec.precision < 0 && spec.type == 0;
+  else if constexpr (is_format_text<TValue>)
+    return spec.type == 0 || spec.type == 's';
+  else if constexpr (std::is_same_v<TValue, duration>)
+    return spec.precision <= 9 && spec.type == 0;
+  else
+    return true;
+}
+
+// the bodies of the builtin conversions, none of them look at a locale
+auto format_radix(char *out, u64 magnitude, bool negative, char type)
+    -> usize;
+auto format_float_fixed(char *out, f64 value, char type, i32 precision)
+    -> usize;
+auto format_duration(char *out, duration const &value, i32 precision)
+    -> usize;
+
+template <typename TSink>
+void write_fill(TSink &sink, char fill, usize count) {
+  char run[16];
+  memset(run, fill, sizeof(run));
+  while (count > 0) {
+    auto const step = count < sizeof(run) ? count : sizeof(run);
+    sink.append(run, step);
+    count -= step;
+  }
+}
+
+template <typename TSink>
+void write_padded(TSink &sink, char const *text, usize length,
+                  format_spec const &spec, char align) {
+  if (spec.width <= length) {
+    sink.append(text, length);
+    return;
+  }
+
+  auto const padding = spec.width - length;
+  if (spec.zero_pad) {
+    // zeros go between the sign and the digits
+    auto const sign = length > 0 && text[0] == '-' ? 1 : 0;
+    sink.append(text, sign);
+    write_fill(sink, '0', padding);
+    sink.append(text + sign, length - sign);
+    return;
+  }
+
+  align = spec.align ? spec.align : align;
+  auto const before =
+      align == '>' ? padding : align == '^' ? padding / 2 : usize(0);
+  write_fill(sink, spec.fill, before);
+  sink.append(text, length);
+  write_fill(sink, spec.fill, padding - before);
+}
+
+template <typename TSink, typename TValue>
+void write_field(TSink &sink, TValue const &value, format_spec const &spec) {
+  if constexpr (is_format_int<TValue>) {
+    char buffer[72];
+    usize length;
+    if (spec.type == 0 || spec.type == 'd')
+      length = format_int(buffer, value);
+    else if constexpr (std::is_signed_v<TValue>)
+      length = format_radix(buffer, value < 0 ? 0 - as<u64>(value) : value,
+                            value < 0, spec.type);
+    else
+      length = format_radix(buffer, value, false, spec.type);
+    write_padded(sink, buffer, length, spec, '>');
+  } else if constexpr (std::is_floating_point_v<TValue>) {
+    char buffer[384];
+    auto const length =
+        spec.type == 0 && spec.precision < 0
+            ? format_float(buffer, value)
+            : format_float_fixed(buffer, value, spec.type, spec.precision);
+    write_padded(sink, buffer, length, spec, '>');
+  } else if constexpr (std::is_same_v<TValue, bool>) {
+    write_padded(sink, value ? "true" : "false", value ? 4 : 5, spec, '<');
+  } else if constexpr (std::is_same_v<TValue, char>) {
+    write_padded(sink, &value, 1, spec, '<');
+  } else if constexpr (is_format_text<TValue>) {
+    string_view const text = value;
+    auto length = text.length();
+    if (spec.precision >= 0 && as<usize>(spec.precision) < length)
+      length = as<usize>(spec.precision);
+    write_padded(sink, text.data(), length, spec, '<');
+  } else if constexpr (std::is_pointer_v<TValue>) {
+    char buffer[72];
+    auto const length =
+        format_radix(buffer, as<uptr>(value), false, 'p');
+    write_padded(sink, buffer, length, spec, '>');
+  } else if constexpr (std::is_same_v<TValue, duration>) {
+    char buffer[48];
+    auto const length = format_duration(buffer, value, spec.precision);
+    write_padded(sink, buffer, length, spec, '>');
+  } else {
+    formatter<TValue>::write(sink, value, spec);
+  }
+}
+
+template <usize I, typename TFirst, typename... TRest>
+constexpr auto nth_argument(TFirst const &first, TRest const &...rest)
+    -> decltype(auto) {
+  if constexpr (I == 0)
+    return first;
+  else
+    return nth_argument<I - 1>(rest...);
+}
+
+template <typename TPattern, usize I, typename TSink, typename... TArgs>
+void write_piece(TSink &sink, TArgs const &...args) {
+  constexpr auto const &piece = compiled_format<TPattern>::program.pieces[I];
+  if constexpr (piece.field == literal_piece) {
+    sink.append(TPattern::data() + piece.offset, piece.length);
+  } else {
+    auto const &value = nth_argument<piece.field>(args...);
+    using value_type = std::decay_t<decltype(value)>;
+    static_assert(format_spec_fits<value_type>(piece.spec),
+                  "format spec doesn't apply to the argument's type");
+    write_field(sink, value, piece.spec);
+  }
+}
+
+template <typename TPattern, typename TSink, typename... TArgs, usize... Is>
+void write_pieces(TSink &sink, std::index_sequence<Is...>,
+                  TArgs const &...args) {
+  (write_piece<TPattern, Is>(sink, args...), ...);
+}
+} // namespace details
+
+// Appends the pattern to anything with append(char const *, usize), a
+// basic_string, a format_buffer or an arena backed builder. The pattern is
+// parsed while compiling; at runtime each literal run and field is one
+// straight line call.
+template <typename TSink, typename TPattern, typename... TArgs,
+          typename = std::enable_if_t<
+              std::is_base_of_v<format_pattern, TPattern>>>
+void format(TSink &sink, TPattern, TArgs const &...args) {
+  using compiled = details::compiled_format<TPattern>;
+  static_assert(compiled::program.fields == sizeof...(TArgs),
+                "format string and argument count don't match");
+  details::write_pieces<TPattern>(
+      sink, std::make_index_sequence<compiled::size>(), args...);
+}
+
+// Like snprintf, always terminates when there's room and returns the length
+// the whole text needed.
+template <typename TPattern, typename... TArgs,
+          typename = std::enable_if_t<
+              std::is_base_of_v<format_pattern, TPattern>>>
+auto format_to(char *out, usize capacity, TPattern pattern,
+               TArgs const &...args) -> usize {
+  auto sink = format_buffer(out, capacity > 0 ? capacity - 1 : 0);
+  format(sink, pattern, args...);
+  if (capacity > 0)
+    out[sink.truncated() ? capacity - 1 : sink.length()] = '\0';
+  return sink.length();
+}
+
+template <usize N, typename TPattern, typename... TArgs,
+          typename = std::enable_if_t<
+              std::is_base_of_v<format_pattern, TPattern>>>
+auto format_to(char (&out)[N], TPattern pattern, TArgs const &...args)
+    -> usize {
+  return format_to(out, N, pattern, args...);
+}
+
+// ZINC_ASSERTF(ok, ZINC_FMT("..."), args...) lands here, a message longer
+// than the buffer is cut short.
+template <typename TPattern, typename... TArgs,
+          typename = std::enable_if_t<
+              std::is_base_of_v<format_pattern, TPattern>>>
+void DebugMessage(char const *sourcefile, u32 line, TPattern pattern,
+                  TArgs const &...args) {
+  char text[512];
+  format_to(text, pattern, args...);
+  DebugMessage(sourcefile, line, static_cast<char const *>(text));
+}
+} // namespace zinc
\ No newline at end of file
@@ -2,53 +2,188 @@
 
 #include "base.h"
 
+#include <new>
+#include <type_traits>
+#include <utility>
+
 namespace zinc {
-template <typename> struct func;
-template <typename Return, typename... Args> struct func<Return(Args...)> {
+namespace details {
+template <typename TReturn, typename TCallable, typename... TArgs>
+inline auto invoke_as(TCallable &callable, TArgs &&...args) -> TReturn {
+  if constexpr (std::is_void<TReturn>::value)
+    callable(std::forward<TArgs>(args)...);
+  else
+    return callable(std::forward<TArgs>(args)...);
+}
+} // namespace details
+
+// An owning, move-only callable. Callables of up to TInline bytes that can
+// be moved without throwing are kept inside the func itself, so captureless
+// lambdas and ones capturing a few pointers never allocate; bigger ones go
+// on the heap. Callables that can only be moved are fine.
+template <typename, usize TInline = 3 * sizeof(void *)> struct func;
+template <typename Return, typename... Args, usize TInline>
+struct func<Return(Args...), TInline> {
 private:
-  struct base_wrapper {
-    Return (*thunk)(base_wrapper *wrapper, Args... args) = nullptr;
+  // what a func needs to know about the callable it holds
+  struct operations {
+    Return (*invoke)(void *storage, Args &&...args);
+    // constructs the callable at to from the one at from and destroys that
+    void (*relocate)(void *from, void *to) noexcept;
+    void (*destroy)(void *storage) noexcept;
   };
 
-  template <typename TCallable> struct _wrapper : base_wrapper {
-    std::decay_t<TCallable> callable;
+  template <typename TCallable>
+  static constexpr bool stored_inline =
+      sizeof(TCallable) <= TInline && alignof(TCallable) <= alignof(void *) &&
+      std::is_nothrow_move_constructible<TCallable>::value;
 
-    static auto thunk(base_wrapper *wrapper, Args... args) -> Return {
-      return static_cast<_wrapper *>(wrapper)->callable(
-          std::forward<Args>(args)...);
+  template <typename TCallable> struct inline_operations {
+    static auto get(void *storage) -> TCallable & {
+      return *std::launder(static_cast<TCallable *>(storage));
+    }
+    static auto invoke(void *storage, Args &&...args) -> Return {
+      return details::invoke_as<Return>(get(storage),
+                                        std::forward<Args>(args)...);
     }
-    template <typename I>
-    inline _wrapper(I &&callable)
-        : base_wrapper{&thunk}, callable{std::forward<I>(callable)} {}
+    static void relocate(void *from, void *to) noexcept {
+      new (to) TCallable(std::move(get(from)));
+      get(from).~TCallable();
+    }
+    static void destroy(void *storage) noexcept { get(storage).~TCallable(); }
+
+    static constexpr operations table = {&invoke, &relocate, &destroy};
   };
 
-  base_wrapper *wrapper = nullptr;
+  // the storage holds a pointer to the callable
+  template <typename TCallable> struct heap_operations {
+    static auto get(void *storage) -> TCallable & {
+      return **static_cast<TCallable **>(storage);
+    }
+    static auto invoke(void *storage, Args &&...args) -> Return {
+      return details::invoke_as<Return>(get(storage),
+                                        std::forward<Args>(args)...);
+    }
+    static void relocate(void *from, void *to) noexcept {
+      new (to) TCallable *(*static_cast<TCallable **>(from));
+    }
+    static void destroy(void *storage) noexcept { delete &get(storage); }
+
+    static constexpr operations table = {&invoke, &relocate, &destroy};
+  };
+
+  operations const *m_operations = nullptr;
+  alignas(void *) mutable unsigned char m_storage[TInline < sizeof(void *)
+                                                      ? sizeof(void *)
+                                                      : TInline];
 
 public:
   inline func() = default;
-  inline func(func &&other) : wrapper{other.wrapper} {
-    other.wrapper = nullptr;
+  func(func const &) = delete;
+  auto operator=(func const &) -> func & = delete;
+
+  inline func(func &&other) noexcept : m_operations{other.m_operations} {
+    if (m_operations) {
+      m_operations->relocate(other.m_storage, m_storage);
+      other.m_operations = nullptr;
+    }
   }
+
   template <typename TCallable,
-            typename = std::void_t<
-                decltype(std::declval<TCallable>()(std::declval<Args>()...))>>
-  inline func(TCallable &&callable)
-      : wrapper{new _wrapper<TCallable>{std::forward<TCallable>(callable)}} {}
-  inline ~func() {
-    if (this->wrapper) {
-      delete this->wrapper;
+            typename = std::enable_if_t<
+                !std::is_same<std::decay_t<TCallable>, func>::value>,
+            typename = std::void_t<decltype(std::declval<std::decay_t<
+                TCallable> &>()(std::declval<Args>()...))>>
+  inline func(TCallable &&callable) {
+    using stored = std::decay_t<TCallable>;
+    if constexpr (stored_inline<stored>) {
+      new (m_storage) stored(std::forward<TCallable>(callable));
+      m_operations = &inline_operations<stored>::table;
+    } else {
+      new (m_storage) stored *(new stored(std::forward<TCallable>(callable)));
+      m_operations = &heap_operations<stored>::table;
+    }
+  }
+
+  inline ~func() { reset(); }
+
+  inline auto operator=(func &&other) noexcept -> func & {
+    if (this != &other) {
+      reset();
+      if (other.m_operations) {
+        other.m_operations->relocate(other.m_storage, m_storage);
+        m_operations = std::exchange(other.m_operations, nullptr);
+      }
     }
+    return *this;
   }
-  inline void operator=(func &&other) {
-    this->wrapper = other.wrapper;
-    other.wrapper = nullptr;
+
+  // drops the callable, leaving the func empty
+  inline void reset() noexcept {
+    if (m_operations) {
+      m_operations->destroy(m_storage);
+      m_operations = nullptr;
+    }
   }
+
   [[nodiscard]] inline auto is_valid() const -> bool {
-    return this->wrapper != nullptr;
+    return this->m_operations != nullptr;
+  }
+  inline explicit operator bool() const {
+    return this->m_operations != nullptr;
   }
-  inline explicit operator bool() const { return this->wrapper != nullptr; }
   inline auto operator()(Args... args) const -> Return {
-    return this->wrapper->thunk(this->wrapper, std::forward<Args>(args)...);
+    return m_operations->invoke(m_storage, std::forward<Args>(args)...);
   }
 };
+
+// A non-owning reference to a callable: a pointer to it and a pointer to a
+// function calling it. It never allocates and is trivially copyable, so it
+// is the cheap way to take a callback that is only called before the
+// function taking it returns. The callable must outlive the function_ref.
+template <typename> class function_ref;
+template <typename Return, typename... Args>
+class function_ref<Return(Args...)> {
+public:
+  template <typename TCallable,
+            typename = std::enable_if_t<
+                !std::is_same<std::decay_t<TCallable>, function_ref>::value>,
+            typename = std::void_t<decltype(std::declval<TCallable &>()(
+                std::declval<Args>()...))>>
+  function_ref(TCallable &&callable) noexcept {
+    using referenced = std::remove_reference_t<TCallable>;
+    if constexpr (std::is_function<std::remove_pointer_t<
+                      std::decay_t<TCallable>>>::value) {
+      // a plain function has no object to point to, keep the function
+      using pointer = std::decay_t<TCallable>;
+      m_target.function = reinterpret_cast<void (*)()>(pointer(callable));
+      m_thunk = [](target_type target, Args &&...args) -> Return {
+        return details::invoke_as<Return>(
+            *reinterpret_cast<pointer>(target.function),
+            std::forward<Args>(args)...);
+      };
+    } else {
+      m_target.object =
+          const_cast<void *>(static_cast<void const *>(&callable));
+      m_thunk = [](target_type target, Args &&...args) -> Return {
+        return details::invoke_as<Return>(
+            *static_cast<referenced *>(target.object),
+            std::forward<Args>(args)...);
+      };
+    }
+  }
+
+  auto operator()(Args... args) const -> Return {
+    return m_thunk(m_target, std::forward<Args>(args)...);
+  }
+
+private:
+  union target_type {
+    void *object;
+    void (*function)();
+  };
+
+  target_type m_target;
+  Return (*m_thunk)(target_type target, Args &&...args);
+};
 } // namespace zinc
\ No newline at end of file
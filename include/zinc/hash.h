@@ -0,0 +1,221 @@
+#pragma once
+
+#include "base.h"
+#include "bits.h"
+#include "option.h"
+#include "string.h"
+#include "time.h"
+#include "tuple.h"
+#include "vector.h"
+
+#include <cstring>
+
+namespace zinc {
+// Non-cryptographic hashing in the style of wyhash. Values are the same on
+// every platform and for every build, but are not meant to be stored or to
+// stand up to inputs chosen by an attacker who knows the seed.
+namespace details {
+constexpr u64 hash_secret[4] = {0x2d358dccaa6c78a5ull, 0x8bb84b93962eacc9ull,
+                                0x4b33a62ed433d4a3ull, 0x4d5a2da51de1aa47ull};
+
+[[nodiscard]] inline auto hash_mix(u64 a, u64 b) -> u64 {
+  auto const product = wide_multiply(a, b);
+  return product.low ^ product.high;
+}
+
+[[nodiscard]] inline auto hash_read64(u8 const *data) -> u64 {
+  u64 value;
+  memcpy(&value, data, sizeof(value));
+#if ZINC_CPU_ENDIAN_BIG
+  value = byte_swap(value);
+#endif
+  return value;
+}
+
+[[nodiscard]] inline auto hash_read32(u8 const *data) -> u64 {
+  u32 value;
+  memcpy(&value, data, sizeof(value));
+#if ZINC_CPU_ENDIAN_BIG
+  value = byte_swap(value);
+#endif
+  return value;
+}
+
+[[nodiscard]] inline auto hash_seed(u64 seed) -> u64 {
+  return seed ^ hash_mix(seed ^ hash_secret[0], hash_secret[1]);
+}
+
+[[nodiscard]] inline auto hash_finish(u64 a, u64 b, u64 seed, u64 size)
+    -> u64 {
+  auto const product = wide_multiply(a ^ hash_secret[1], b ^ seed);
+  return hash_mix(product.low ^ hash_secret[0] ^ size,
+                  product.high ^ hash_secret[1]);
+}
+
+// up to sixteen bytes, read as overlapping words instead of looping
+[[nodiscard]] inline auto hash_short(u8 const *data, usize size, u64 seed)
+    -> u64 {
+  u64 a = 0, b = 0;
+  if (size >= 4) {
+    auto const step = (size >> 3) << 2;
+    a = (hash_read32(data) << 32) | hash_read32(data + step);
+    b = (hash_read32(data + size - 4) << 32) |
+        hash_read32(data + size - 4 - step);
+  } else if (size > 0) {
+    a = (as<u64>(data[0]) << 16) | (as<u64>(data[size >> 1]) << 8) |
+        data[size - 1];
+  }
+  return hash_finish(a, b, seed, size);
+}
+
+// more than sixteen bytes, seed already mixed
+auto hash_long(u8 const *data, usize size, u64 seed) -> u64;
+} // namespace details
+
+[[nodiscard]] inline auto hash_bytes(void const *data, usize size,
+                                     u64 seed = 0) -> u64 {
+  auto const *bytes = static_cast<u8 const *>(data);
+  auto const mixed = details::hash_seed(seed);
+  if (size > 16)
+    return details::hash_long(bytes, size, mixed);
+  return details::hash_short(bytes, size, mixed);
+}
+
+// a single multiply, enough to spread keys that differ in a few low bits
+[[nodiscard]] inline auto hash_int(u64 value) -> u64 {
+  return details::hash_mix(value ^ details::hash_secret[0],
+                           details::hash_secret[1]);
+}
+
+// order matters, combining a then b differs from b then a
+[[nodiscard]] inline auto hash_combine(u64 seed, u64 value) -> u64 {
+  return details::hash_mix(seed ^ details::hash_secret[0],
+                           value ^ details::hash_secret[1]);
+}
+
+// Incremental form of hash_bytes: feeding the same bytes in any number of
+// pieces gives the same value as hashing them in one go.
+class hasher {
+public:
+  explicit hasher(u64 seed = 0);
+
+  auto update(void const *data, usize size) -> hasher &;
+  auto update(string_view const &text) -> hasher & {
+    return update(text.data(), text.length());
+  }
+
+  [[nodiscard]] auto finish() const -> u64;
+
+private:
+  static constexpr usize block_size = 48;
+  static constexpr usize history = 16;
+
+  u64 m_seed;
+  u64 m_lanes[2];
+  u64 m_length{0};
+  usize m_pending{0};
+  // the last history bytes already hashed, then the pending ones
+  u8 m_buffer[history + block_size];
+};
+
+// Types whose equality is equality of their bytes, so ranges of them can be
+// hashed as one block of memory. Specialise for padding free structs of such
+// types.
+template <typename T>
+struct is_trivially_hashable
+    : std::integral_constant<bool, std::is_integral<T>::value ||
+                                       std::is_enum<T>::value ||
+                                       std::is_pointer<T>::value> {};
+
+// Customisation point, specialise with an operator() taking T const & and
+// returning u64. Types left without one fail to compile when hashed.
+template <typename T, typename = void> struct hash;
+
+template <typename T> [[nodiscard]] auto hash_value(T const &value) -> u64 {
+  return hash<T>{}(value);
+}
+
+template <typename T>
+struct hash<T, std::enable_if_t<std::is_integral<T>::value ||
+                                std::is_enum<T>::value>> {
+  auto operator()(T value) const -> u64 { return hash_int(as<u64>(value)); }
+};
+
+template <typename T> struct hash<T *> {
+  auto operator()(T *value) const -> u64 {
+    return hash_int(as<u64>(reinterpret_cast<uptr>(value)));
+  }
+};
+
+// -0.0 and 0.0 compare equal so they hash the same, NaN does not matter as
+// it never finds itself
+template <typename T>
+struct hash<T, std::enable_if_t<std::is_floating_point<T>::value>> {
+  auto operator()(T value) const -> u64 {
+    if (value == 0)
+      return hash_int(0);
+    return hash_bytes(&value, sizeof(value));
+  }
+};
+
+template <> struct hash<string_view> {
+  auto operator()(string_view const &text) const -> u64 {
+    return hash_bytes(text.data(), text.length());
+  }
+};
+
+template <typename TAllocator> struct hash<basic_string<char, TAllocator>> {
+  auto operator()(basic_string<char, TAllocator> const &text) const -> u64 {
+    return hash_bytes(text.data(), text.length());
+  }
+};
+
+template <typename T, typename TAllocator> struct hash<vector<T, TAllocator>> {
+  auto operator()(vector<T, TAllocator> const &items) const -> u64 {
+    if constexpr (is_trivially_hashable<T>::value) {
+      return hash_bytes(items.data(), items.size() * sizeof(T));
+    } else {
+      auto value = hash_int(items.size());
+      auto const *data = items.data();
+      for (usize i = 0; i < items.size(); ++i)
+        value = hash_combine(value, hash_value(data[i]));
+      return value;
+    }
+  }
+};
+
+template <typename... Ts> struct hash<tuple<Ts...>> {
+  auto operator()(tuple<Ts...> const &items) const -> u64 {
+    return combine(items, std::index_sequence_for<Ts...>{});
+  }
+
+private:
+  template <usize... Is>
+  static auto combine(tuple<Ts...> const &items, std::index_sequence<Is...>)
+      -> u64 {
+    auto value = hash_int(sizeof...(Ts));
+    ((value = hash_combine(
+          value,
+          hash_value(static_cast<details::tuple_unit<
+                         Is, details::nth_element<Is, Ts...>> const &>(items)
+                         .get()))),
+     ...);
+    return value;
+  }
+};
+
+template <typename T> struct hash<option<T>> {
+  auto operator()(option<T> const &value) const -> u64 {
+    if (!value.has_value())
+      return hash_int(0);
+    return hash_combine(1, hash_value(value.value()));
+  }
+};
+
+template <> struct hash<duration> {
+  auto operator()(duration const &value) const -> u64 {
+    return hash_combine(hash_int(value.as_seconds()),
+                        value.subsecond_nanoseconds());
+  }
+};
+} // namespace zinc
\ No newline at end of file
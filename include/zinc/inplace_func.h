@@ -0,0 +1,115 @@
+#pragma once
+
+#include "base.h"
+#include "func.h"
+
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace zinc {
+// An owning callable that is always stored inside the object, for paths
+// that must never allocate. A callable bigger than TCapacity bytes or more
+// aligned than TAlign is a compile error instead of a heap fallback.
+//
+// Callables have to be trivially relocatable, and so is the inplace_func:
+// moving one copies its bytes, so it can sit in a static_vector or be
+// passed through a queue that copies memory. Lambdas capturing pointers,
+// references and plain values qualify; capture the raw pointer rather than
+// an owning handle.
+template <typename, usize TCapacity = 3 * sizeof(void *),
+          usize TAlign = alignof(void *)>
+class inplace_func;
+template <typename Return, typename... Args, usize TCapacity, usize TAlign>
+class inplace_func<Return(Args...), TCapacity, TAlign> {
+  static_assert(TCapacity > 0, "inplace_func needs room for a callable");
+
+public:
+  inplace_func() = default;
+  inplace_func(inplace_func const &) = delete;
+  auto operator=(inplace_func const &) -> inplace_func & = delete;
+
+  inplace_func(inplace_func &&other) noexcept { take(other); }
+
+  template <typename TCallable,
+            typename = std::enable_if_t<
+                !std::is_same<std::decay_t<TCallable>, inplace_func>::value>,
+            typename = std::void_t<decltype(std::declval<std::decay_t<
+                TCallable> &>()(std::declval<Args>()...))>>
+  inplace_func(TCallable &&callable) {
+    using stored = std::decay_t<TCallable>;
+    static_assert(sizeof(stored) <= TCapacity,
+                  "callable does not fit in the inplace_func");
+    static_assert(alignof(stored) <= TAlign,
+                  "callable is more aligned than the inplace_func");
+    static_assert(is_trivially_relocatable<stored>::value,
+                  "inplace_func callables must be trivially relocatable");
+    new (m_storage) stored(std::forward<TCallable>(callable));
+    m_operations = &operations_for<stored>;
+  }
+
+  ~inplace_func() { reset(); }
+
+  auto operator=(inplace_func &&other) noexcept -> inplace_func & {
+    if (this != &other) {
+      reset();
+      take(other);
+    }
+    return *this;
+  }
+
+  // drops the callable, leaving the inplace_func empty
+  void reset() noexcept {
+    if (m_operations && m_operations->destroy)
+      m_operations->destroy(m_storage);
+    m_operations = nullptr;
+  }
+
+  [[nodiscard]] auto is_valid() const -> bool {
+    return m_operations != nullptr;
+  }
+  explicit operator bool() const { return m_operations != nullptr; }
+  auto operator()(Args... args) const -> Return {
+    return m_operations->invoke(m_storage, std::forward<Args>(args)...);
+  }
+
+private:
+  struct operations {
+    Return (*invoke)(void *storage, Args &&...args);
+    // null for callables without a destructor to run
+    void (*destroy)(void *storage) noexcept;
+  };
+
+  template <typename TCallable>
+  static auto invoke(void *storage, Args &&...args) -> Return {
+    return details::invoke_as<Return>(
+        *std::launder(static_cast<TCallable *>(storage)),
+        std::forward<Args>(args)...);
+  }
+
+  template <typename TCallable> static void destroy(void *storage) noexcept {
+    std::launder(static_cast<TCallable *>(storage))->~TCallable();
+  }
+
+  template <typename TCallable>
+  static constexpr operations operations_for = {
+      &invoke<TCallable>,
+      std::is_trivially_destructible<TCallable>::value ? nullptr
+                                                       : &destroy<TCallable>};
+
+  // relocates the callable of other into this empty inplace_func
+  void take(inplace_func &other) noexcept {
+    m_operations = std::exchange(other.m_operations, nullptr);
+    if (m_operations)
+      std::memcpy(m_storage, other.m_storage, TCapacity);
+  }
+
+  operations const *m_operations = nullptr;
+  alignas(TAlign) mutable unsigned char m_storage[TCapacity];
+};
+
+template <typename TSignature, usize TCapacity, usize TAlign>
+struct is_trivially_relocatable<inplace_func<TSignature, TCapacity, TAlign>>
+    : std::true_type {};
+} // namespace zinc
\ No newline at end of file
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "base.h"
+#include "hash.h"
+#include "string.h"
+
+#include <mutex>
+
+namespace zinc {
+// A handle to a string owned by an interner. Two symbols from the same
+// interner are equal exactly when their strings are, so comparing and hashing
+// only look at the id.
+struct symbol {
+public:
+  static constexpr u32 invalid_id = ~u32(0);
+
+  constexpr symbol() = default;
+  constexpr explicit symbol(u32 id) : m_id(id) {}
+
+  [[nodiscard]] constexpr auto id() const -> u32 { return m_id; }
+  [[nodiscard]] constexpr auto is_valid() const -> bool {
+    return m_id != invalid_id;
+  }
+  constexpr explicit operator bool() const { return is_valid(); }
+
+  [[nodiscard]] constexpr auto hash() const -> u64 {
+    return (m_id + 1) * 0x9e3779b97f4a7c15ull;
+  }
+
+  constexpr auto operator==(symbol other) const -> bool {
+    return m_id == other.m_id;
+  }
+  constexpr auto operator!=(symbol other) const -> bool {
+    return m_id != other.m_id;
+  }
+  // orders by interning time, not alphabetically
+  constexpr auto operator<(symbol other) const -> bool {
+    return m_id < other.m_id;
+  }
+
+private:
+  u32 m_id{invalid_id};
+};
+
+template <> struct hash<symbol> {
+  auto operator()(symbol value) const -> u64 { return value.hash(); }
+};
+
+// Maps strings to symbols. Interned bytes are copied once into an arena and
+// never move, so resolve hands out views that stay valid for the lifetime of
+// the interner. Looking up a string that is already interned never takes a
+// lock, only adding a new one does.
+struct interner : public zinc::non_copyable {
+public:
+  interner();
+  ~interner();
+
+  [[nodiscard]] static auto global() -> interner &;
+
+  auto intern(string_view const &text) -> symbol;
+  // an invalid symbol when text was never interned
+  [[nodiscard]] auto find(string_view const &text) const -> symbol;
+  // the returned view is null terminated
+  [[nodiscard]] auto resolve(symbol value) const -> string_view;
+
+  [[nodiscard]] auto size() const -> usize {
+    return m_count.load(std::memory_order_acquire);
+  }
+
+private:
+  struct entry;
+  struct table;
+  struct chunk;
+
+  // entries live in segments that double in size and never move
+  static constexpr u32 first_segment_bits = 6;
+  static constexpr u32 segment_count = 32 - first_segment_bits;
+
+  [[nodiscard]] auto entry_at(u32 id) const -> entry const &;
+  [[nodiscard]] auto lookup(table const &index, string_view const &text,
+                            u64 hash) const -> symbol;
+  auto store(string_view const &text) -> char const *;
+  auto append(string_view const &text, u64 hash) -> u32;
+  void grow();
+
+  std::atomic<table *> m_table;
+  std::atomic<entry *> m_segments[segment_count] = {};
+  std::atomic<u32> m_count{0};
+
+  // everything below is only touched with the mutex held
+  std::mutex m_mutex;
+  chunk *m_chunks{nullptr};
+  usize m_chunk_used{0};
+};
+} // namespace zinc
\ No newline at end of file
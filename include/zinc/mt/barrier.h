@@ -17,6 +17,9 @@ public:
 private:
   usize m_thread_count;
   usize m_waiting_count;
+  // bumped on every release, so a thread already waiting at the next use
+  // does not keep the previous waiters asleep
+  usize m_generation;
   std::mutex m_mutex;
   std::condition_variable m_condition;
 };
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "../allocator/pool.h"
+
+#include <mutex>
+
+namespace zinc {
+// A pool shared between threads. Every call takes a lock, so blocks coming
+// back from a reclamation domain should be returned in batches.
+struct concurrent_pool : public zinc::non_copyable {
+public:
+  concurrent_pool(usize granularity, usize size);
+
+  [[nodiscard]] auto get_granularity() const -> usize {
+    return m_pool.get_granularity();
+  }
+  [[nodiscard]] auto get_used() const -> usize;
+  [[nodiscard]] auto get_overflow() const -> usize;
+
+  auto allocate() -> vptr;
+  void deallocate(vptr block);
+  void deallocate(vptr const *blocks, usize count);
+
+  template <typename TValue, typename... TArgs>
+  auto construct(TArgs &&...args) -> TValue * {
+    ZINC_ASSERT(sizeof(TValue) <= get_granularity());
+    return new (allocate()) TValue(std::forward<TArgs>(args)...);
+  }
+
+  template <typename TValue> void destroy(TValue *instance) {
+    instance->~TValue();
+    deallocate(instance);
+  }
+
+private:
+  mutable std::mutex m_mutex;
+  pool m_pool;
+};
+} // namespace zinc
\ No newline at end of file
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "../base.h"
+#include "../debug.h"
+#include "reclaim.h"
+
+#include <mutex>
+
+namespace zinc {
+// Epoch based reclamation. A reader publishes the global epoch it saw when it
+// entered a critical section and clears it on the way out, which costs a plain
+// store and a fence but no read-modify-write. Writers unlink an object, retire
+// it, and it is reclaimed once no reader that might still see it is left.
+// Retired objects collect in a per thread batch that is published to the
+// domain as a whole, so retire only touches shared state once per batch.
+struct epoch_domain : public zinc::non_copyable {
+public:
+  using reclaim_fn = zinc::reclaim_fn;
+  static constexpr usize batch_size = 64;
+
+  // per thread reader state, owned by the domain
+  struct record;
+
+  [[nodiscard]] static auto global() -> epoch_domain &;
+
+  void enter();
+  void leave();
+  [[nodiscard]] auto in_critical_section() const -> bool;
+
+  void retire(retired_object const &object);
+  void retire(vptr object, reclaim_fn reclaim) {
+    retire(retired_object{object, reclaim, nullptr, nullptr});
+  }
+  template <typename TValue> void retire(TValue *object) {
+    retire(make_retired(object));
+  }
+  // destroys object after its batch's grace period, owner gets the blocks
+  // of the whole batch back in one deallocate call
+  template <typename TPool, typename TValue>
+  void retire(TPool &owner, TValue *object) {
+    retire(make_retired(owner, object));
+  }
+
+  // publishes this thread's pending batch so any thread can reclaim it
+  void flush();
+  // blocks until every reader that was inside a critical section has left,
+  // then reclaims everything this thread retired before the call
+  void synchronize();
+  // reclaims whatever is already safe without waiting
+  auto try_reclaim() -> usize;
+
+  [[nodiscard]] auto get_epoch() const -> u64 {
+    return m_epoch.load(std::memory_order_acquire);
+  }
+  // objects in published batches that are still waiting for a grace period
+  [[nodiscard]] auto get_retired() const -> usize {
+    return m_retired_count.load(std::memory_order_relaxed);
+  }
+
+private:
+  struct retired;
+
+  epoch_domain() = default;
+
+  auto local_record() -> record &;
+  void publish(record &local);
+  auto min_active_epoch() const -> u64;
+  auto reclaim_before(u64 epoch) -> usize;
+
+  alignas(ZINC_CACHE_LINE_SIZE) std::atomic<u64> m_epoch{1};
+  std::atomic<record *> m_records{nullptr};
+
+  std::mutex m_retired_mutex;
+  retired *m_retired{nullptr};
+  std::atomic<usize> m_retired_count{0};
+};
+
+struct epoch_guard : public zinc::non_copyable {
+public:
+  explicit epoch_guard(epoch_domain &domain = epoch_domain::global())
+      : m_domain(domain) {
+    m_domain.enter();
+  }
+  ~epoch_guard() { m_domain.leave(); }
+
+private:
+  epoch_domain &m_domain;
+};
+} // namespace zinc
\ No newline at end of file
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "../base.h"
+#include "../debug.h"
+#include "reclaim.h"
+
+#include <atomic>
+#include <cstdlib>
+
+namespace zinc {
+// Hazard pointers. A reader publishes the exact node it is about to touch in
+// one of its thread's slots, a retired node is only reclaimed once no slot
+// names it. Unlike epochs a stalled reader pins a handful of nodes rather
+// than everything retired after it, so memory stays bounded.
+struct hazard_domain : public zinc::non_copyable {
+public:
+  static constexpr usize slots_per_thread = 4;
+
+  // per thread slots and retired list, owned by the domain
+  struct record;
+
+  [[nodiscard]] static auto global() -> hazard_domain &;
+
+  void retire(retired_object const &object);
+  template <typename TValue> void retire(TValue *object) {
+    retire(make_retired(object));
+  }
+  // destroys object once a scan finds it in no slot, and hands its block
+  // back in one deallocate call with owner's others that scan frees
+  template <typename TPool, typename TValue>
+  void retire(TPool &owner, TValue *object) {
+    retire(make_retired(owner, object));
+  }
+
+  // scans the slots now instead of waiting for the retired list to fill up,
+  // also adopts whatever exited threads left behind
+  auto reclaim() -> usize;
+
+  [[nodiscard]] auto get_retired() const -> usize;
+
+private:
+  friend struct hazard_pointer;
+
+  hazard_domain() = default;
+
+  auto local_record() -> record &;
+  auto acquire_slot() -> std::atomic<vptr> &;
+  void release_slot(std::atomic<vptr> &slot);
+  auto scan(record &local) -> usize;
+  [[nodiscard]] auto threshold() const -> usize;
+
+  std::atomic<record *> m_records{nullptr};
+  std::atomic<usize> m_record_count{0};
+};
+
+// owns one of the calling thread's slots for as long as it lives
+struct hazard_pointer : public zinc::non_copyable {
+public:
+  explicit hazard_pointer(hazard_domain &domain = hazard_domain::global())
+      : m_domain(domain), m_slot(domain.acquire_slot()) {}
+  ~hazard_pointer() { m_domain.release_slot(m_slot); }
+
+  // loads source and keeps the result safe to dereference until the next
+  // protect or reset
+  template <typename TValue>
+  auto protect(std::atomic<TValue *> const &source) -> TValue * {
+    auto *pointer = source.load(std::memory_order_relaxed);
+    while (!try_protect(pointer, source)) {
+    }
+    return pointer;
+  }
+
+  // publishes pointer and checks it is still what source holds, on failure
+  // pointer is updated to the current value
+  template <typename TValue>
+  auto try_protect(TValue *&pointer, std::atomic<TValue *> const &source)
+      -> bool {
+    auto *const expected = pointer;
+    m_slot.store(const_cast<std::remove_cv_t<TValue> *>(expected),
+                 std::memory_order_seq_cst);
+    pointer = source.load(std::memory_order_seq_cst);
+    if (pointer == expected)
+      return true;
+    m_slot.store(nullptr, std::memory_order_release);
+    return false;
+  }
+
+  template <typename TValue> void reset(TValue *pointer) {
+    m_slot.store(const_cast<std::remove_cv_t<TValue> *>(pointer),
+                 std::memory_order_seq_cst);
+  }
+  void reset() { m_slot.store(nullptr, std::memory_order_release); }
+
+private:
+  hazard_domain &m_domain;
+  std::atomic<vptr> &m_slot;
+};
+} // namespace zinc
\ No newline at end of file
@@ -0,0 +1,350 @@
+#pragma once
+
+#include "../algorithm.h"
+#include "../vector.h"
+#include "barrier.h"
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace zinc {
+namespace details {
+// below this starting the threads costs more than they save
+constexpr usize parallel_sort_threshold = 1 << 16;
+// samples drawn per bucket, more of them gives evener buckets
+constexpr usize sample_oversampling = 32;
+// buckets per thread, the spare ones let fast threads take more of them
+constexpr usize buckets_per_thread = 4;
+// bucket ids are bytes and every splitter has an odd id for its equal keys
+constexpr usize max_splitters = 127;
+
+inline auto resolve_threads(u32 threads) -> u32 {
+  if (threads == 0)
+    threads = std::thread::hardware_concurrency();
+  return threads ? threads : 1;
+}
+
+// runs work(index) on threads threads, the calling thread being index zero
+template <typename TWork>
+inline auto fork_join(u32 threads, TWork &work) -> void {
+  std::vector<std::thread> helpers;
+  helpers.reserve(threads - 1);
+  for (u32 i = 1; i < threads; ++i)
+    helpers.emplace_back([&work, i] { work(i); });
+  work(0);
+  for (auto &helper : helpers)
+    helper.join();
+}
+
+// A bump arena over a single allocation. A parallel sort carves all of its
+// scratch arrays out of one, so it calls the allocator once, and every
+// array starts on its own cache line so threads writing to neighbouring
+// arrays do not share lines.
+struct sort_arena : non_copyable {
+public:
+  static constexpr usize alignment = 64;
+
+  explicit sort_arena(usize size)
+      : m_base(static_cast<u8 *>(::operator new(size + alignment))),
+        m_used(0) {}
+  ~sort_arena() { ::operator delete(m_base); }
+
+  // room the arena needs to hand out count values of TValue
+  template <typename TValue>
+  static constexpr auto footprint(usize count) -> usize {
+    return count * sizeof(TValue) + alignment;
+  }
+
+  template <typename TValue> auto take(usize count) -> TValue * {
+    static_assert(alignof(TValue) <= alignment);
+    auto address = as<uptr>(m_base) + m_used;
+    address = (address + alignment - 1) & ~as<uptr>(alignment - 1);
+    m_used = address - as<uptr>(m_base) + count * sizeof(TValue);
+    return reinterpret_cast<TValue *>(address);
+  }
+
+private:
+  u8 *m_base;
+  usize m_used;
+};
+
+// Index of the first splitter that does not order before value. The loop
+// runs the same number of times for every value and only the position
+// depends on the comparison, so it compiles to conditional moves for
+// arithmetic types instead of a mispredicted branch per level.
+template <typename TValue, typename TCompare>
+inline auto splitter_rank(TValue const &value, TValue const *splitters,
+                          usize count, TCompare &compare) -> usize {
+  auto const *first = splitters;
+  while (count > 0) {
+    auto const half = count / 2;
+    first = compare(first[half], value) ? first + count - half : first;
+    count = half;
+  }
+  return as<usize>(first - splitters);
+}
+
+// Sample sort. Splitters picked from a sorted sample cut the values into
+// buckets, each thread counts and then moves its own slice into a scratch
+// array, and the threads take buckets to sort until none are left. Slices
+// are scattered in order, so a stable sort_bucket gives a stable result.
+// Values equal to a splitter get a bucket of their own that needs no
+// sorting, which keeps inputs with few distinct values from ending up in
+// one bucket.
+template <typename TValue, typename TCompare, typename TSortBucket>
+inline auto sample_sort(TValue *data, usize count, TCompare &compare,
+                        u32 threads, TSortBucket &sort_bucket) -> void {
+  auto const wanted = threads * buckets_per_thread;
+  auto const bucket_target =
+      wanted - 1 < max_splitters ? wanted : max_splitters + 1;
+
+  // evenly spaced samples, each moved by a pseudo random offset inside
+  // its stride so periodic inputs do not line up with the picks
+  auto const sample_count = bucket_target * sample_oversampling;
+  auto const stride = count / sample_count;
+  std::vector<TValue> samples;
+  samples.reserve(sample_count);
+  u64 state = 0x9e3779b97f4a7c15;
+  for (usize i = 0; i < sample_count; ++i) {
+    state = state * 6364136223846793005 + 1442695040888963407;
+    samples.push_back(data[i * stride + as<usize>(state >> 33) % stride]);
+  }
+  pdqsort(samples.data(), samples.data() + sample_count, compare);
+  std::vector<TValue> splitters;
+  for (usize i = 1; i < bucket_target; ++i) {
+    auto const &pick = samples[i * sample_oversampling];
+    if (splitters.empty() || compare(splitters.back(), pick))
+      splitters.push_back(pick);
+  }
+  auto const splitter_count = splitters.size();
+  auto const bucket_count = 2 * splitter_count + 1;
+  // each thread's counts on their own lines
+  auto const row = (bucket_count + 7) & ~usize(7);
+
+  sort_arena arena(sort_arena::footprint<TValue>(count) +
+                   sort_arena::footprint<u8>(count) +
+                   sort_arena::footprint<usize>(row * threads) +
+                   sort_arena::footprint<usize>(bucket_count + 1) +
+                   sort_arena::footprint<u8>(bucket_count));
+  auto *buffer = arena.take<TValue>(count);
+  auto *ids = arena.take<u8>(count);
+  auto *counts = arena.take<usize>(row * threads);
+  auto *starts = arena.take<usize>(bucket_count + 1);
+  auto *order = arena.take<u8>(bucket_count);
+
+  barrier phases(threads);
+  std::atomic<usize> next_bucket{0};
+  auto work = [&](u32 index) {
+    auto const begin = count * index / threads;
+    auto const end = count * (index + 1) / threads;
+    auto *mine = counts + row * index;
+    for (usize b = 0; b < bucket_count; ++b)
+      mine[b] = 0;
+    auto const *split = splitters.data();
+    for (auto i = begin; i < end; ++i) {
+      auto const rank = splitter_rank(data[i], split, splitter_count, compare);
+      auto const equal =
+          rank < splitter_count && !compare(data[i], split[rank]);
+      ids[i] = as<u8>(2 * rank + (equal ? 1 : 0));
+      ++mine[ids[i]];
+    }
+    phases.wait();
+
+    // this slice goes after the same bucket of every earlier slice
+    usize next[2 * max_splitters + 1];
+    usize start = 0;
+    for (usize b = 0; b < bucket_count; ++b) {
+      if (index == 0)
+        starts[b] = start;
+      for (u32 t = 0; t < threads; ++t) {
+        if (t == index)
+          next[b] = start;
+        start += counts[row * t + b];
+      }
+    }
+    if (index == 0) {
+      starts[bucket_count] = count;
+      // largest first, so the last buckets taken are the quick ones
+      for (usize b = 0; b < bucket_count; ++b)
+        order[b] = as<u8>(b);
+      std::sort(order, order + bucket_count, [starts](u8 a, u8 b) {
+        return starts[a + 1] - starts[a] > starts[b + 1] - starts[b];
+      });
+    }
+    for (auto i = begin; i < end; ++i)
+      new (buffer + next[ids[i]]++) TValue(std::move(data[i]));
+    phases.wait();
+
+    for (;;) {
+      auto const taken = next_bucket.fetch_add(1, std::memory_order_relaxed);
+      if (taken >= bucket_count)
+        break;
+      auto const b = order[taken];
+      auto *from = buffer + starts[b];
+      auto const size = starts[b + 1] - starts[b];
+      if (b % 2 == 0 && size > 1)
+        sort_bucket(from, size);
+      auto *to = data + starts[b];
+      if constexpr (std::is_trivially_copyable<TValue>::value) {
+        memcpy(static_cast<void *>(to), from, size * sizeof(TValue));
+      } else {
+        for (usize i = 0; i < size; ++i) {
+          to[i] = std::move(from[i]);
+          from[i].~TValue();
+        }
+      }
+    }
+  };
+  fork_join(threads, work);
+}
+
+// Where the first diagonal outputs of a merge split between a and b,
+// taking from a on ties. Returns how many come from a.
+template <typename TValue, typename TCompare>
+inline auto merge_split(TValue const *a, usize a_count, TValue const *b,
+                        usize b_count, usize diagonal, TCompare &compare)
+    -> usize {
+  auto low = diagonal > b_count ? diagonal - b_count : 0;
+  auto high = diagonal < a_count ? diagonal : a_count;
+  while (low < high) {
+    auto const middle = low + (high - low) / 2;
+    if (compare(b[diagonal - middle - 1], a[middle]))
+      high = middle;
+    else
+      low = middle + 1;
+  }
+  return low;
+}
+} // namespace details
+
+// Merges the sorted ranges a and b into out, which must have room for both
+// and not overlap them. Stable: of two equal values the one from a comes
+// first. The output is cut into one piece per thread along the merge path,
+// so every thread merges the same number of values whatever the inputs.
+template <typename TValue, typename TCompare>
+inline auto parallel_merge(TValue const *a, usize a_count, TValue const *b,
+                           usize b_count, TValue *out, TCompare compare,
+                           u32 threads = 0)
+    -> std::enable_if_t<!std::is_integral<TCompare>::value> {
+  auto const total = a_count + b_count;
+  threads = details::resolve_threads(threads);
+  if (threads <= 1 || total < details::parallel_sort_threshold) {
+    std::merge(a, a + a_count, b, b + b_count, out, compare);
+    return;
+  }
+  auto work = [&](u32 index) {
+    auto const first = total * index / threads;
+    auto const last = total * (index + 1) / threads;
+    auto const a_first =
+        details::merge_split(a, a_count, b, b_count, first, compare);
+    auto const a_last =
+        details::merge_split(a, a_count, b, b_count, last, compare);
+    std::merge(a + a_first, a + a_last, b + (first - a_first),
+               b + (last - a_last), out + first, compare);
+  };
+  details::fork_join(threads, work);
+}
+
+template <typename TValue>
+inline auto parallel_merge(TValue const *a, usize a_count, TValue const *b,
+                           usize b_count, TValue *out, u32 threads = 0)
+    -> void {
+  parallel_merge(a, a_count, b, b_count, out, std::less<TValue>(), threads);
+}
+
+// Sorts with up to threads threads, zero picks one per hardware thread.
+// Not stable. Small arrays and a single thread go straight to zinc::sort.
+// Splitters are copies of sampled values, so TValue must be copyable.
+template <typename TValue, typename TCompare>
+inline auto parallel_sort(TValue *data, usize count, TCompare compare,
+                          u32 threads = 0)
+    -> std::enable_if_t<!std::is_integral<TCompare>::value> {
+  threads = details::resolve_threads(threads);
+  if (threads <= 1 || count < details::parallel_sort_threshold) {
+    sort(data, count, compare);
+    return;
+  }
+  auto sort_bucket = [&compare](TValue *begin, usize size) {
+    sort(begin, size, compare);
+  };
+  details::sample_sort(data, count, compare, threads, sort_bucket);
+}
+
+// Ascending order. Buckets of integers and floats take the radix sort.
+template <typename TValue>
+inline auto parallel_sort(TValue *data, usize count, u32 threads = 0)
+    -> void {
+  threads = details::resolve_threads(threads);
+  if (threads <= 1 || count < details::parallel_sort_threshold) {
+    sort(data, count);
+    return;
+  }
+  std::less<TValue> compare;
+  auto sort_bucket = [](TValue *begin, usize size) { sort(begin, size); };
+  details::sample_sort(data, count, compare, threads, sort_bucket);
+}
+
+// Like parallel_sort, but equal values keep their order.
+template <typename TValue, typename TCompare>
+inline auto parallel_stable_sort(TValue *data, usize count, TCompare compare,
+                                 u32 threads = 0)
+    -> std::enable_if_t<!std::is_integral<TCompare>::value> {
+  threads = details::resolve_threads(threads);
+  auto sort_bucket = [&compare](TValue *begin, usize size) {
+    std::stable_sort(begin, begin + size, compare);
+  };
+  if (threads <= 1 || count < details::parallel_sort_threshold) {
+    sort_bucket(data, count);
+    return;
+  }
+  details::sample_sort(data, count, compare, threads, sort_bucket);
+}
+
+template <typename TValue>
+inline auto parallel_stable_sort(TValue *data, usize count, u32 threads = 0)
+    -> void {
+  parallel_stable_sort(data, count, std::less<TValue>(), threads);
+}
+
+template <typename TValue, typename TAllocator>
+inline auto parallel_sort(vector<TValue, TAllocator> &items, u32 threads = 0)
+    -> void {
+  parallel_sort(items.data(), items.size(), threads);
+}
+
+template <typename TValue, typename TAllocator, typename TCompare>
+inline auto parallel_sort(vector<TValue, TAllocator> &items, TCompare compare,
+                          u32 threads = 0)
+    -> std::enable_if_t<!std::is_integral<TCompare>::value> {
+  parallel_sort(items.data(), items.size(), compare, threads);
+}
+
+template <typename TValue, typename TAllocator>
+inline auto parallel_stable_sort(vector<TValue, TAllocator> &items,
+                                 u32 threads = 0) -> void {
+  parallel_stable_sort(items.data(), items.size(), threads);
+}
+
+template <typename TValue, typename TAllocator, typename TCompare>
+inline auto parallel_stable_sort(vector<TValue, TAllocator> &items,
+                                 TCompare compare, u32 threads = 0)
+    -> std::enable_if_t<!std::is_integral<TCompare>::value> {
+  parallel_stable_sort(items.data(), items.size(), compare, threads);
+}
+
+// out is resized to hold both inputs
+template <typename TValue, typename TAllocator>
+inline auto parallel_merge(vector<TValue, TAllocator> &a,
+                           vector<TValue, TAllocator> &b,
+                           vector<TValue, TAllocator> &out, u32 threads = 0)
+    -> void {
+  out.resize(a.size() + b.size());
+  parallel_merge(a.data(), a.size(), b.data(), b.size(), out.data(), threads);
+}
+} // namespace zinc
\ No newline at end of file
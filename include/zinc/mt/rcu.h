@@ -0,0 +1,53 @@
+#pragma once
+
+#include "epoch.h"
+
+namespace zinc {
+// A pointer published for read-mostly data. Readers dereference it inside an
+// epoch_guard without touching any shared counter, writers swap in a new
+// version and the old one is freed after a grace period.
+template <typename TValue> struct rcu_ptr : public zinc::non_copyable {
+public:
+  explicit rcu_ptr(TValue *initial = nullptr,
+                   epoch_domain &domain = epoch_domain::global())
+      : m_domain(domain), m_pointer(initial) {}
+  // the owner guarantees there are no readers left at this point
+  ~rcu_ptr() { delete m_pointer.load(std::memory_order_relaxed); }
+
+  // only valid until the surrounding epoch_guard is dropped
+  [[nodiscard]] auto load() const -> TValue const * {
+    ZINC_ASSERTF(m_domain.in_critical_section(),
+                 "rcu_ptr::load outside of an epoch_guard");
+    return m_pointer.load(std::memory_order_acquire);
+  }
+
+  template <typename TFunc> auto read(TFunc &&func) const {
+    epoch_guard guard(m_domain);
+    return func(load());
+  }
+
+  // publishes the new version and defers freeing the old one
+  void store(TValue *next) {
+    auto *previous = m_pointer.exchange(next, std::memory_order_acq_rel);
+    if (previous)
+      m_domain.retire(previous);
+    m_domain.try_reclaim();
+  }
+
+  template <typename... TArgs> void emplace(TArgs &&...args) {
+    store(new TValue(std::forward<TArgs>(args)...));
+  }
+
+  // like store but waits for the grace period and frees the old version
+  // before returning
+  void store_and_synchronize(TValue *next) {
+    auto *previous = m_pointer.exchange(next, std::memory_order_acq_rel);
+    m_domain.synchronize();
+    delete previous;
+  }
+
+private:
+  epoch_domain &m_domain;
+  std::atomic<TValue *> m_pointer;
+};
+} // namespace zinc
\ No newline at end of file
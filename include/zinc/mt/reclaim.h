@@ -0,0 +1,47 @@
+#pragma once
+
+#include "../base.h"
+
+#include <type_traits>
+
+namespace zinc {
+using reclaim_fn = void (*)(vptr);
+// hands a run of objects back to whatever they came from in one call
+using reclaim_batch_fn = void (*)(vptr context, vptr *objects, usize count);
+
+// An object that has been unlinked from a shared structure and is waiting for
+// the readers that might still hold it to go away. Objects retired into the
+// same context with the same batch function are reclaimed together, which
+// lets a pool take a whole run of blocks back under a single lock.
+struct retired_object {
+  vptr object;
+  reclaim_fn reclaim;
+  vptr context;
+  reclaim_batch_fn reclaim_batch;
+};
+
+template <typename TValue>
+[[nodiscard]] auto make_retired(TValue *object) -> retired_object {
+  return {const_cast<std::remove_cv_t<TValue> *>(object),
+          [](vptr instance) { delete static_cast<TValue *>(instance); },
+          nullptr, nullptr};
+}
+
+// TPool needs a deallocate(vptr const *blocks, usize count) overload, the
+// object is destroyed in place and its block goes back to owner
+template <typename TPool, typename TValue>
+[[nodiscard]] auto make_retired(TPool &owner, TValue *object)
+    -> retired_object {
+  return {const_cast<std::remove_cv_t<TValue> *>(object), nullptr, &owner,
+          [](vptr context, vptr *objects, usize count) {
+            for (usize i = 0; i < count; ++i)
+              static_cast<TValue *>(objects[i])->~TValue();
+            static_cast<TPool *>(context)->deallocate(objects, count);
+          }};
+}
+
+namespace details {
+// reclaims count entries, grouping neighbours that share a batch function
+void reclaim_retired(retired_object const *objects, usize count);
+} // namespace details
+} // namespace zinc
\ No newline at end of file
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "../base.h"
+
+namespace zinc {
+// A sequence lock for small trivially copyable values. Readers never write to
+// shared memory, they copy the value and retry if a writer raced with them.
+// The value is kept as an array of relaxed atomic words so the racy copy is
+// still well defined.
+template <typename TValue> struct seqlock : public zinc::non_copyable {
+public:
+  static_assert(std::is_trivially_copyable_v<TValue>,
+                "seqlock values are copied word by word");
+
+  seqlock() { write_words(TValue{}); }
+  explicit seqlock(TValue const &value) { write_words(value); }
+
+  [[nodiscard]] auto load() const -> TValue {
+    TValue value;
+    while (!try_load(value)) {
+    }
+    return value;
+  }
+
+  // single read attempt, fails if a writer was active during the copy
+  [[nodiscard]] auto try_load(TValue &value) const -> bool {
+    auto const begin = m_sequence.load(std::memory_order_acquire);
+    if (begin & 1)
+      return false;
+
+    usize words[word_count];
+    for (usize i = 0; i < word_count; ++i)
+      words[i] = m_words[i].load(std::memory_order_relaxed);
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (m_sequence.load(std::memory_order_relaxed) != begin)
+      return false;
+
+    memcpy(&value, words, sizeof(TValue));
+    return true;
+  }
+
+  // writers serialise on the sequence itself, an odd value means a write is
+  // in progress
+  void store(TValue const &value) {
+    auto sequence = m_sequence.load(std::memory_order_relaxed);
+    for (;;) {
+      if (!(sequence & 1) &&
+          m_sequence.compare_exchange_weak(sequence, sequence + 1,
+                                           std::memory_order_acquire,
+                                           std::memory_order_relaxed))
+        break;
+      sequence = m_sequence.load(std::memory_order_relaxed);
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+    write_words(value);
+    m_sequence.store(sequence + 2, std::memory_order_release);
+  }
+
+  [[nodiscard]] auto sequence() const -> usize {
+    return m_sequence.load(std::memory_order_acquire);
+  }
+
+private:
+  static constexpr usize word_count =
+      (sizeof(TValue) + sizeof(usize) - 1) / sizeof(usize);
+
+  void write_words(TValue const &value) {
+    usize words[word_count]{};
+    memcpy(words, &value, sizeof(TValue));
+    for (usize i = 0; i < word_count; ++i)
+      m_words[i].store(words[i], std::memory_order_relaxed);
+  }
+
+  alignas(ZINC_CACHE_LINE_SIZE) std::atomic<usize> m_sequence{0};
+  std::atomic<usize> m_words[word_count];
+};
+} // namespace zinc
\ No newline at end of file
@@ -0,0 +1,112 @@
+#pragma once
+
+#include "base.h"
+#include "option.h"
+#include "string.h"
+
+#include <limits>
+
+namespace zinc {
+// the most characters format_int and format_float write for any value
+inline constexpr usize max_int_chars = 20;
+inline constexpr usize max_float_chars = 25;
+
+namespace details {
+auto format_unsigned(char *out, u64 value) -> usize;
+auto format_signed(char *out, i64 value) -> usize;
+auto format_f64(char *out, f64 value) -> usize;
+auto format_f32(char *out, f32 value) -> usize;
+
+auto parse_unsigned(char const *data, usize length, u64 &value) -> bool;
+auto parse_f64(char const *data, usize length, f64 &value) -> bool;
+auto parse_f32(char const *data, usize length, f32 &value) -> bool;
+} // namespace details
+
+// Conversions never look at the locale, write no terminator and return how
+// many characters they wrote. Integers come out as plain decimal. Floats
+// come out with the fewest digits that still parse back to the same value,
+// laid out the way JavaScript prints numbers: fixed notation when the
+// decimal exponent is in [-6, 21), otherwise 1.5e+300 style.
+template <typename TInt>
+inline auto format_int(char *out, TInt value) -> usize {
+  static_assert(std::is_integral_v<TInt> && !std::is_same_v<TInt, bool>,
+                "format_int takes integers");
+  if constexpr (std::is_signed_v<TInt>)
+    return details::format_signed(out, value);
+  else
+    return details::format_unsigned(out, value);
+}
+
+inline auto format_float(char *out, f64 value) -> usize {
+  return details::format_f64(out, value);
+}
+inline auto format_float(char *out, f32 value) -> usize {
+  return details::format_f32(out, value);
+}
+
+// appending variants
+template <typename TInt, typename TAllocator>
+inline void format_int(basic_string<char, TAllocator> &out, TInt value) {
+  char buffer[max_int_chars];
+  out.append(buffer, format_int(buffer, value));
+}
+
+template <typename TFloat, typename TAllocator>
+inline void format_float(basic_string<char, TAllocator> &out, TFloat value) {
+  static_assert(std::is_floating_point_v<TFloat>,
+                "format_float takes f32 or f64");
+  char buffer[max_float_chars];
+  out.append(buffer, format_float(buffer, value));
+}
+
+// The whole view has to be the number, no whitespace and no leading plus.
+// Signed types take a leading minus. Anything out of range is None.
+template <typename TInt>
+[[nodiscard]] inline auto parse_int(string_view const &text) -> option<TInt> {
+  static_assert(std::is_integral_v<TInt> && !std::is_same_v<TInt, bool>,
+                "parse_int takes integers");
+  auto const *data = text.data();
+  auto length = text.length();
+  auto negative = false;
+  if constexpr (std::is_signed_v<TInt>) {
+    if (length > 0 && data[0] == '-') {
+      negative = true;
+      ++data;
+      --length;
+    }
+  }
+
+  u64 magnitude;
+  if (!details::parse_unsigned(data, length, magnitude))
+    return None;
+
+  if constexpr (std::is_signed_v<TInt>) {
+    auto const limit = as<u64>(std::numeric_limits<TInt>::max());
+    if (magnitude > limit + (negative ? 1 : 0))
+      return None;
+    return as<TInt>(negative ? 0 - magnitude : magnitude);
+  } else {
+    if (magnitude > std::numeric_limits<TInt>::max())
+      return None;
+    return as<TInt>(magnitude);
+  }
+}
+
+// accepts what format_float writes and also inf, infinity and nan in any
+// case, out of range magnitudes become infinity or zero like strtod
+template <typename TFloat>
+[[nodiscard]] inline auto parse_float(string_view const &text)
+    -> option<TFloat> {
+  static_assert(std::is_same_v<TFloat, f32> || std::is_same_v<TFloat, f64>,
+                "parse_float takes f32 or f64");
+  TFloat value;
+  auto parsed = false;
+  if constexpr (std::is_same_v<TFloat, f64>)
+    parsed = details::parse_f64(text.data(), text.length(), value);
+  else
+    parsed = details::parse_f32(text.data(), text.length(), value);
+  if (!parsed)
+    return None;
+  return value;
+}
+} // namespace zinc
\ No newline at end of file
@@ -4,6 +4,10 @@
 #include "debug.h"
 #include "func.h"
 
+#include <new>
+#include <type_traits>
+#include <utility>
+
 namespace zinc {
 struct nullopt_t {
   struct init {};
@@ -12,6 +16,126 @@ struct nullopt_t {
 
 extern nullopt_t None;
 
+namespace details {
+// Where an option keeps its value. Each kind provides has_value(), get(),
+// construct(args...), which fills an empty one, and reset(). Nothing is
+// constructed for an empty option and a trivially copyable value keeps the
+// option trivially copyable.
+template <typename TValue, bool = niche_traits<TValue>::available,
+          bool = std::is_trivially_copyable<TValue>::value>
+struct option_storage;
+
+// a value and a flag
+template <typename TValue> struct option_storage<TValue, false, true> {
+  option_storage() noexcept : m_empty() {}
+
+  [[nodiscard]] auto has_value() const noexcept -> bool {
+    return m_has_value;
+  }
+  auto get() noexcept -> TValue & { return m_value; }
+  auto get() const noexcept -> TValue const & { return m_value; }
+
+  template <typename... TArgs> void construct(TArgs &&...args) {
+    new (&m_value) TValue(std::forward<TArgs>(args)...);
+    m_has_value = true;
+  }
+  void reset() noexcept { m_has_value = false; }
+
+  union {
+    char m_empty;
+    TValue m_value;
+  };
+  bool m_has_value = false;
+};
+
+// the same, running the value's constructors and destructor by hand
+template <typename TValue> struct option_storage<TValue, false, false> {
+  option_storage() noexcept : m_empty() {}
+
+  option_storage(option_storage const &other) : m_empty() {
+    if (other.m_has_value)
+      construct(other.m_value);
+  }
+  option_storage(option_storage &&other) noexcept(
+      std::is_nothrow_move_constructible<TValue>::value)
+      : m_empty() {
+    if (other.m_has_value)
+      construct(std::move(other.m_value));
+  }
+
+  auto operator=(option_storage const &other) -> option_storage & {
+    if (this != &other) {
+      if (m_has_value && other.m_has_value)
+        m_value = other.m_value;
+      else if (other.m_has_value)
+        construct(other.m_value);
+      else
+        reset();
+    }
+    return *this;
+  }
+  auto operator=(option_storage &&other) noexcept(
+      std::is_nothrow_move_constructible<TValue>::value &&
+      std::is_nothrow_move_assignable<TValue>::value) -> option_storage & {
+    if (this != &other) {
+      if (m_has_value && other.m_has_value)
+        m_value = std::move(other.m_value);
+      else if (other.m_has_value)
+        construct(std::move(other.m_value));
+      else
+        reset();
+    }
+    return *this;
+  }
+
+  ~option_storage() { reset(); }
+
+  [[nodiscard]] auto has_value() const noexcept -> bool {
+    return m_has_value;
+  }
+  auto get() noexcept -> TValue & { return m_value; }
+  auto get() const noexcept -> TValue const & { return m_value; }
+
+  template <typename... TArgs> void construct(TArgs &&...args) {
+    new (&m_value) TValue(std::forward<TArgs>(args)...);
+    m_has_value = true;
+  }
+  void reset() noexcept {
+    if (m_has_value) {
+      m_value.~TValue();
+      m_has_value = false;
+    }
+  }
+
+  union {
+    char m_empty;
+    TValue m_value;
+  };
+  bool m_has_value = false;
+};
+
+// only the value, holding the niche when empty
+template <typename TValue, bool trivial>
+struct option_storage<TValue, true, trivial> {
+  [[nodiscard]] auto has_value() const noexcept -> bool {
+    return !niche_traits<TValue>::is_none(m_value);
+  }
+  auto get() noexcept -> TValue & { return m_value; }
+  auto get() const noexcept -> TValue const & { return m_value; }
+
+  template <typename... TArgs> void construct(TArgs &&...args) {
+    m_value = TValue(std::forward<TArgs>(args)...);
+  }
+  void reset() noexcept { m_value = niche_traits<TValue>::none(); }
+
+  TValue m_value = niche_traits<TValue>::none();
+};
+} // namespace details
+
+// A value or None. Types with a niche_traits specialisation, pointers,
+// unique, shared and duration among them, store None as a value they never
+// otherwise hold and take no more room than the value itself; for those an
+// option holding a null pointer or an empty handle is None.
 template <typename TValue> struct option {
 public:
   template <typename TOtherValue> friend struct option;
@@ -19,60 +143,69 @@ public:
   option() noexcept = default;
   option(nullopt_t) noexcept {};
 
-  option(TValue &&value) : m_value(std::move(value)), m_has_value(true) {}
-  option(TValue const &value) : m_value(value), m_has_value(true) {}
+  option(TValue &&value) { m_storage.construct(std::move(value)); }
+  option(TValue const &value) { m_storage.construct(value); }
 
   template <typename TOtherValue, typename = safe_upcast<TOtherValue, TValue>>
   option(option<TOtherValue> &&other) {
     if (other.has_value())
-      m_value = std::move(other.m_value);
-    m_has_value = other.m_has_value;
+      m_storage.construct(std::move(other.m_storage.get()));
   }
   template <typename TOtherValue, typename = safe_upcast<TOtherValue, TValue>>
   option(option<TOtherValue> const &other) {
     if (other.has_value())
-      m_value = other.m_value;
-    m_has_value = other.m_has_value;
+      m_storage.construct(other.m_storage.get());
   }
 
-  [[nodiscard]] auto has_value() const noexcept -> bool { return m_has_value; }
+  [[nodiscard]] auto has_value() const noexcept -> bool {
+    return m_storage.has_value();
+  }
 
   [[nodiscard]] auto value() const & -> TValue const & {
     ZINC_ASSERT(has_value());
-    return m_value;
+    return m_storage.get();
   }
   [[nodiscard]] auto value() & -> TValue & {
     ZINC_ASSERT(has_value());
-    return m_value;
+    return m_storage.get();
   }
   [[nodiscard]] auto value() && -> TValue && {
     ZINC_ASSERT(has_value());
-    return std::move(m_value);
+    return std::move(m_storage.get());
   }
 
   [[nodiscard]] auto
   value_or(TValue const &default_value) const & -> TValue const & {
     if (has_value())
-      return m_value;
+      return m_storage.get();
     return default_value;
   }
   [[nodiscard]] auto value_or(TValue const &default_value) && -> TValue {
     if (has_value())
-      return std::move(m_value);
+      return std::move(m_storage.get());
     return default_value;
   }
   [[nodiscard]] auto
   value_or(TValue &&default_value) const & -> TValue const & {
     if (has_value())
-      return m_value;
+      return m_storage.get();
     return default_value;
   }
   [[nodiscard]] auto value_or(TValue &&default_value) && -> TValue {
     if (has_value())
-      return std::move(m_value);
+      return std::move(m_storage.get());
     return default_value;
   }
 
+  // replaces the value, or fills an empty option, with TValue(args...)
+  template <typename... TArgs> auto emplace(TArgs &&...args) -> TValue & {
+    reset();
+    m_storage.construct(std::forward<TArgs>(args)...);
+    return m_storage.get();
+  }
+
+  void reset() noexcept { m_storage.reset(); }
+
   template <typename TMapValue>
   [[nodiscard]] auto
   map(func<TMapValue(TValue const &)> &&func) const & -> option<TMapValue> {
@@ -84,12 +217,61 @@ public:
   operator bool() const noexcept { return has_value(); }
 
 private:
-  bool m_has_value{false};
-  TValue m_value;
+  // the value and its flag, or just the value where it has a niche; as a
+  // plain member an option<u32> comes back from a function in one register
+  details::option_storage<TValue> m_storage;
+};
+
+// A reference or None, as small as a pointer.
+template <typename TValue> struct option<TValue &> {
+public:
+  option() noexcept = default;
+  option(nullopt_t) noexcept {};
+  option(TValue &value) noexcept : m_value(&value) {}
+
+  [[nodiscard]] auto has_value() const noexcept -> bool {
+    return m_value != nullptr;
+  }
+
+  [[nodiscard]] auto value() const -> TValue & {
+    ZINC_ASSERT(has_value());
+    return *m_value;
+  }
+  [[nodiscard]] auto value_or(TValue &default_value) const -> TValue & {
+    return has_value() ? *m_value : default_value;
+  }
+
+  void reset() noexcept { m_value = nullptr; }
+
+  template <typename TMapValue>
+  [[nodiscard]] auto
+  map(func<TMapValue(TValue const &)> &&func) const -> option<TMapValue> {
+    if (has_value())
+      return option<TMapValue>(func(value()));
+    return None;
+  }
+
+  operator bool() const noexcept { return has_value(); }
+
+private:
+  TValue *m_value = nullptr;
 };
 
 template <typename TValue>
-[[nodiscard]] inline auto Some(TValue &&value) -> option<TValue> {
-  return option<TValue>(std::forward<TValue>(value));
+[[nodiscard]] inline auto Some(TValue &&value)
+    -> option<std::decay_t<TValue>> {
+  return option<std::decay_t<TValue>>(std::forward<TValue>(value));
 }
+
+// Gives the enum TEnum the niche none_value, a value none of its
+// enumerators have, so option<TEnum> is the size of TEnum. Use it at
+// global scope.
+#define ZINC_ENABLE_OPTION_NICHE(TEnum, none_value)                            \
+  template <> struct zinc::niche_traits<TEnum> {                               \
+    static constexpr bool available = true;                                    \
+    static constexpr auto none() noexcept -> TEnum { return none_value; }      \
+    static constexpr auto is_none(TEnum value) noexcept -> bool {              \
+      return value == none_value;                                              \
+    }                                                                          \
+  };
 } // namespace zinc
\ No newline at end of file
@@ -0,0 +1,383 @@
+#pragma once
+
+#include "base.h"
+#include "debug.h"
+#include "vector.h"
+
+#include <type_traits>
+#include <utility>
+
+namespace zinc {
+// Lazy ranges. Adaptors only hold their source and a callable, nothing is
+// computed until a terminal operation such as collect_into or for_each
+// walks the chain, and then every element goes through all the steps
+// before the next one is read. No temporary containers are made.
+//
+//   from(prices).map(with_tax).filter(over_limit).take(10).collect_into(out);
+//
+// Ranges are walked in two ways. Every range can push its elements into a
+// sink one at a time with walk, and the sink says whether it wants more.
+// Ranges that know their size and can produce element i directly, anything
+// without a filter in it, are also indexed, and terminal operations on
+// them run a plain counted loop the compiler can vectorise.
+//
+// A range refers to the container it came from and to nothing else, so
+// it must not outlive it.
+template <typename TSource, typename TFunc> class map_range;
+template <typename TSource, typename TPredicate> class filter_range;
+template <typename TFirst, typename TSecond> class zip_range;
+template <typename TSource> class enumerate_range;
+template <typename TSource> class stride_range;
+template <typename TSource> class take_range;
+
+// The adaptors and terminal operations every range has. TDerived provides
+// walk(sink), and when indexed is set also size() and at(i).
+template <typename TDerived> class range_base {
+public:
+  // f(element) in place of every element
+  template <typename TFunc> auto map(TFunc func) const {
+    return map_range<TDerived, TFunc>(derived(), std::move(func));
+  }
+
+  // only the elements predicate(element) holds for
+  template <typename TPredicate> auto filter(TPredicate predicate) const {
+    return filter_range<TDerived, TPredicate>(derived(),
+                                              std::move(predicate));
+  }
+
+  // std::pair of the elements at the same position in both, as long as the
+  // shorter one. Both have to be indexed.
+  template <typename TOther> auto zip(TOther const &other) const {
+    return zip_range<TDerived, TOther>(derived(), other);
+  }
+
+  // std::pair of the position and the element
+  auto enumerate() const { return enumerate_range<TDerived>(derived()); }
+
+  // every step-th element, starting with the first
+  auto stride(usize step) const {
+    ZINC_ASSERTF(step > 0, "range::stride: step must be positive");
+    return stride_range<TDerived>(derived(), step);
+  }
+
+  // the first count elements, or all of them when there are fewer
+  auto take(usize count) const {
+    return take_range<TDerived>(derived(), count);
+  }
+
+  // Calls func on every element in order. func can return false to stop
+  // early, otherwise it can return nothing.
+  template <typename TFunc> void for_each(TFunc &&func) const {
+    derived().walk([&](auto &&element) {
+      if constexpr (std::is_same<decltype(func(element)), void>::value) {
+        func(element);
+        return true;
+      } else {
+        return as<bool>(func(element));
+      }
+    });
+  }
+
+  // Appends every element to out. Indexed ranges grow out once and write
+  // the elements straight into it.
+  template <typename TValue, typename TAllocator>
+  auto collect_into(vector<TValue, TAllocator> &out) const
+      -> vector<TValue, TAllocator> & {
+    if constexpr (TDerived::indexed) {
+      auto const &source = derived();
+      auto const start = out.size();
+      auto const count = source.size();
+      out.resize(start + count);
+      auto *const target = out.data() + start;
+      for (usize i = 0; i < count; ++i)
+        target[i] = source.at(i);
+    } else {
+      derived().walk([&out](auto &&element) {
+        out.push_back(std::forward<decltype(element)>(element));
+        return true;
+      });
+    }
+    return out;
+  }
+
+  // the number of elements, which walks the range unless it is indexed
+  [[nodiscard]] auto count() const -> usize {
+    if constexpr (TDerived::indexed) {
+      return derived().size();
+    } else {
+      usize total = 0;
+      derived().walk([&total](auto &&) {
+        ++total;
+        return true;
+      });
+      return total;
+    }
+  }
+
+protected:
+  auto derived() const -> TDerived const & {
+    return static_cast<TDerived const &>(*this);
+  }
+};
+
+// Contiguous elements, what from() starts every chain with
+template <typename TValue>
+class source_range : public range_base<source_range<TValue>> {
+public:
+  static constexpr bool indexed = true;
+
+  source_range(TValue const *data, usize size) : m_data(data), m_size(size) {}
+
+  [[nodiscard]] auto size() const -> usize { return m_size; }
+  auto at(usize index) const -> TValue const & { return m_data[index]; }
+
+  template <typename TSink> auto walk(TSink &&sink) const -> bool {
+    for (usize i = 0; i < m_size; ++i)
+      if (!sink(m_data[i]))
+        return false;
+    return true;
+  }
+
+  // Consecutive array_views of size elements, the last one shorter when
+  // size does not divide the range. Only contiguous ranges can be cut up
+  // without copying, so this is not on the adaptors.
+  auto chunk(usize size) const;
+
+private:
+  TValue const *m_data;
+  usize m_size;
+};
+
+template <typename TValue>
+auto from(array_view<TValue> items) -> source_range<TValue> {
+  return source_range<TValue>(items.data(), items.size());
+}
+
+template <typename TValue, typename TAllocator>
+auto from(vector<TValue, TAllocator> const &items) -> source_range<TValue> {
+  return source_range<TValue>(items.data(), items.size());
+}
+
+template <typename TValue>
+auto from(TValue const *data, usize size) -> source_range<TValue> {
+  return source_range<TValue>(data, size);
+}
+
+template <typename TValue>
+class chunk_range : public range_base<chunk_range<TValue>> {
+public:
+  static constexpr bool indexed = true;
+
+  chunk_range(TValue const *data, usize size, usize chunk)
+      : m_data(data), m_size(size), m_chunk(chunk) {}
+
+  [[nodiscard]] auto size() const -> usize {
+    return (m_size + m_chunk - 1) / m_chunk;
+  }
+  auto at(usize index) const -> array_view<TValue> {
+    auto const start = index * m_chunk;
+    auto const left = m_size - start;
+    return array_view<TValue>(m_data + start,
+                              left < m_chunk ? left : m_chunk);
+  }
+
+  template <typename TSink> auto walk(TSink &&sink) const -> bool {
+    auto const count = size();
+    for (usize i = 0; i < count; ++i)
+      if (!sink(at(i)))
+        return false;
+    return true;
+  }
+
+private:
+  TValue const *m_data;
+  usize m_size;
+  usize m_chunk;
+};
+
+template <typename TValue>
+auto source_range<TValue>::chunk(usize size) const {
+  ZINC_ASSERTF(size > 0, "range::chunk: size must be positive");
+  return chunk_range<TValue>(m_data, m_size, size);
+}
+
+template <typename TSource, typename TFunc>
+class map_range : public range_base<map_range<TSource, TFunc>> {
+public:
+  static constexpr bool indexed = TSource::indexed;
+
+  map_range(TSource const &source, TFunc func)
+      : m_source(source), m_func(std::move(func)) {}
+
+  [[nodiscard]] auto size() const -> usize { return m_source.size(); }
+  auto at(usize index) const -> decltype(auto) {
+    return m_func(m_source.at(index));
+  }
+
+  template <typename TSink> auto walk(TSink &&sink) const -> bool {
+    return m_source.walk(
+        [&](auto &&element) { return sink(m_func(element)); });
+  }
+
+private:
+  TSource m_source;
+  TFunc m_func;
+};
+
+template <typename TSource, typename TPredicate>
+class filter_range : public range_base<filter_range<TSource, TPredicate>> {
+public:
+  static constexpr bool indexed = false;
+
+  filter_range(TSource const &source, TPredicate predicate)
+      : m_source(source), m_predicate(std::move(predicate)) {}
+
+  template <typename TSink> auto walk(TSink &&sink) const -> bool {
+    return m_source.walk([&](auto &&element) {
+      return m_predicate(element) ? sink(element) : true;
+    });
+  }
+
+private:
+  TSource m_source;
+  TPredicate m_predicate;
+};
+
+template <typename TFirst, typename TSecond>
+class zip_range : public range_base<zip_range<TFirst, TSecond>> {
+  static_assert(TFirst::indexed && TSecond::indexed,
+                "zip needs ranges without a filter in them");
+
+public:
+  static constexpr bool indexed = true;
+
+  zip_range(TFirst const &first, TSecond const &second)
+      : m_first(first), m_second(second) {}
+
+  [[nodiscard]] auto size() const -> usize {
+    return m_first.size() < m_second.size() ? m_first.size()
+                                            : m_second.size();
+  }
+  auto at(usize index) const {
+    return std::make_pair(m_first.at(index), m_second.at(index));
+  }
+
+  template <typename TSink> auto walk(TSink &&sink) const -> bool {
+    auto const count = size();
+    for (usize i = 0; i < count; ++i)
+      if (!sink(at(i)))
+        return false;
+    return true;
+  }
+
+private:
+  TFirst m_first;
+  TSecond m_second;
+};
+
+template <typename TSource>
+class enumerate_range : public range_base<enumerate_range<TSource>> {
+public:
+  static constexpr bool indexed = TSource::indexed;
+
+  explicit enumerate_range(TSource const &source) : m_source(source) {}
+
+  [[nodiscard]] auto size() const -> usize { return m_source.size(); }
+  auto at(usize index) const {
+    return std::make_pair(index, m_source.at(index));
+  }
+
+  template <typename TSink> auto walk(TSink &&sink) const -> bool {
+    usize index = 0;
+    return m_source.walk([&](auto &&element) {
+      return sink(std::make_pair(index++, element));
+    });
+  }
+
+private:
+  TSource m_source;
+};
+
+template <typename TSource>
+class stride_range : public range_base<stride_range<TSource>> {
+public:
+  static constexpr bool indexed = TSource::indexed;
+
+  stride_range(TSource const &source, usize step)
+      : m_source(source), m_step(step) {}
+
+  [[nodiscard]] auto size() const -> usize {
+    return (m_source.size() + m_step - 1) / m_step;
+  }
+  auto at(usize index) const -> decltype(auto) {
+    return m_source.at(index * m_step);
+  }
+
+  template <typename TSink> auto walk(TSink &&sink) const -> bool {
+    if constexpr (indexed) {
+      auto const count = size();
+      for (usize i = 0; i < count; ++i)
+        if (!sink(at(i)))
+          return false;
+      return true;
+    } else {
+      usize skip = 0;
+      return m_source.walk([&](auto &&element) {
+        if (skip) {
+          --skip;
+          return true;
+        }
+        skip = m_step - 1;
+        return sink(element);
+      });
+    }
+  }
+
+private:
+  TSource m_source;
+  usize m_step;
+};
+
+template <typename TSource>
+class take_range : public range_base<take_range<TSource>> {
+public:
+  static constexpr bool indexed = TSource::indexed;
+
+  take_range(TSource const &source, usize count)
+      : m_source(source), m_count(count) {}
+
+  [[nodiscard]] auto size() const -> usize {
+    return m_source.size() < m_count ? m_source.size() : m_count;
+  }
+  auto at(usize index) const -> decltype(auto) { return m_source.at(index); }
+
+  template <typename TSink> auto walk(TSink &&sink) const -> bool {
+    if constexpr (indexed) {
+      auto const count = size();
+      for (usize i = 0; i < count; ++i)
+        if (!sink(at(i)))
+          return false;
+      return true;
+    } else {
+      if (m_count == 0)
+        return true;
+      auto left = m_count;
+      // the source stopping early because this has all it wants is not the
+      // sink asking to stop
+      auto stopped = false;
+      m_source.walk([&](auto &&element) {
+        if (!sink(element)) {
+          stopped = true;
+          return false;
+        }
+        return --left != 0;
+      });
+      return !stopped;
+    }
+  }
+
+private:
+  TSource m_source;
+  usize m_count;
+};
+} // namespace zinc
\ No newline at end of file
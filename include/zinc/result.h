@@ -0,0 +1,414 @@
+#pragma once
+
+#include "base.h"
+#include "debug.h"
+#include "unit.h"
+
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace zinc {
+// What Ok(value) and Err(error) make, convertible to any result whose value
+// or error can be built from them.
+template <typename TValue> struct ok_t {
+  TValue m_value;
+};
+template <typename TError> struct err_t {
+  TError m_error;
+};
+
+template <typename TValue>
+[[nodiscard]] inline auto Ok(TValue &&value) -> ok_t<std::decay_t<TValue>> {
+  return {std::forward<TValue>(value)};
+}
+[[nodiscard]] inline auto Ok() -> ok_t<Unit> { return {Unit()}; }
+
+template <typename TError>
+[[nodiscard]] inline auto Err(TError &&error) -> err_t<std::decay_t<TError>> {
+  return {std::forward<TError>(error)};
+}
+
+namespace details {
+struct in_value_t {};
+struct in_error_t {};
+
+enum class result_layout : u8 {
+  // a union of the two and a flag saying which one is there
+  tagged,
+  // the same, copied as bytes
+  trivial_tagged,
+  // an empty value and an error holding its niche on success
+  niche_in_error,
+  // an empty error and a value holding its niche on failure
+  niche_in_value,
+};
+
+template <typename TValue, typename TError>
+constexpr auto choose_result_layout() -> result_layout {
+  if constexpr (std::is_empty<TValue>::value &&
+                !std::is_final<TValue>::value &&
+                niche_traits<TError>::available)
+    return result_layout::niche_in_error;
+  else if constexpr (std::is_empty<TError>::value &&
+                     !std::is_final<TError>::value &&
+                     niche_traits<TValue>::available)
+    return result_layout::niche_in_value;
+  else if constexpr (std::is_trivially_copyable<TValue>::value &&
+                     std::is_trivially_copyable<TError>::value)
+    return result_layout::trivial_tagged;
+  else
+    return result_layout::tagged;
+}
+
+// Each layout is built holding one side and provides has_value(),
+// get_value() and get_error().
+template <typename TValue, typename TError,
+          result_layout = choose_result_layout<TValue, TError>()>
+struct result_storage;
+
+template <typename TValue, typename TError>
+struct result_storage<TValue, TError, result_layout::trivial_tagged> {
+  template <typename... TArgs>
+  result_storage(in_value_t, TArgs &&...args)
+      : m_value(std::forward<TArgs>(args)...), m_has_value(true) {}
+  template <typename... TArgs>
+  result_storage(in_error_t, TArgs &&...args)
+      : m_error(std::forward<TArgs>(args)...), m_has_value(false) {}
+
+  [[nodiscard]] auto has_value() const noexcept -> bool {
+    return m_has_value;
+  }
+  auto get_value() noexcept -> TValue & { return m_value; }
+  auto get_value() const noexcept -> TValue const & { return m_value; }
+  auto get_error() noexcept -> TError & { return m_error; }
+  auto get_error() const noexcept -> TError const & { return m_error; }
+
+  union {
+    TValue m_value;
+    TError m_error;
+  };
+  bool m_has_value;
+};
+
+template <typename TValue, typename TError>
+struct result_storage<TValue, TError, result_layout::tagged> {
+  template <typename... TArgs>
+  result_storage(in_value_t, TArgs &&...args)
+      : m_value(std::forward<TArgs>(args)...), m_has_value(true) {}
+  template <typename... TArgs>
+  result_storage(in_error_t, TArgs &&...args)
+      : m_error(std::forward<TArgs>(args)...), m_has_value(false) {}
+
+  result_storage(result_storage const &other) { construct_from(other); }
+  result_storage(result_storage &&other) noexcept(
+      std::is_nothrow_move_constructible<TValue>::value &&
+      std::is_nothrow_move_constructible<TError>::value) {
+    construct_from(std::move(other));
+  }
+
+  auto operator=(result_storage const &other) -> result_storage & {
+    if (this != &other)
+      assign_from(other);
+    return *this;
+  }
+  auto operator=(result_storage &&other) noexcept(
+      std::is_nothrow_move_constructible<TValue>::value &&
+      std::is_nothrow_move_constructible<TError>::value &&
+      std::is_nothrow_move_assignable<TValue>::value &&
+      std::is_nothrow_move_assignable<TError>::value) -> result_storage & {
+    if (this != &other)
+      assign_from(std::move(other));
+    return *this;
+  }
+
+  ~result_storage() { destroy(); }
+
+  [[nodiscard]] auto has_value() const noexcept -> bool {
+    return m_has_value;
+  }
+  auto get_value() noexcept -> TValue & { return m_value; }
+  auto get_value() const noexcept -> TValue const & { return m_value; }
+  auto get_error() noexcept -> TError & { return m_error; }
+  auto get_error() const noexcept -> TError const & { return m_error; }
+
+  // fills this, which holds nothing, with what other holds
+  template <typename TOther> void construct_from(TOther &&other) {
+    if (other.m_has_value)
+      new (&m_value) TValue(std::forward<TOther>(other).m_value);
+    else
+      new (&m_error) TError(std::forward<TOther>(other).m_error);
+    m_has_value = other.m_has_value;
+  }
+
+  // If copying or moving throws, this still holds what it held before.
+  template <typename TOther> void assign_from(TOther &&other) {
+    if (m_has_value && other.m_has_value) {
+      m_value = std::forward<TOther>(other).m_value;
+    } else if (!m_has_value && !other.m_has_value) {
+      m_error = std::forward<TOther>(other).m_error;
+    } else if (other.m_has_value) {
+      replace(m_error, m_value, std::forward<TOther>(other).m_value);
+      m_has_value = true;
+    } else {
+      replace(m_value, m_error, std::forward<TOther>(other).m_error);
+      m_has_value = false;
+    }
+  }
+
+  // Swaps old for a TNew built from source. The new side is built aside
+  // first when that can throw, and old is put back if even the move into
+  // place can.
+  template <typename TOld, typename TNew, typename TSource>
+  static void replace(TOld &old, TNew &fresh, TSource &&source) {
+    if constexpr (std::is_nothrow_constructible<TNew, TSource &&>::value) {
+      old.~TOld();
+      new (&fresh) TNew(std::forward<TSource>(source));
+    } else if constexpr (std::is_nothrow_move_constructible<TNew>::value) {
+      TNew built(std::forward<TSource>(source));
+      old.~TOld();
+      new (&fresh) TNew(std::move(built));
+    } else {
+      static_assert(std::is_nothrow_move_constructible<TOld>::value,
+                    "one side of a result must move without throwing");
+      TOld kept(std::move(old));
+      old.~TOld();
+      try {
+        new (&fresh) TNew(std::forward<TSource>(source));
+      } catch (...) {
+        new (&old) TOld(std::move(kept));
+        throw;
+      }
+    }
+  }
+
+  void destroy() noexcept {
+    if (m_has_value)
+      m_value.~TValue();
+    else
+      m_error.~TError();
+  }
+
+  union {
+    TValue m_value;
+    TError m_error;
+  };
+  bool m_has_value;
+};
+
+// the empty value is a base so it takes no room
+template <typename TValue, typename TError>
+struct result_storage<TValue, TError, result_layout::niche_in_error>
+    : private TValue {
+  template <typename... TArgs>
+  result_storage(in_value_t, TArgs &&...args)
+      : TValue(std::forward<TArgs>(args)...),
+        m_error(niche_traits<TError>::none()) {}
+  template <typename... TArgs>
+  result_storage(in_error_t, TArgs &&...args)
+      : m_error(std::forward<TArgs>(args)...) {}
+
+  [[nodiscard]] auto has_value() const noexcept -> bool {
+    return niche_traits<TError>::is_none(m_error);
+  }
+  auto get_value() noexcept -> TValue & { return *this; }
+  auto get_value() const noexcept -> TValue const & { return *this; }
+  auto get_error() noexcept -> TError & { return m_error; }
+  auto get_error() const noexcept -> TError const & { return m_error; }
+
+  TError m_error;
+};
+
+template <typename TValue, typename TError>
+struct result_storage<TValue, TError, result_layout::niche_in_value>
+    : private TError {
+  template <typename... TArgs>
+  result_storage(in_value_t, TArgs &&...args)
+      : m_value(std::forward<TArgs>(args)...) {}
+  template <typename... TArgs>
+  result_storage(in_error_t, TArgs &&...args)
+      : TError(std::forward<TArgs>(args)...),
+        m_value(niche_traits<TValue>::none()) {}
+
+  [[nodiscard]] auto has_value() const noexcept -> bool {
+    return !niche_traits<TValue>::is_none(m_value);
+  }
+  auto get_value() noexcept -> TValue & { return m_value; }
+  auto get_value() const noexcept -> TValue const & { return m_value; }
+  auto get_error() noexcept -> TError & { return *this; }
+  auto get_error() const noexcept -> TError const & { return *this; }
+
+  TValue m_value;
+};
+
+// calls func(args...) and wraps what it returns in ok_t, Unit when nothing
+template <typename TFunc, typename... TArgs>
+inline auto invoke_ok(TFunc &&func, TArgs &&...args) {
+  if constexpr (std::is_void<std::invoke_result_t<TFunc, TArgs...>>::value) {
+    std::forward<TFunc>(func)(std::forward<TArgs>(args)...);
+    return Ok();
+  } else {
+    return Ok(std::forward<TFunc>(func)(std::forward<TArgs>(args)...));
+  }
+}
+} // namespace details
+
+// A value or the error that kept it from being made, for code that cannot
+// afford to unwind an exception. Checking one is a branch on a flag, and
+// the combinators take their callables as template arguments, so nothing
+// allocates and everything inlines.
+//
+// When one side is an empty type and the other has a niche_traits value,
+// the flag is folded into that niche: result<Unit, errc> with an enum that
+// has one is the size of errc. As with option, a value holding its own
+// niche reads as the other side.
+template <typename TValue, typename TError>
+class [[nodiscard]] result {
+public:
+  using value_type = TValue;
+  using error_type = TError;
+
+  template <typename TOther>
+  result(ok_t<TOther> &&ok)
+      : m_storage(details::in_value_t(), std::move(ok.m_value)) {}
+  template <typename TOther>
+  result(err_t<TOther> &&err)
+      : m_storage(details::in_error_t(), std::move(err.m_error)) {}
+
+  [[nodiscard]] auto has_value() const noexcept -> bool {
+    return m_storage.has_value();
+  }
+  [[nodiscard]] auto has_error() const noexcept -> bool {
+    return !m_storage.has_value();
+  }
+  explicit operator bool() const noexcept { return has_value(); }
+
+  [[nodiscard]] auto value() const & -> TValue const & {
+    ZINC_ASSERTF(has_value(), "result::value: holds an error");
+    return m_storage.get_value();
+  }
+  [[nodiscard]] auto value() & -> TValue & {
+    ZINC_ASSERTF(has_value(), "result::value: holds an error");
+    return m_storage.get_value();
+  }
+  [[nodiscard]] auto value() && -> TValue && {
+    ZINC_ASSERTF(has_value(), "result::value: holds an error");
+    return std::move(m_storage.get_value());
+  }
+
+  [[nodiscard]] auto error() const & -> TError const & {
+    ZINC_ASSERTF(has_error(), "result::error: holds a value");
+    return m_storage.get_error();
+  }
+  [[nodiscard]] auto error() & -> TError & {
+    ZINC_ASSERTF(has_error(), "result::error: holds a value");
+    return m_storage.get_error();
+  }
+  [[nodiscard]] auto error() && -> TError && {
+    ZINC_ASSERTF(has_error(), "result::error: holds a value");
+    return std::move(m_storage.get_error());
+  }
+
+  [[nodiscard]] auto value_or(TValue default_value) const & -> TValue {
+    return has_value() ? m_storage.get_value() : std::move(default_value);
+  }
+  [[nodiscard]] auto value_or(TValue default_value) && -> TValue {
+    return has_value() ? std::move(m_storage.get_value())
+                       : std::move(default_value);
+  }
+
+  // result<func(value), TError>
+  template <typename TFunc> auto map(TFunc &&func) const & {
+    using mapped = decltype(details::invoke_ok(std::forward<TFunc>(func),
+                                               m_storage.get_value()));
+    using output = result<decltype(mapped::m_value), TError>;
+    if (has_value())
+      return output(
+          details::invoke_ok(std::forward<TFunc>(func), m_storage.get_value()));
+    return output(Err(m_storage.get_error()));
+  }
+  template <typename TFunc> auto map(TFunc &&func) && {
+    using mapped = decltype(details::invoke_ok(
+        std::forward<TFunc>(func), std::move(m_storage.get_value())));
+    using output = result<decltype(mapped::m_value), TError>;
+    if (has_value())
+      return output(details::invoke_ok(std::forward<TFunc>(func),
+                                       std::move(m_storage.get_value())));
+    return output(Err(std::move(m_storage.get_error())));
+  }
+
+  // result<TValue, func(error)>
+  template <typename TFunc> auto map_error(TFunc &&func) const & {
+    using mapped = std::decay_t<std::invoke_result_t<TFunc, TError const &>>;
+    using output = result<TValue, mapped>;
+    if (has_value())
+      return output(Ok(m_storage.get_value()));
+    return output(Err(std::forward<TFunc>(func)(m_storage.get_error())));
+  }
+  template <typename TFunc> auto map_error(TFunc &&func) && {
+    using mapped = std::decay_t<std::invoke_result_t<TFunc, TError &&>>;
+    using output = result<TValue, mapped>;
+    if (has_value())
+      return output(Ok(std::move(m_storage.get_value())));
+    return output(
+        Err(std::forward<TFunc>(func)(std::move(m_storage.get_error()))));
+  }
+
+  // func(value), itself a result with the same error type
+  template <typename TFunc> auto and_then(TFunc &&func) const & {
+    using output = std::decay_t<std::invoke_result_t<TFunc, TValue const &>>;
+    if (has_value())
+      return output(std::forward<TFunc>(func)(m_storage.get_value()));
+    return output(Err(m_storage.get_error()));
+  }
+  template <typename TFunc> auto and_then(TFunc &&func) && {
+    using output = std::decay_t<std::invoke_result_t<TFunc, TValue &&>>;
+    if (has_value())
+      return output(
+          std::forward<TFunc>(func)(std::move(m_storage.get_value())));
+    return output(Err(std::move(m_storage.get_error())));
+  }
+
+  // func(error), itself a result with the same value type, which can
+  // recover from the error or replace it
+  template <typename TFunc> auto or_else(TFunc &&func) const & {
+    using output = std::decay_t<std::invoke_result_t<TFunc, TError const &>>;
+    if (has_value())
+      return output(Ok(m_storage.get_value()));
+    return output(std::forward<TFunc>(func)(m_storage.get_error()));
+  }
+  template <typename TFunc> auto or_else(TFunc &&func) && {
+    using output = std::decay_t<std::invoke_result_t<TFunc, TError &&>>;
+    if (has_value())
+      return output(Ok(std::move(m_storage.get_value())));
+    return output(std::forward<TFunc>(func)(std::move(m_storage.get_error())));
+  }
+
+private:
+  // a member rather than a base, which compilers keep in registers
+  details::result_storage<TValue, TError> m_storage;
+};
+
+#define ZINC_TRY_CONCAT_(a, b) a##b
+#define ZINC_TRY_CONCAT(a, b) ZINC_TRY_CONCAT_(a, b)
+#define ZINC_TRY_WITH(decl, expr, name)                                       \
+  auto name = (expr);                                                         \
+  if (!name.has_value())                                                      \
+    return ::zinc::Err(std::move(name).error());                              \
+  decl = std::move(name).value()
+
+// Evaluates expr, a result, and returns its error from the enclosing
+// function when it has one; otherwise declares decl with its value:
+//
+//   ZINC_TRY(auto port, parse_port(text));
+#define ZINC_TRY(decl, expr)                                                  \
+  ZINC_TRY_WITH(decl, expr, ZINC_TRY_CONCAT(zinc_try_, __COUNTER__))
+
+// ZINC_TRY for results whose value is not needed
+#define ZINC_TRY_VOID(expr)                                                   \
+  do {                                                                        \
+    auto zinc_try_result = (expr);                                            \
+    if (!zinc_try_result.has_value())                                         \
+      return ::zinc::Err(std::move(zinc_try_result).error());                 \
+  } while (0)
+} // namespace zinc
\ No newline at end of file
@@ -0,0 +1,326 @@
+#pragma once
+
+#include "base.h"
+#include "bits.h"
+#include "cpu.h"
+#include "debug.h"
+#include "vector.h"
+
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#if ZINC_CPU_X86 && ZINC_ARCH_64BIT
+#include <emmintrin.h>
+#endif
+
+namespace zinc {
+namespace details {
+constexpr usize cache_line = 64;
+
+template <typename TValue>
+inline auto allocate_lines(usize count) -> TValue * {
+  return static_cast<TValue *>(::operator new(
+      count * sizeof(TValue), std::align_val_t(cache_line)));
+}
+
+template <typename TValue>
+inline void free_lines(TValue *values) noexcept {
+  ::operator delete(values, std::align_val_t(cache_line));
+}
+
+// How many of the size sorted values at values come before key, where
+// before is value < key for a lower bound and !(key < value) for an upper
+// one. A branchless binary search inside the node.
+template <usize size, bool upper, typename TValue, typename TKey,
+          typename TCompare>
+inline auto node_rank(TValue const *values, TKey const &key,
+                      TCompare &compare) -> usize {
+  auto const before = [&](TValue const &value) {
+    return upper ? !compare(key, value) : compare(value, key);
+  };
+  usize rank = 0;
+  for (usize left = size; left > 1; left -= left / 2)
+    rank = before(values[rank + left / 2]) ? rank + left / 2 : rank;
+  return rank + before(values[rank]);
+}
+
+#if ZINC_CPU_X86 && ZINC_ARCH_64BIT
+// Nodes of 32-bit keys are a cache line of four SSE2 vectors, which every
+// x86-64 processor has. Each comparison leaves -1 in the lanes before the
+// key and the negated sum of them is the rank.
+template <typename TValue>
+constexpr bool has_vector_rank = std::is_same<TValue, i32>::value ||
+                                 std::is_same<TValue, u32>::value ||
+                                 std::is_same<TValue, f32>::value;
+
+inline auto negated_rank(__m128i a, __m128i b, __m128i c, __m128i d)
+    -> usize {
+  auto sums = _mm_add_epi32(_mm_add_epi32(a, b), _mm_add_epi32(c, d));
+  sums = _mm_add_epi32(sums, _mm_shuffle_epi32(sums, 0x4E));
+  sums = _mm_add_epi32(sums, _mm_shuffle_epi32(sums, 0xB1));
+  return as<usize>(-_mm_cvtsi128_si32(sums));
+}
+
+template <bool upper, typename TValue>
+inline auto vector_rank(TValue const *values, TValue key) -> usize {
+  if constexpr (std::is_same<TValue, f32>::value) {
+    auto const *lanes = reinterpret_cast<__m128 const *>(values);
+    auto const splat = _mm_set1_ps(key);
+    auto const compare = [&](usize i) {
+      return _mm_castps_si128(upper ? _mm_cmpnlt_ps(splat, lanes[i])
+                                    : _mm_cmplt_ps(lanes[i], splat));
+    };
+    return negated_rank(compare(0), compare(1), compare(2), compare(3));
+  } else {
+    // unsigned keys compare as signed once their top bits are flipped
+    auto const bias = _mm_set1_epi32(std::is_signed<TValue>::value
+                                         ? 0
+                                         : as<i32>(0x80000000u));
+    auto const *lanes = reinterpret_cast<__m128i const *>(values);
+    auto const splat = _mm_xor_si128(_mm_set1_epi32(as<i32>(key)), bias);
+    auto const compare = [&](usize i) {
+      auto const value = _mm_xor_si128(lanes[i], bias);
+      // a value is at most the key when it is not greater, so count those
+      // that are greater and flip the lanes
+      return upper ? _mm_andnot_si128(_mm_cmpgt_epi32(value, splat),
+                                      _mm_set1_epi32(-1))
+                   : _mm_cmpgt_epi32(splat, value);
+    };
+    return negated_rank(compare(0), compare(1), compare(2), compare(3));
+  }
+}
+#else
+template <typename TValue> constexpr bool has_vector_rank = false;
+#endif
+} // namespace details
+
+// A sorted array laid out the way a binary search visits it, in breadth
+// first order: the root at 1, the children of k at 2k and 2k + 1. The
+// first levels share a few cache lines that stay hot, and the 16 or so
+// candidates four levels below k sit next to each other, so they are
+// prefetched with one line while the levels in between are compared.
+// Lookups give pointers into the index, sorted positions are not kept.
+template <typename TValue, typename TCompare = std::less<TValue>>
+class eytzinger_index : non_copyable {
+public:
+  // sorted must already be in order under compare
+  explicit eytzinger_index(array_view<TValue> sorted,
+                           TCompare compare = TCompare())
+      : m_values(details::allocate_lines<TValue>(sorted.size() + 1)),
+        m_size(sorted.size()), m_compare(compare) {
+    usize next = 0;
+    build(sorted.data(), next, 1);
+  }
+
+  eytzinger_index(eytzinger_index &&other) noexcept
+      : m_values(std::exchange(other.m_values, nullptr)),
+        m_size(std::exchange(other.m_size, 0)), m_compare(other.m_compare) {}
+
+  auto operator=(eytzinger_index &&other) noexcept -> eytzinger_index & {
+    if (this != &other) {
+      release();
+      m_values = std::exchange(other.m_values, nullptr);
+      m_size = std::exchange(other.m_size, 0);
+      m_compare = other.m_compare;
+    }
+    return *this;
+  }
+
+  ~eytzinger_index() { release(); }
+
+  // the first value not less than key, nullptr when there is none
+  template <typename TKey>
+  [[nodiscard]] auto lower_bound(TKey const &key) const -> TValue const * {
+    usize k = 1;
+    while (k <= m_size) {
+      prefetch(m_values + k * prefetch_stride);
+      k = 2 * k + m_compare(m_values[k], key);
+    }
+    return resolve(k);
+  }
+
+  // the first value greater than key, nullptr when there is none
+  template <typename TKey>
+  [[nodiscard]] auto upper_bound(TKey const &key) const -> TValue const * {
+    usize k = 1;
+    while (k <= m_size) {
+      prefetch(m_values + k * prefetch_stride);
+      k = 2 * k + !m_compare(key, m_values[k]);
+    }
+    return resolve(k);
+  }
+
+  template <typename TKey>
+  [[nodiscard]] auto contains(TKey const &key) const -> bool {
+    auto const *found = lower_bound(key);
+    return found && !m_compare(key, *found);
+  }
+
+  [[nodiscard]] auto size() const -> usize { return m_size; }
+  [[nodiscard]] auto empty() const -> bool { return m_size == 0; }
+
+private:
+  // how far k moves in four levels is one cache line of values
+  static constexpr usize prefetch_stride =
+      sizeof(TValue) < details::cache_line ? details::cache_line /
+                                                 sizeof(TValue)
+                                           : 1;
+
+  void build(TValue const *sorted, usize &next, usize k) {
+    if (k > m_size)
+      return;
+    build(sorted, next, 2 * k);
+    new (m_values + k) TValue(sorted[next++]);
+    build(sorted, next, 2 * k + 1);
+  }
+
+  // The walk went right every time it passed a value less than key, and
+  // left once at the answer. Dropping those trailing right turns and the
+  // left one gets back to it, and to 0 when it never went left.
+  auto resolve(usize k) const -> TValue const * {
+    k >>= count_trailing_zeros(~k) + 1;
+    return k ? m_values + k : nullptr;
+  }
+
+  void release() noexcept {
+    if (!m_values)
+      return;
+    if constexpr (!std::is_trivially_destructible<TValue>::value) {
+      for (usize k = 1; k <= m_size; ++k)
+        m_values[k].~TValue();
+    }
+    details::free_lines(m_values);
+    m_values = nullptr;
+  }
+
+  TValue *m_values;
+  usize m_size;
+  TCompare m_compare;
+};
+
+// The same idea with a cache line per node instead of a value: a static
+// B-tree whose nodes hold 64 / sizeof(TValue) sorted values and sit in
+// breadth first order, the children of node k at k * (B + 1) + 1 onwards.
+// A lookup touches one line per level, so it does a few times fewer
+// dependent loads than the binary layout, and 32-bit keys compare a whole
+// node at once with vector instructions. The slots left over when the
+// tree is not full are the last ones in sorted order, wherever they fall
+// among the nodes, and hold copies of the greatest value, which come after
+// the real one so a lookup never returns them.
+template <typename TValue, typename TCompare = std::less<TValue>>
+class btree_index : non_copyable {
+public:
+  static constexpr usize node_size =
+      sizeof(TValue) * 2 <= details::cache_line
+          ? details::cache_line / sizeof(TValue)
+          : 2;
+
+  // sorted must already be in order under compare
+  explicit btree_index(array_view<TValue> sorted,
+                       TCompare compare = TCompare())
+      : m_nodes((sorted.size() + node_size - 1) / node_size),
+        m_values(m_nodes ? details::allocate_lines<TValue>(m_nodes *
+                                                           node_size)
+                         : nullptr),
+        m_size(sorted.size()), m_compare(compare) {
+    usize next = 0;
+    build(sorted.data(), next, 0);
+  }
+
+  btree_index(btree_index &&other) noexcept
+      : m_nodes(std::exchange(other.m_nodes, 0)),
+        m_values(std::exchange(other.m_values, nullptr)),
+        m_size(std::exchange(other.m_size, 0)), m_compare(other.m_compare) {}
+
+  auto operator=(btree_index &&other) noexcept -> btree_index & {
+    if (this != &other) {
+      release();
+      m_nodes = std::exchange(other.m_nodes, 0);
+      m_values = std::exchange(other.m_values, nullptr);
+      m_size = std::exchange(other.m_size, 0);
+      m_compare = other.m_compare;
+    }
+    return *this;
+  }
+
+  ~btree_index() { release(); }
+
+  // the first value not less than key, nullptr when there is none
+  template <typename TKey>
+  [[nodiscard]] auto lower_bound(TKey const &key) const -> TValue const * {
+    return search<false>(key);
+  }
+
+  // the first value greater than key, nullptr when there is none
+  template <typename TKey>
+  [[nodiscard]] auto upper_bound(TKey const &key) const -> TValue const * {
+    return search<true>(key);
+  }
+
+  template <typename TKey>
+  [[nodiscard]] auto contains(TKey const &key) const -> bool {
+    auto const *found = lower_bound(key);
+    return found && !m_compare(key, *found);
+  }
+
+  [[nodiscard]] auto size() const -> usize { return m_size; }
+  [[nodiscard]] auto empty() const -> bool { return m_size == 0; }
+
+private:
+  static auto child(usize node, usize branch) -> usize {
+    return node * (node_size + 1) + branch + 1;
+  }
+
+  void build(TValue const *sorted, usize &next, usize node) {
+    if (node >= m_nodes)
+      return;
+    for (usize i = 0; i < node_size; ++i) {
+      build(sorted, next, child(node, i));
+      new (m_values + node * node_size + i)
+          TValue(next < m_size ? sorted[next++] : sorted[m_size - 1]);
+    }
+    build(sorted, next, child(node, node_size));
+  }
+
+  // The rank of the key in each node is the best answer so far when it is
+  // inside the node, and the child to go down to either way.
+  template <bool upper, typename TKey>
+  auto search(TKey const &key) const -> TValue const * {
+    constexpr bool vectorised =
+        details::has_vector_rank<TValue> && node_size == 16 &&
+        std::is_same<TCompare, std::less<TValue>>::value;
+    TValue const *found = nullptr;
+    usize node = 0;
+    while (node < m_nodes) {
+      auto const *values = m_values + node * node_size;
+      usize rank;
+      if constexpr (vectorised)
+        rank = details::vector_rank<upper>(values, as<TValue>(key));
+      else
+        rank = details::node_rank<node_size, upper>(values, key, m_compare);
+      if (rank < node_size)
+        found = values + rank;
+      node = child(node, rank);
+    }
+    return found;
+  }
+
+  void release() noexcept {
+    if (!m_values)
+      return;
+    if constexpr (!std::is_trivially_destructible<TValue>::value) {
+      for (usize i = 0; i < m_nodes * node_size; ++i)
+        m_values[i].~TValue();
+    }
+    details::free_lines(m_values);
+    m_values = nullptr;
+  }
+
+  usize m_nodes;
+  TValue *m_values;
+  usize m_size;
+  TCompare m_compare;
+};
+} // namespace zinc
\ No newline at end of file
@@ -1,126 +1,497 @@
 #pragma once
 
+#include "zinc/allocator/prelude.h"
 #include "zinc/base.h"
 
 namespace zinc {
-struct shared_count {
-  shared_count() = default;
-  shared_count(shared_count const &count) {
-    m_count.store(count.m_count.load());
-  }
+// Counting policies for shared. Counts start at zero, the first handle
+// acquires, and release() returns false once the last reference is gone.
+// try_acquire() only succeeds while the count is still alive, weak handles
+// use it to upgrade.
 
+// plain counter for objects that never leave the thread that created them
+struct local_count {
   [[nodiscard]] auto use_count() const noexcept -> usize { return m_count; }
 
   auto acquire() noexcept -> void { ++m_count; }
-  auto release() noexcept -> bool {
-    --m_count;
-    return m_count != 0;
+  auto try_acquire() noexcept -> bool {
+    if (m_count == 0)
+      return false;
+    ++m_count;
+    return true;
+  }
+  auto release() noexcept -> bool { return --m_count != 0; }
+
+private:
+  usize m_count{0};
+};
+
+// increments only need atomicity, the decrement that drops the last
+// reference has to see every write made through the other handles
+struct atomic_count {
+  atomic_count() = default;
+  atomic_count(atomic_count const &count) {
+    m_count.store(count.m_count.load(std::memory_order_relaxed),
+                  std::memory_order_relaxed);
+  }
+
+  [[nodiscard]] auto use_count() const noexcept -> usize {
+    return m_count.load(std::memory_order_relaxed);
   }
 
-  operator bool() const noexcept { return m_count != 0; }
+  auto acquire() noexcept -> void {
+    m_count.fetch_add(1, std::memory_order_relaxed);
+  }
+  auto try_acquire() noexcept -> bool {
+    auto count = m_count.load(std::memory_order_relaxed);
+    while (count != 0) {
+      if (m_count.compare_exchange_weak(count, count + 1,
+                                        std::memory_order_acquire,
+                                        std::memory_order_relaxed))
+        return true;
+    }
+    return false;
+  }
+  auto release() noexcept -> bool {
+    return m_count.fetch_sub(1, std::memory_order_acq_rel) != 1;
+  }
 
 private:
   std::atomic<usize> m_count{0};
 };
 
-template <typename T, typename D = void (*)(T *)> struct shared {
+namespace details {
+struct biased_owner;
+inline thread_local biased_owner *t_biased_owner = nullptr;
+} // namespace details
+
+// Biased reference counting. The thread that created the count keeps its
+// own references with plain loads and stores, every other thread goes
+// through an atomic counter. When the owner's count drops to zero the two
+// are merged and the object behaves like an atomic_count from then on.
+//
+// A release on another thread that takes the atomic counter below zero
+// queues the count on its owner, the owner merges it in reconcile(). Owners
+// should call reconcile() from time to time, it also runs on thread exit.
+struct biased_count {
 public:
-  template <typename U, typename E> friend class shared;
+  using reclaim_fn = void (*)(biased_count *);
+
+  biased_count();
+
+  [[nodiscard]] auto use_count() const noexcept -> usize {
+    return as<usize>(as<isize>(m_local.load(std::memory_order_relaxed)) +
+                     count_of(m_shared.load(std::memory_order_relaxed)));
+  }
+
+  auto acquire() noexcept -> void {
+    if (is_owned()) {
+      m_local.store(m_local.load(std::memory_order_relaxed) + 1,
+                    std::memory_order_relaxed);
+    } else {
+      m_shared.fetch_add(one, std::memory_order_relaxed);
+    }
+  }
+
+  auto try_acquire() noexcept -> bool {
+    // the owner's count only reaches zero when it detaches
+    if (is_owned()) {
+      acquire();
+      return true;
+    }
+    return try_acquire_shared();
+  }
+
+  auto release() noexcept -> bool {
+    if (is_owned()) {
+      auto const local = m_local.load(std::memory_order_relaxed) - 1;
+      m_local.store(local, std::memory_order_relaxed);
+      return local != 0 || merge();
+    }
+    return release_shared();
+  }
+
+  // merges every count queued on the calling thread
+  static auto reconcile() -> usize;
+
+  // called when a queued count turns out to hold the last reference
+  auto set_reclaim(reclaim_fn reclaim) noexcept -> void {
+    m_reclaim = reclaim;
+  }
+
+private:
+  friend struct details::biased_owner;
+
+  static constexpr isize merged_flag = 1;
+  static constexpr isize queued_flag = 2;
+  static constexpr isize one = 4;
+
+  // the flags live in the low bits, the count may go negative
+  static auto count_of(isize value) noexcept -> isize { return value >> 2; }
+
+  [[nodiscard]] auto is_owned() const noexcept -> bool {
+    return m_owner == details::t_biased_owner && !m_detached;
+  }
+
+  auto merge() noexcept -> bool;
+  auto try_acquire_shared() noexcept -> bool;
+  auto release_shared() noexcept -> bool;
+  auto settle() noexcept -> void;
+
+  details::biased_owner *const m_owner;
+  // only touched by the thread holding m_owner
+  bool m_detached{false};
+  std::atomic<usize> m_local{0};
+  std::atomic<isize> m_shared{0};
+  biased_count *m_next_queued{nullptr};
+  reclaim_fn m_reclaim{nullptr};
+};
+
+// The control block shared by every handle to the same object. The strong
+// references together hold one weak reference, so the block outlives the
+// object for as long as a weak handle still points at it.
+template <typename TCount = atomic_count>
+struct shared_count : public TCount {
+public:
+  using dispose_fn = void (*)(shared_count *);
+  using weak_count_type =
+      std::conditional_t<std::is_same_v<TCount, local_count>, local_count,
+                         atomic_count>;
+
+  // dispose destroys the managed object, destroy frees the block itself
+  explicit shared_count(dispose_fn dispose = nullptr,
+                        dispose_fn destroy = nullptr)
+      : m_dispose(dispose), m_destroy(destroy) {
+    m_weak.acquire();
+    if constexpr (std::is_same_v<TCount, biased_count>)
+      this->set_reclaim([](biased_count *count) {
+        static_cast<shared_count *>(count)->reclaim();
+      });
+  }
+
+  operator bool() const noexcept { return this->use_count() != 0; }
+
+  // runs once the last strong reference is gone
+  auto reclaim() -> void {
+    if (m_dispose)
+      m_dispose(this);
+    release_weak();
+  }
+
+  auto acquire_weak() noexcept -> void { m_weak.acquire(); }
+  auto release_weak() -> void {
+    if (!m_weak.release() && m_destroy)
+      m_destroy(this);
+  }
+
+private:
+  dispose_fn m_dispose;
+  dispose_fn m_destroy;
+  weak_count_type m_weak;
+};
+
+namespace details {
+// object allocated on its own, the block only points at it
+template <typename TValue, typename D, typename TCount>
+struct shared_block : public shared_count<TCount> {
+  shared_block(TValue *handle, D deleter)
+      : shared_count<TCount>(&dispose_handle, &destroy_block),
+        m_handle(handle), m_deleter(deleter) {}
+
+  static auto dispose_handle(shared_count<TCount> *count) -> void {
+    auto *block = static_cast<shared_block *>(count);
+    if (block->m_deleter)
+      block->m_deleter(block->m_handle);
+    else
+      delete block->m_handle;
+  }
+  static auto destroy_block(shared_count<TCount> *count) -> void {
+    delete static_cast<shared_block *>(count);
+  }
+
+  TValue *m_handle;
+  D m_deleter;
+};
+
+// object and count in a single allocation, made with the given allocator
+template <typename TValue, typename TAllocator, typename TCount>
+struct shared_inplace : public shared_count<TCount> {
+  using allocator_type = typename std::allocator_traits<
+      TAllocator>::template rebind_alloc<shared_inplace>;
+  using alloc = std::allocator_traits<allocator_type>;
+
+  explicit shared_inplace(allocator_type const &allocator)
+      : shared_count<TCount>(&dispose_value, &destroy_block),
+        m_allocator(allocator) {}
+
+  template <typename... Args>
+  static auto create(TAllocator const &allocator, Args &&...args)
+      -> shared_inplace * {
+    auto block_allocator = allocator_type(allocator);
+    auto *block = alloc::allocate(block_allocator, 1);
+    new (block) shared_inplace(block_allocator);
+    // nothing owns the block until the object is built
+    try {
+      new (block->get()) TValue(std::forward<Args>(args)...);
+    } catch (...) {
+      block->~shared_inplace();
+      alloc::deallocate(block_allocator, block, 1);
+      throw;
+    }
+    return block;
+  }
+
+  [[nodiscard]] auto get() -> TValue * {
+    return reinterpret_cast<TValue *>(&m_storage);
+  }
+
+  static auto dispose_value(shared_count<TCount> *count) -> void {
+    static_cast<shared_inplace *>(count)->get()->~TValue();
+  }
+  static auto destroy_block(shared_count<TCount> *count) -> void {
+    auto *block = static_cast<shared_inplace *>(count);
+    auto allocator = block->m_allocator;
+    block->~shared_inplace();
+    alloc::deallocate(allocator, block, 1);
+  }
+
+  allocator_type m_allocator;
+  std::aligned_storage_t<sizeof(TValue), alignof(TValue)> m_storage;
+};
+} // namespace details
+
+template <typename T, typename TCount> struct weak;
+
+template <typename T, typename D = void (*)(T *),
+          typename TCount = atomic_count>
+struct shared {
+public:
+  template <typename U, typename E, typename F> friend struct shared;
+  template <typename U, typename F> friend struct weak;
+  template <typename U, typename E, typename F> friend struct atomic_shared;
+  using count_type = shared_count<TCount>;
+
   shared() = default;
   template <typename U>
-  shared(U *handle, D deleter = nullptr)
-      : m_handle(handle), m_deleter(deleter) {
-    m_count = new shared_count();
-    acquire();
+  shared(U *handle, D deleter = nullptr) : m_handle(handle) {
+    if (handle) {
+      m_count = new details::shared_block<U, D, TCount>(handle, deleter);
+      acquire();
+    }
   }
+  // shares ownership of an existing control block
   template <typename U>
-  shared(U *handle, shared_count *count, D deleter = nullptr)
-      : m_count(count), m_handle(handle), m_deleter(deleter) {
+  shared(U *handle, count_type *count) : m_handle(handle), m_count(count) {
+    acquire();
+  }
+  // shares ownership with other but points at handle
+  template <typename U, typename E>
+  shared(shared<U, E, TCount> const &other, T *handle)
+      : m_handle(handle), m_count(other.m_count) {
     acquire();
   }
   ~shared() { release(); }
 
-  template <typename U>
-  shared(shared<U> const &other)
-      : m_count(other.m_count), m_handle(other.m_handle) {
+  shared(shared const &other)
+      : m_handle(other.m_handle), m_count(other.m_count) {
     acquire();
   }
-  template <typename U>
-  shared(shared<U> &&other) : m_count(other.m_count), m_handle(other.m_handle) {
+  shared(shared &&other) noexcept
+      : m_handle(other.m_handle), m_count(other.m_count) {
     other.m_handle = nullptr;
+    other.m_count = nullptr;
   }
 
-  template <typename U> auto operator=(shared<U> const &other) -> shared & {
-    if (&other != this) {
-      release();
-      m_handle = other.get();
-      m_count = other.m_count;
-      acquire();
-    }
+  template <typename U, typename E>
+  shared(shared<U, E, TCount> const &other)
+      : m_handle(other.m_handle), m_count(other.m_count) {
+    acquire();
+  }
+  template <typename U, typename E>
+  shared(shared<U, E, TCount> &&other) noexcept
+      : m_handle(other.m_handle), m_count(other.m_count) {
+    other.m_handle = nullptr;
+    other.m_count = nullptr;
+  }
 
+  auto operator=(shared const &other) -> shared & {
+    shared(other).swap(*this);
+    return *this;
+  }
+  auto operator=(shared &&other) noexcept -> shared & {
+    shared(std::move(other)).swap(*this);
     return *this;
   }
 
-  template <typename U> auto operator=(shared<U> &&other) -> shared & {
-    if (&other != this) {
-      if (m_handle) {
-        release();
-      }
-      m_count = other.m_count;
-      m_handle = other.m_handle;
-      other.m_handle = nullptr;
-    }
-
+  template <typename U, typename E>
+  auto operator=(shared<U, E, TCount> const &other) -> shared & {
+    shared(other).swap(*this);
+    return *this;
+  }
+  template <typename U, typename E>
+  auto operator=(shared<U, E, TCount> &&other) -> shared & {
+    shared(std::move(other)).swap(*this);
     return *this;
   }
 
-  shared(std::nullptr_t) { m_handle = nullptr; }
-  auto operator=(std::nullptr_t) -> shared<T> & {
+  shared(std::nullptr_t) {}
+  auto operator=(std::nullptr_t) -> shared & {
     release();
     m_handle = nullptr;
+    m_count = nullptr;
     return *this;
   }
 
+  void swap(shared &other) noexcept {
+    std::swap(m_handle, other.m_handle);
+    std::swap(m_count, other.m_count);
+  }
+
   operator bool() const { return m_handle != nullptr; }
 
   auto operator==(std::nullptr_t) const -> bool { return m_handle == nullptr; }
   auto operator!=(std::nullptr_t) const -> bool { return m_handle != nullptr; }
 
   [[nodiscard]] auto use_count() const noexcept -> usize {
-    return m_count->use_count();
+    return m_count ? m_count->use_count() : 0;
   }
   [[nodiscard]] auto get() const -> T & { return *m_handle; }
 
   [[nodiscard]] auto operator->() const -> T * { return m_handle; }
-  [[nodiscard]] auto operator*() const -> T * { return *m_handle; }
+  [[nodiscard]] auto operator*() const -> T & { return *m_handle; }
 
   void acquire() {
-    if (m_handle) {
+    if (m_count) {
       m_count->acquire();
     }
   }
   void release() {
-    if (m_handle) {
-      if (!m_count->release()) {
-        if (m_deleter)
-          m_deleter(m_handle);
-        else if constexpr (std::is_array_v<T>)
-          delete[] m_handle;
-        else
-          delete m_handle;
-        delete m_count;
-      }
+    if (m_count) {
+      if (!m_count->release())
+        m_count->reclaim();
     }
   }
 
 private:
+  struct adopt_t {};
+
+  // takes over a reference that was already acquired
+  shared(T *handle, count_type *count, adopt_t)
+      : m_handle(handle), m_count(count) {}
+
+  T *m_handle{nullptr};
+  count_type *m_count{nullptr};
+};
+
+// A non-owning handle, lock() hands out a shared while the object is alive.
+template <typename T, typename TCount = atomic_count> struct weak {
+public:
+  template <typename U, typename F> friend struct weak;
+  using count_type = shared_count<TCount>;
+
+  weak() = default;
+  template <typename U, typename E>
+  weak(shared<U, E, TCount> const &other)
+      : m_handle(other.m_handle), m_count(other.m_count) {
+    acquire();
+  }
+  weak(weak const &other) : m_handle(other.m_handle), m_count(other.m_count) {
+    acquire();
+  }
+  weak(weak &&other) noexcept
+      : m_handle(other.m_handle), m_count(other.m_count) {
+    other.m_handle = nullptr;
+    other.m_count = nullptr;
+  }
+  ~weak() { release(); }
+
+  auto operator=(weak const &other) -> weak & {
+    weak(other).swap(*this);
+    return *this;
+  }
+  auto operator=(weak &&other) noexcept -> weak & {
+    weak(std::move(other)).swap(*this);
+    return *this;
+  }
+
+  void swap(weak &other) noexcept {
+    std::swap(m_handle, other.m_handle);
+    std::swap(m_count, other.m_count);
+  }
+
+  [[nodiscard]] auto use_count() const noexcept -> usize {
+    return m_count ? m_count->use_count() : 0;
+  }
+  [[nodiscard]] auto expired() const noexcept -> bool {
+    return use_count() == 0;
+  }
+
+  template <typename D = void (*)(T *)>
+  [[nodiscard]] auto lock() const -> shared<T, D, TCount> {
+    if (m_count && m_count->try_acquire())
+      return shared<T, D, TCount>(m_handle, m_count,
+                                  typename shared<T, D, TCount>::adopt_t{});
+    return nullptr;
+  }
+
+  void reset() { weak().swap(*this); }
+
+private:
+  void acquire() {
+    if (m_count)
+      m_count->acquire_weak();
+  }
+  void release() {
+    if (m_count)
+      m_count->release_weak();
+  }
+
   T *m_handle{nullptr};
-  shared_count *m_count{nullptr};
-  D m_deleter{nullptr};
+  count_type *m_count{nullptr};
 };
 
-template <typename T, typename... Args>
-auto make_shared(Args &&...args) -> shared<T> {
-  return std::move(shared<T>(new T(std::forward<Args>(args)...)));
+// both are a pointer to the object and one to its count
+template <typename T, typename D, typename TCount>
+struct is_trivially_relocatable<shared<T, D, TCount>> : std::true_type {};
+template <typename T, typename TCount>
+struct is_trivially_relocatable<weak<T, TCount>> : std::true_type {};
+
+// an empty shared is None
+template <typename T, typename D, typename TCount>
+struct niche_traits<shared<T, D, TCount>> {
+  static constexpr bool available = true;
+  static auto none() noexcept -> shared<T, D, TCount> { return nullptr; }
+  static auto is_none(shared<T, D, TCount> const &value) noexcept -> bool {
+    return !value;
+  }
+};
+
+template <typename T>
+using local_shared = shared<T, void (*)(T *), local_count>;
+template <typename T>
+using biased_shared = shared<T, void (*)(T *), biased_count>;
+
+template <typename T, typename TCount = atomic_count, typename TAllocator,
+          typename... Args>
+auto allocate_shared(TAllocator const &allocator, Args &&...args)
+    -> shared<T, void (*)(T *), TCount> {
+  auto *block = details::shared_inplace<T, TAllocator, TCount>::create(
+      allocator, std::forward<Args>(args)...);
+  return shared<T, void (*)(T *), TCount>(block->get(), block);
+}
+
+// the pool's granularity has to fit the object and its control block
+template <typename T, typename TCount = atomic_count, typename... Args>
+auto allocate_shared(pool &pool, Args &&...args)
+    -> shared<T, void (*)(T *), TCount> {
+  return allocate_shared<T, TCount>(pool_allocator<T>(pool),
+                                    std::forward<Args>(args)...);
+}
+
+// object and control block share one allocation
+template <typename T, typename TCount = atomic_count, typename... Args>
+auto make_shared(Args &&...args) -> shared<T, void (*)(T *), TCount> {
+  return allocate_shared<T, TCount>(sys_allocator<T>(),
+                                    std::forward<Args>(args)...);
 }
 } // namespace zinc
\ No newline at end of file
@@ -0,0 +1,131 @@
+#pragma once
+
+#include "base.h"
+#include "hash.h"
+#include "shared.h"
+#include "string.h"
+
+namespace zinc {
+namespace details {
+// Reference count and bytes in one allocation. A block made from a string
+// buffer that was handed over points at that buffer instead.
+struct shared_string_block {
+  atomic_count m_refs;
+  char *m_adopted;
+
+  auto bytes() -> char * {
+    return m_adopted ? m_adopted : reinterpret_cast<char *>(this + 1);
+  }
+};
+} // namespace details
+
+// An immutable string whose copies and substrings share one buffer. Copying
+// only bumps a reference count, so one payload can be handed to any number of
+// consumers on any number of threads. A substring keeps the whole buffer
+// alive, copy it into a fresh shared_string to let a large parent go.
+// Contents are not null terminated.
+struct shared_string {
+public:
+  using size_type = usize;
+  using iterator = char const *;
+
+  static constexpr size_type npos = ~size_type(0);
+
+  shared_string() = default;
+  explicit shared_string(string_view const &text);
+  // takes over the heap buffer of the string rather than copying it
+  explicit shared_string(string &&text);
+
+  shared_string(shared_string const &other)
+      : m_block(other.m_block), m_data(other.m_data),
+        m_length(other.m_length) {
+    if (m_block)
+      m_block->m_refs.acquire();
+  }
+  shared_string(shared_string &&other) noexcept
+      : m_block(other.m_block), m_data(other.m_data),
+        m_length(other.m_length) {
+    other.m_block = nullptr;
+    other.m_data = "";
+    other.m_length = 0;
+  }
+  ~shared_string() { release(); }
+
+  auto operator=(shared_string const &other) -> shared_string & {
+    if (other.m_block)
+      other.m_block->m_refs.acquire();
+    release();
+    m_block = other.m_block;
+    m_data = other.m_data;
+    m_length = other.m_length;
+    return *this;
+  }
+  auto operator=(shared_string &&other) noexcept -> shared_string & {
+    if (this != &other) {
+      release();
+      m_block = other.m_block;
+      m_data = other.m_data;
+      m_length = other.m_length;
+      other.m_block = nullptr;
+      other.m_data = "";
+      other.m_length = 0;
+    }
+    return *this;
+  }
+
+  [[nodiscard]] auto data() const -> char const * { return m_data; }
+  [[nodiscard]] auto length() const -> size_type { return m_length; }
+  [[nodiscard]] auto size() const -> size_type { return m_length; }
+  [[nodiscard]] auto empty() const -> bool { return m_length == 0; }
+
+  auto operator[](size_type const index) const -> char {
+    ZINC_ASSERT(index < m_length);
+    return m_data[index];
+  }
+
+  [[nodiscard]] auto begin() const -> iterator { return m_data; }
+  [[nodiscard]] auto end() const -> iterator { return m_data + m_length; }
+
+  // shares the buffer, nothing is copied
+  [[nodiscard]] auto substr(size_type const pos,
+                            size_type const count = npos) const
+      -> shared_string {
+    ZINC_ASSERT(pos <= m_length);
+    auto const rest = m_length - pos;
+    auto result = *this;
+    result.m_data += pos;
+    result.m_length = count < rest ? count : rest;
+    return result;
+  }
+
+  // how many handles share the buffer, zero for an empty string
+  [[nodiscard]] auto use_count() const -> usize {
+    return m_block ? m_block->m_refs.use_count() : 0;
+  }
+
+  [[nodiscard]] auto as_string_view() const -> string_view {
+    return {m_data, m_length};
+  }
+  operator string_view() const { return as_string_view(); }
+
+  auto operator==(string_view const &other) const -> bool {
+    return as_string_view() == other;
+  }
+  auto operator!=(string_view const &other) const -> bool {
+    return as_string_view() != other;
+  }
+
+private:
+  auto release() -> void;
+
+  details::shared_string_block *m_block{nullptr};
+  char const *m_data{""};
+  size_type m_length{0};
+};
+
+template <> struct hash<shared_string> {
+  auto operator()(shared_string const &text) const -> u64 {
+    return hash_bytes(text.data(), text.length());
+  }
+};
+} // namespace zinc
\ No newline at end of file
@@ -0,0 +1,197 @@
+#pragma once
+
+#include "base.h"
+#include "option.h"
+#include "vector.h"
+
+#include <type_traits>
+
+namespace zinc::simd {
+constexpr usize npos = ~usize(0);
+
+enum class comparison : u8 {
+  equal,
+  not_equal,
+  less,
+  less_equal,
+  greater,
+  greater_equal,
+};
+
+// A comparison of every element against value, element on the left. Only
+// these can be checked a vector at a time, arbitrary callables cannot.
+template <typename TValue> struct predicate {
+  comparison op;
+  TValue value;
+};
+
+template <typename TValue>
+constexpr auto equal_to(TValue value) -> predicate<TValue> {
+  return {comparison::equal, value};
+}
+template <typename TValue>
+constexpr auto not_equal_to(TValue value) -> predicate<TValue> {
+  return {comparison::not_equal, value};
+}
+template <typename TValue>
+constexpr auto less_than(TValue value) -> predicate<TValue> {
+  return {comparison::less, value};
+}
+template <typename TValue>
+constexpr auto less_equal(TValue value) -> predicate<TValue> {
+  return {comparison::less_equal, value};
+}
+template <typename TValue>
+constexpr auto greater_than(TValue value) -> predicate<TValue> {
+  return {comparison::greater, value};
+}
+template <typename TValue>
+constexpr auto greater_equal(TValue value) -> predicate<TValue> {
+  return {comparison::greater_equal, value};
+}
+
+template <typename TValue> struct min_max_result {
+  TValue min;
+  TValue max;
+};
+
+// integers add up in 64 bits of their own signedness and wrap like them,
+// floats add up in doubles
+template <typename TValue>
+using sum_type = std::conditional_t<
+    std::is_floating_point<TValue>::value, f64,
+    std::conditional_t<std::is_signed<TValue>::value, i64, u64>>;
+
+namespace details {
+template <typename TSize, bool is_signed> struct sized_lane;
+template <> struct sized_lane<char[1], true> { using type = i8; };
+template <> struct sized_lane<char[1], false> { using type = u8; };
+template <> struct sized_lane<char[2], true> { using type = i16; };
+template <> struct sized_lane<char[2], false> { using type = u16; };
+template <> struct sized_lane<char[4], true> { using type = i32; };
+template <> struct sized_lane<char[4], false> { using type = u32; };
+template <> struct sized_lane<char[8], true> { using type = i64; };
+template <> struct sized_lane<char[8], false> { using type = u64; };
+
+// the fixed width type the kernels are built for, so char, long and
+// long long share the kernels of the integer of their size
+template <typename TValue>
+using lane_type = typename std::conditional_t<
+    std::is_floating_point<TValue>::value, std::common_type<TValue>,
+    sized_lane<char[sizeof(TValue)], std::is_signed<TValue>::value>>::type;
+
+template <typename TValue>
+constexpr bool is_lane_type = std::is_arithmetic<TValue>::value &&
+                              !std::is_same<TValue, bool>::value &&
+                              sizeof(TValue) <= 8;
+
+// vectorised with the widest instructions the processor has, explicitly
+// instantiated for i8 through u64, f32 and f64
+template <typename TLane>
+auto find(TLane const *data, usize count, TLane value) -> usize;
+// with negate set it looks for the first element failing the comparison
+template <typename TLane>
+auto find_if(TLane const *data, usize count, comparison op, TLane value,
+             bool negate) -> usize;
+template <typename TLane>
+auto count(TLane const *data, usize count, TLane value) -> usize;
+template <typename TLane>
+auto min_max(TLane const *data, usize count) -> min_max_result<TLane>;
+template <typename TLane>
+auto sum(TLane const *data, usize count) -> sum_type<TLane>;
+template <typename TLane>
+auto mismatch(TLane const *a, TLane const *b, usize count) -> usize;
+
+template <typename TValue> auto lanes(TValue const *data) {
+  return reinterpret_cast<lane_type<TValue> const *>(data);
+}
+
+template <typename TValue, typename TOther>
+auto lane_value(TOther value) -> lane_type<TValue> {
+  return as<lane_type<TValue>>(as<TValue>(value));
+}
+} // namespace details
+
+// index of the first element equal to value, npos when there is none
+template <typename TValue>
+auto find(array_view<TValue> items,
+          typename array_view<TValue>::value_type value) -> usize {
+  static_assert(details::is_lane_type<TValue>);
+  return details::find(details::lanes(items.data()), items.size(),
+                       details::lane_value<TValue>(value));
+}
+
+// Index of the first element matching, npos when there is none. The value
+// in test is converted to the element type first.
+template <typename TValue, typename TTest>
+auto find_if(array_view<TValue> items, predicate<TTest> test) -> usize {
+  static_assert(details::is_lane_type<TValue>);
+  return details::find_if(details::lanes(items.data()), items.size(),
+                          test.op, details::lane_value<TValue>(test.value),
+                          false);
+}
+
+template <typename TValue, typename TTest>
+auto any_of(array_view<TValue> items, predicate<TTest> test) -> bool {
+  return find_if(items, test) != npos;
+}
+
+template <typename TValue, typename TTest>
+auto none_of(array_view<TValue> items, predicate<TTest> test) -> bool {
+  return find_if(items, test) == npos;
+}
+
+// a NaN fails every comparison but not_equal, so this is false for a view
+// holding one unless test is not_equal
+template <typename TValue, typename TTest>
+auto all_of(array_view<TValue> items, predicate<TTest> test) -> bool {
+  static_assert(details::is_lane_type<TValue>);
+  return details::find_if(details::lanes(items.data()), items.size(), test.op,
+                          details::lane_value<TValue>(test.value),
+                          true) == npos;
+}
+
+template <typename TValue>
+auto count(array_view<TValue> items,
+           typename array_view<TValue>::value_type value) -> usize {
+  static_assert(details::is_lane_type<TValue>);
+  return details::count(details::lanes(items.data()), items.size(),
+                        details::lane_value<TValue>(value));
+}
+
+// None for an empty view. NaNs are skipped unless the first element is
+// one, which then comes back as both.
+template <typename TValue>
+auto min_max(array_view<TValue> items) -> option<min_max_result<TValue>> {
+  static_assert(details::is_lane_type<TValue>);
+  if (items.empty())
+    return None;
+  auto const found =
+      details::min_max(details::lanes(items.data()), items.size());
+  return min_max_result<TValue>{as<TValue>(found.min), as<TValue>(found.max)};
+}
+
+// Several partial sums run side by side, so float totals can differ from a
+// left to right sum in the last bits.
+template <typename TValue>
+auto sum(array_view<TValue> items) -> sum_type<TValue> {
+  static_assert(details::is_lane_type<TValue>);
+  return as<sum_type<TValue>>(
+      details::sum(details::lanes(items.data()), items.size()));
+}
+
+// Index of the first position where a and b differ, the length of the
+// shorter one when it is a prefix of the other and npos when they are
+// equal. Floats compare with ==, so a NaN never matches.
+template <typename TValue>
+auto mismatch(array_view<TValue> a, array_view<TValue> b) -> usize {
+  static_assert(details::is_lane_type<TValue>);
+  auto const common = a.size() < b.size() ? a.size() : b.size();
+  auto const found =
+      details::mismatch(details::lanes(a.data()), details::lanes(b.data()),
+                        common);
+  if (found != npos || a.size() == b.size())
+    return found;
+  return common;
+}
+} // namespace zinc::simd
\ No newline at end of file
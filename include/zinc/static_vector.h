@@ -0,0 +1,136 @@
+#pragma once
+
+#include "base.h"
+#include "debug.h"
+
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace zinc {
+// A vector whose elements live inside the object, up to TCapacity of them.
+// It never allocates, running out of room is a bug and asserts.
+template <typename TValue, usize TCapacity> class static_vector {
+  static_assert(TCapacity > 0, "static_vector needs room for an element");
+
+public:
+  using value_type = TValue;
+  using reference = TValue &;
+  using const_reference = TValue const &;
+  using pointer = TValue *;
+  using const_pointer = TValue const *;
+  using iterator = TValue *;
+  using const_iterator = TValue const *;
+  using size_type = usize;
+
+  static_vector() = default;
+
+  static_vector(static_vector const &other) {
+    for (auto const &value : other)
+      push_back(value);
+  }
+
+  static_vector(static_vector &&other) noexcept(
+      std::is_nothrow_move_constructible<TValue>::value ||
+      is_trivially_relocatable<TValue>::value) {
+    take(other);
+  }
+
+  ~static_vector() { clear(); }
+
+  auto operator=(static_vector const &other) -> static_vector & {
+    if (this != &other) {
+      clear();
+      for (auto const &value : other)
+        push_back(value);
+    }
+    return *this;
+  }
+
+  auto operator=(static_vector &&other) noexcept(
+      std::is_nothrow_move_constructible<TValue>::value ||
+      is_trivially_relocatable<TValue>::value) -> static_vector & {
+    if (this != &other) {
+      clear();
+      take(other);
+    }
+    return *this;
+  }
+
+  template <typename... TArgs> auto emplace_back(TArgs &&...args) -> TValue & {
+    ZINC_ASSERTF(m_size < TCapacity, "static_vector::emplace_back: full");
+    auto *slot = new (data() + m_size) TValue(std::forward<TArgs>(args)...);
+    ++m_size;
+    return *slot;
+  }
+
+  void push_back(TValue const &value) { emplace_back(value); }
+  void push_back(TValue &&value) { emplace_back(std::move(value)); }
+
+  void pop_back() {
+    ZINC_ASSERTF(m_size > 0, "static_vector::pop_back: empty");
+    data()[--m_size].~TValue();
+  }
+
+  void clear() noexcept {
+    if constexpr (!std::is_trivially_destructible<TValue>::value) {
+      for (usize i = 0; i < m_size; ++i)
+        data()[i].~TValue();
+    }
+    m_size = 0;
+  }
+
+  auto operator[](usize index) -> TValue & {
+    ZINC_ASSERTF(index < m_size, "static_vector::operator[]");
+    return data()[index];
+  }
+  auto operator[](usize index) const -> TValue const & {
+    ZINC_ASSERTF(index < m_size, "static_vector::operator[]");
+    return data()[index];
+  }
+
+  auto front() -> TValue & { return (*this)[0]; }
+  auto front() const -> TValue const & { return (*this)[0]; }
+  auto back() -> TValue & { return (*this)[m_size - 1]; }
+  auto back() const -> TValue const & { return (*this)[m_size - 1]; }
+
+  [[nodiscard]] auto data() noexcept -> TValue * {
+    return std::launder(reinterpret_cast<TValue *>(m_storage));
+  }
+  [[nodiscard]] auto data() const noexcept -> TValue const * {
+    return std::launder(reinterpret_cast<TValue const *>(m_storage));
+  }
+
+  auto begin() noexcept -> iterator { return data(); }
+  auto end() noexcept -> iterator { return data() + m_size; }
+  auto begin() const noexcept -> const_iterator { return data(); }
+  auto end() const noexcept -> const_iterator { return data() + m_size; }
+
+  [[nodiscard]] auto size() const noexcept -> usize { return m_size; }
+  [[nodiscard]] auto empty() const noexcept -> bool { return m_size == 0; }
+  [[nodiscard]] auto full() const noexcept -> bool {
+    return m_size == TCapacity;
+  }
+  [[nodiscard]] static constexpr auto capacity() noexcept -> usize {
+    return TCapacity;
+  }
+
+private:
+  // moves the elements of other into this empty vector and empties other,
+  // with one memcpy when they are trivially relocatable
+  void take(static_vector &other) {
+    if constexpr (is_trivially_relocatable<TValue>::value) {
+      std::memcpy(m_storage, other.m_storage, sizeof(TValue) * other.m_size);
+      m_size = std::exchange(other.m_size, 0);
+    } else {
+      for (auto &value : other)
+        push_back(std::move(value));
+      other.clear();
+    }
+  }
+
+  alignas(TValue) unsigned char m_storage[sizeof(TValue) * TCapacity];
+  usize m_size = 0;
+};
+} // namespace zinc
\ No newline at end of file
@@ -3,96 +3,240 @@
 #include "allocator/prelude.h"
 #include "base.h"
 #include "debug.h"
-#include "vector.h"
 
 namespace zinc {
 struct string_view;
+struct split_range;
+struct token_range;
 
+namespace details {
+// vectorised where the processor allows it, all return ~usize(0) when
+// nothing matches
+auto find_byte(char const *data, usize length, char value) -> usize;
+auto rfind_byte(char const *data, usize length, char value) -> usize;
+auto count_byte(char const *data, usize length, char value) -> usize;
+auto find_any_byte(char const *data, usize length, char const *set,
+                   usize set_length) -> usize;
+auto find_not_any_byte(char const *data, usize length, char const *set,
+                       usize set_length) -> usize;
+auto find_bytes(char const *data, usize length, char const *needle,
+                usize needle_length) -> usize;
+auto rfind_bytes(char const *data, usize length, char const *needle,
+                 usize needle_length) -> usize;
+
+// keeps an empty allocator from taking up space next to the representation
+template <typename TAllocator, typename TRep>
+struct string_storage : public TAllocator {
+  explicit string_storage(TAllocator const &allocator)
+      : TAllocator(allocator) {}
+
+  TRep m_rep{};
+};
+} // namespace details
+
+// A string that keeps short contents inline. The last element of the object
+// holds how much inline room is left, so a string that fills the inline
+// buffer completely uses that element as its terminator. Longer strings live
+// in a buffer from TAllocator and set a flag bit that lands in the same
+// element.
 template <typename TValue = char, typename TAllocator = sys_allocator<TValue>>
 struct basic_string {
+private:
+  struct long_rep {
+    TValue *m_data;
+    usize m_size;
+    usize m_capacity;
+  };
+
+  union rep {
+    long_rep m_long;
+    TValue m_short[sizeof(long_rep) / sizeof(TValue)];
+  };
+
+  using alloc = std::allocator_traits<TAllocator>;
+  using unsigned_value = std::make_unsigned_t<TValue>;
+
 public:
+  using value_type = TValue;
   using size_type = usize;
+  using allocator_type = TAllocator;
+  using iterator = TValue *;
+  using const_iterator = TValue const *;
 
-  inline explicit basic_string(TAllocator &allocator) : m_buffer(allocator) {}
+  // characters that fit without allocating, not counting the terminator
+  static constexpr size_type inline_capacity =
+      sizeof(long_rep) / sizeof(TValue) - 1;
+
+  inline explicit basic_string(TAllocator const &allocator)
+      : m_storage(allocator) {
+    set_short_length(0);
+  }
   inline basic_string() : basic_string(TAllocator()) {}
-  inline explicit basic_string(size_type const count, TAllocator &allocator)
-      : m_buffer(count + 1, allocator) {
-    m_buffer[count] = '\0';
+  inline explicit basic_string(size_type const count,
+                               TAllocator const &allocator = TAllocator())
+      : basic_string(allocator) {
+    resize(count);
   }
-  inline basic_string(string_view const &view, TAllocator &allocator);
+  inline basic_string(string_view const &view, TAllocator const &allocator);
   inline basic_string(string_view const &view)
       : basic_string(view, TAllocator()) {}
 
-  inline basic_string(basic_string const &other) : m_buffer(other.m_buffer) {
-    m_buffer[m_buffer.size()] = '\0';
+  inline basic_string(basic_string const &other)
+      : basic_string(other.data(), other.length(), other.get_allocator()) {}
+  inline basic_string(basic_string &&other) noexcept
+      : m_storage(other.get_allocator()) {
+    m_storage.m_rep = other.m_storage.m_rep;
+    other.set_short_length(0);
   }
-  inline basic_string(basic_string &&other)
-      : m_buffer(std::move(other.m_buffer)) {}
 
-  inline basic_string(TValue const *str, TAllocator &allocator)
+  inline basic_string(TValue const *str, TAllocator const &allocator)
       : basic_string(str, strlen(str), allocator) {}
   inline basic_string(TValue const *str)
       : basic_string(str, strlen(str), TAllocator()) {}
 
   inline basic_string(TValue const *str, size_type const len,
-                      TAllocator &allocator)
-      : m_buffer(allocator) {
-    m_buffer.resize(len + 1);
-    memcpy(m_buffer.data(), str, len);
-    m_buffer[len] = '\0';
+                      TAllocator const &allocator)
+      : basic_string(allocator) {
+    assign(str, len);
   }
   inline basic_string(TValue const *str, size_type const len)
       : basic_string(str, len, TAllocator()) {}
 
+  inline ~basic_string() { release(); }
+
   inline auto operator=(basic_string const &other) -> basic_string & {
-    auto len = other.length();
-    m_buffer.resize(len + 1);
-    memcpy(m_buffer.data(), other.data(), len);
-    m_buffer[len] = '\0';
+    if (this != &other)
+      assign(other.data(), other.length());
     return *this;
   }
-  inline auto operator=(basic_string &&other) -> basic_string & {
-    m_buffer = std::move(other.m_buffer);
+  inline auto operator=(basic_string &&other) noexcept -> basic_string & {
+    if (this != &other) {
+      release();
+      get_allocator() = std::move(other.get_allocator());
+      m_storage.m_rep = other.m_storage.m_rep;
+      other.set_short_length(0);
+    }
     return *this;
   }
 
   inline auto operator=(TValue const *str) -> basic_string & {
-    auto const len = strlen(str);
-    m_buffer.resize(len + 1);
-    memcpy(m_buffer.data(), str, len);
-    m_buffer[len] = '\0';
+    assign(str, strlen(str));
     return *this;
   }
 
-  inline auto reserve(size_type count) -> void { m_buffer.reserve(count); }
+  inline auto assign(TValue const *str, size_type const len) -> void {
+    if (len > capacity())
+      grow(len, false);
+    // str may point into this string
+    memmove(data(), str, len * sizeof(TValue));
+    set_length(len);
+  }
+
+  inline auto reserve(size_type count) -> void {
+    if (count > capacity())
+      grow(count, true);
+  }
+
+  // new elements are value initialised
+  inline auto resize(size_type count) -> void {
+    auto const len = length();
+    if (count > len) {
+      reserve(count);
+      auto *chars = data();
+      for (auto i = len; i < count; ++i)
+        chars[i] = TValue();
+    }
+    set_length(count);
+  }
 
-  inline auto data() -> TValue * { return m_buffer.data(); }
+  inline auto data() -> TValue * {
+    return is_long() ? m_storage.m_rep.m_long.m_data
+                     : m_storage.m_rep.m_short;
+  }
   [[nodiscard]] inline auto data() const -> TValue const * {
-    return m_buffer.data();
+    return is_long() ? m_storage.m_rep.m_long.m_data
+                     : m_storage.m_rep.m_short;
   }
+  [[nodiscard]] inline auto c_str() const -> TValue const * { return data(); }
 
   [[nodiscard]] inline auto length() const -> size_type {
-    return m_buffer.size() - 1;
+    if (is_long())
+      return m_storage.m_rep.m_long.m_size;
+    return inline_capacity -
+           decode_remaining(m_storage.m_rep.m_short[inline_capacity]);
+  }
+  [[nodiscard]] inline auto size() const -> size_type { return length(); }
+  [[nodiscard]] inline auto empty() const -> bool { return length() == 0; }
+  [[nodiscard]] inline auto capacity() const -> size_type {
+    return is_long() ? m_storage.m_rep.m_long.m_capacity & ~long_flag
+                     : inline_capacity;
+  }
+  // true while the contents still fit in the object itself
+  [[nodiscard]] inline auto is_inline() const -> bool { return !is_long(); }
+
+  // Hands a heap buffer over to the caller, who frees capacity + 1 elements
+  // of it through the allocator, and leaves the string empty. Inline
+  // contents cannot be handed over, that gives nullptr and keeps them.
+  [[nodiscard]] inline auto detach_buffer(size_type &len, size_type &cap)
+      -> TValue * {
+    if (!is_long())
+      return nullptr;
+    auto *buffer = m_storage.m_rep.m_long.m_data;
+    len = length();
+    cap = capacity();
+    set_short_length(0);
+    return buffer;
+  }
+
+  [[nodiscard]] inline auto get_allocator() const -> TAllocator const & {
+    return m_storage;
+  }
+
+  inline auto operator[](size_type const index) -> TValue & {
+    ZINC_ASSERT(index < length());
+    return data()[index];
+  }
+  inline auto operator[](size_type const index) const -> TValue const & {
+    ZINC_ASSERT(index < length());
+    return data()[index];
+  }
+
+  inline auto begin() -> iterator { return data(); }
+  inline auto end() -> iterator { return data() + length(); }
+  [[nodiscard]] inline auto begin() const -> const_iterator { return data(); }
+  [[nodiscard]] inline auto end() const -> const_iterator {
+    return data() + length();
   }
-  [[nodiscard]] inline auto empty() const -> bool { return m_buffer.empty(); }
 
   // modifiers
-  inline auto clear() -> void { m_buffer.clear(); }
+  inline auto clear() -> void { set_length(0); }
 
   inline auto append(TValue const *str) -> void {
     auto const len = strlen(str);
     append(str, len);
   }
   template <typename TOtherAllocator>
-  inline auto append(basic_string<TOtherAllocator> const &other) -> void {
+  inline auto append(basic_string<TValue, TOtherAllocator> const &other)
+      -> void {
     append(other.data(), other.length());
   }
   inline auto append(TValue const *str, size_type const len) -> void {
-    auto const old_size = m_buffer.size();
-    m_buffer.resize(old_size + len);
-    memcpy(m_buffer.data() + old_size - 1, str, len);
-    m_buffer[old_size + len - 1] = '\0';
+    auto const old_size = length();
+    if (old_size + len > capacity()) {
+      // str may point into the buffer that is about to be replaced
+      auto const *const old_data = data();
+      if (str >= old_data && str < old_data + old_size) {
+        auto const offset = as<size_type>(str - old_data);
+        grow(old_size + len, true);
+        str = data() + offset;
+      } else {
+        grow(old_size + len, true);
+      }
+    }
+    memmove(data() + old_size, str, len * sizeof(TValue));
+    set_length(old_size + len);
   }
+  inline auto push_back(TValue const c) -> void { append(&c, 1); }
 
   inline auto operator+=(TValue const *str) -> basic_string & {
     append(str);
@@ -100,7 +244,7 @@ public:
   }
 
   template <typename TOtherAllocator>
-  inline auto operator+=(basic_string<TOtherAllocator> const &other)
+  inline auto operator+=(basic_string<TValue, TOtherAllocator> const &other)
       -> basic_string & {
     append(other);
     return *this;
@@ -115,12 +259,87 @@ public:
   inline operator string_view() const;
 
 private:
-  vector<TValue, TAllocator> m_buffer;
+  // the flag bit of the capacity word has to land in the last element, which
+  // is the low end of the word on big endian targets
+#if ZINC_CPU_ENDIAN_BIG
+  static constexpr size_type long_flag = 1;
+  static constexpr unsigned_value long_marker = 1;
+  static constexpr auto encode_remaining(size_type remaining) -> TValue {
+    return as<TValue>(remaining << 1);
+  }
+  static constexpr auto decode_remaining(TValue last) -> size_type {
+    return as<size_type>(as<unsigned_value>(last) >> 1);
+  }
+#else
+  static constexpr size_type long_flag =
+      size_type(1) << (sizeof(size_type) * CHAR_BIT - 1);
+  static constexpr unsigned_value long_marker =
+      unsigned_value(1) << (sizeof(TValue) * CHAR_BIT - 1);
+  static constexpr auto encode_remaining(size_type remaining) -> TValue {
+    return as<TValue>(remaining);
+  }
+  static constexpr auto decode_remaining(TValue last) -> size_type {
+    return as<size_type>(as<unsigned_value>(last));
+  }
+#endif
+
+  [[nodiscard]] inline auto is_long() const -> bool {
+    return (as<unsigned_value>(m_storage.m_rep.m_short[inline_capacity]) &
+            long_marker) != 0;
+  }
+
+  inline auto get_allocator() -> TAllocator & { return m_storage; }
+
+  inline auto set_short_length(size_type const len) -> void {
+    m_storage.m_rep.m_short[len] = TValue();
+    m_storage.m_rep.m_short[inline_capacity] =
+        encode_remaining(inline_capacity - len);
+  }
+
+  inline auto set_length(size_type const len) -> void {
+    ZINC_ASSERT(len <= capacity());
+    if (is_long()) {
+      m_storage.m_rep.m_long.m_size = len;
+      m_storage.m_rep.m_long.m_data[len] = TValue();
+    } else {
+      set_short_length(len);
+    }
+  }
+
+  // moves to a heap buffer that holds at least count elements, keeps the
+  // contents only when asked to
+  inline auto grow(size_type const count, bool const keep) -> void {
+    auto const old_capacity = capacity();
+    auto next = old_capacity * 2;
+    if (next < count)
+      next = count;
+
+    auto *buffer = alloc::allocate(get_allocator(), next + 1);
+    auto const len = keep ? length() : 0;
+    memcpy(buffer, data(), len * sizeof(TValue));
+    buffer[len] = TValue();
+    release();
+
+    m_storage.m_rep.m_long.m_data = buffer;
+    m_storage.m_rep.m_long.m_size = len;
+    m_storage.m_rep.m_long.m_capacity = next | long_flag;
+  }
+
+  inline auto release() -> void {
+    if (is_long())
+      alloc::deallocate(get_allocator(), m_storage.m_rep.m_long.m_data,
+                        capacity() + 1);
+  }
+
+  details::string_storage<TAllocator, rep> m_storage;
 };
 
 struct string_view {
 public:
   using size_type = usize;
+  using iterator = char const *;
+
+  static constexpr size_type npos = ~size_type(0);
 
   inline string_view() = default;
   inline string_view(char const *str) : m_str(str), m_len(strlen(str)) {}
@@ -136,6 +355,76 @@ public:
     return m_str[index];
   }
 
+  [[nodiscard]] inline auto begin() const -> iterator { return m_str; }
+  [[nodiscard]] inline auto end() const -> iterator { return m_str + m_len; }
+
+  [[nodiscard]] inline auto substr(size_type const pos,
+                                   size_type const count = npos) const
+      -> string_view {
+    ZINC_ASSERT(pos <= m_len);
+    auto const rest = m_len - pos;
+    return {m_str + pos, count < rest ? count : rest};
+  }
+
+  // searching, every position is relative to the start of the view
+  [[nodiscard]] inline auto find(char const value,
+                                 size_type const from = 0) const -> size_type {
+    if (from >= m_len)
+      return npos;
+    return offset(from, details::find_byte(m_str + from, m_len - from, value));
+  }
+  [[nodiscard]] inline auto find(string_view const &needle,
+                                 size_type const from = 0) const -> size_type {
+    if (from > m_len)
+      return npos;
+    return offset(from, details::find_bytes(m_str + from, m_len - from,
+                                            needle.m_str, needle.m_len));
+  }
+
+  // last match that starts at or before from
+  [[nodiscard]] inline auto rfind(char const value,
+                                  size_type const from = npos) const
+      -> size_type {
+    auto const end = from < m_len ? from + 1 : m_len;
+    return details::rfind_byte(m_str, end, value);
+  }
+  [[nodiscard]] inline auto rfind(string_view const &needle,
+                                  size_type const from = npos) const
+      -> size_type {
+    auto const end = from < m_len && needle.m_len <= m_len - from
+                         ? from + needle.m_len
+                         : m_len;
+    return details::rfind_bytes(m_str, end, needle.m_str, needle.m_len);
+  }
+
+  [[nodiscard]] inline auto find_first_of(string_view const &set,
+                                          size_type const from = 0) const
+      -> size_type {
+    if (from >= m_len)
+      return npos;
+    return offset(from, details::find_any_byte(m_str + from, m_len - from,
+                                               set.m_str, set.m_len));
+  }
+  [[nodiscard]] inline auto find_first_not_of(string_view const &set,
+                                              size_type const from = 0) const
+      -> size_type {
+    if (from >= m_len)
+      return npos;
+    return offset(from, details::find_not_any_byte(m_str + from, m_len - from,
+                                                   set.m_str, set.m_len));
+  }
+
+  [[nodiscard]] inline auto count(char const value) const -> size_type {
+    return details::count_byte(m_str, m_len, value);
+  }
+
+  // every field between delimiters, empty ones included
+  [[nodiscard]] inline auto split(char delimiter) const -> split_range;
+  // runs of non delimiter characters, like strtok but without touching the
+  // source
+  [[nodiscard]] inline auto tokenize(string_view const &delimiters) const
+      -> token_range;
+
   inline auto operator==(string_view const &other) const -> bool {
     if (m_len != other.m_len) {
       return false;
@@ -148,19 +437,148 @@ public:
   }
 
 private:
+  static inline auto offset(size_type const from, size_type const found)
+      -> size_type {
+    return found == npos ? npos : from + found;
+  }
+
   char const *m_str{nullptr};
   size_type m_len{0};
 };
 
-template <typename TValue, typename TAllocator>
-inline basic_string<TValue, TAllocator>::basic_string(string_view const &view,
-                                                      TAllocator &allocator)
-    : m_buffer(allocator) {
-  m_buffer.resize(view.length() + 1);
-  memcpy(m_buffer.data(), view.data(), view.length());
-  m_buffer[view.length()] = '\0';
+// Splitting never allocates, the iterators hand out views into the source and
+// only remember what is left of it.
+struct split_iterator {
+public:
+  // the end iterator
+  split_iterator() = default;
+  split_iterator(string_view const &source, char const delimiter)
+      : m_rest(source), m_delimiter(delimiter), m_done(false) {
+    advance();
+  }
+
+  inline auto operator*() const -> string_view const & { return m_current; }
+  inline auto operator->() const -> string_view const * { return &m_current; }
+
+  inline auto operator++() -> split_iterator & {
+    advance();
+    return *this;
+  }
+
+  inline auto operator==(split_iterator const &other) const -> bool {
+    return m_done == other.m_done &&
+           (m_done || m_current.data() == other.m_current.data());
+  }
+  inline auto operator!=(split_iterator const &other) const -> bool {
+    return !(*this == other);
+  }
+
+private:
+  inline void advance() {
+    if (m_last) {
+      m_done = true;
+      return;
+    }
+    auto const pos = m_rest.find(m_delimiter);
+    if (pos == string_view::npos) {
+      m_current = m_rest;
+      m_last = true;
+    } else {
+      m_current = m_rest.substr(0, pos);
+      m_rest = m_rest.substr(pos + 1);
+    }
+  }
+
+  string_view m_rest;
+  string_view m_current;
+  char m_delimiter{0};
+  bool m_last{false};
+  bool m_done{true};
+};
+
+struct token_iterator {
+public:
+  // the end iterator
+  token_iterator() = default;
+  token_iterator(string_view const &source, string_view const &delimiters)
+      : m_rest(source), m_delimiters(delimiters), m_done(false) {
+    advance();
+  }
+
+  inline auto operator*() const -> string_view const & { return m_current; }
+  inline auto operator->() const -> string_view const * { return &m_current; }
+
+  inline auto operator++() -> token_iterator & {
+    advance();
+    return *this;
+  }
+
+  inline auto operator==(token_iterator const &other) const -> bool {
+    return m_done == other.m_done &&
+           (m_done || m_current.data() == other.m_current.data());
+  }
+  inline auto operator!=(token_iterator const &other) const -> bool {
+    return !(*this == other);
+  }
+
+private:
+  inline void advance() {
+    auto const start = m_rest.find_first_not_of(m_delimiters);
+    if (start == string_view::npos) {
+      m_done = true;
+      return;
+    }
+    m_rest = m_rest.substr(start);
+    auto const end = m_rest.find_first_of(m_delimiters);
+    if (end == string_view::npos) {
+      m_current = m_rest;
+      m_rest = m_rest.substr(m_rest.length());
+    } else {
+      m_current = m_rest.substr(0, end);
+      m_rest = m_rest.substr(end + 1);
+    }
+  }
+
+  string_view m_rest;
+  string_view m_delimiters;
+  string_view m_current;
+  bool m_done{true};
+};
+
+struct split_range {
+  string_view m_source;
+  char m_delimiter;
+
+  [[nodiscard]] inline auto begin() const -> split_iterator {
+    return {m_source, m_delimiter};
+  }
+  [[nodiscard]] inline auto end() const -> split_iterator { return {}; }
+};
+
+struct token_range {
+  string_view m_source;
+  string_view m_delimiters;
+
+  [[nodiscard]] inline auto begin() const -> token_iterator {
+    return {m_source, m_delimiters};
+  }
+  [[nodiscard]] inline auto end() const -> token_iterator { return {}; }
+};
+
+inline auto string_view::split(char const delimiter) const -> split_range {
+  return {*this, delimiter};
 }
 
+inline auto string_view::tokenize(string_view const &delimiters) const
+    -> token_range {
+  return {*this, delimiters};
+}
+
+template <typename TValue, typename TAllocator>
+inline basic_string<TValue, TAllocator>::basic_string(
+    string_view const &view, TAllocator const &allocator)
+    : basic_string(view.data(), view.length(), allocator) {}
+
 template <typename TValue, typename TAllocator>
 inline auto basic_string<TValue, TAllocator>::as_string_view() const
     -> string_view {
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "base.h"
+#include "scoped_array.h"
+#include "string.h"
+#include "vector.h"
+
+namespace zinc {
+namespace details {
+auto sort_views(string_view *views, usize count, u32 threads) -> void;
+// sorts views and applies the same moves to order
+auto sort_views(string_view *views, usize *order, usize count, u32 threads)
+    -> void;
+} // namespace details
+
+// Sorts strings bytewise, the order memcmp gives with shorter strings first
+// on a tie. Large inputs go through an MSD radix sort that looks at every
+// byte once per level instead of comparing whole prefixes over and over,
+// small buckets finish with multikey quicksort. threads above one spreads
+// the buckets over that many threads, zero picks one per hardware thread.
+inline auto sort_strings(string_view *data, usize count, u32 threads = 1)
+    -> void {
+  details::sort_views(data, count, threads);
+}
+
+// Views into inline strings point into the string objects, so the strings
+// stay where they are until the order is known and are then moved along its
+// cycles.
+template <typename TAllocator>
+auto sort_strings(basic_string<char, TAllocator> *data, usize count,
+                  u32 threads = 1) -> void {
+  if (count < 2)
+    return;
+  scoped_array<string_view> views(new string_view[count]);
+  scoped_array<usize> order(new usize[count]);
+  for (usize i = 0; i < count; ++i) {
+    views.get()[i] = data[i].as_string_view();
+    order.get()[i] = i;
+  }
+  details::sort_views(views.get(), order.get(), count, threads);
+
+  auto *from = order.get();
+  for (usize i = 0; i < count; ++i) {
+    if (from[i] == i)
+      continue;
+    auto held = std::move(data[i]);
+    auto at = i;
+    while (from[at] != i) {
+      data[at] = std::move(data[from[at]]);
+      auto const next = from[at];
+      from[at] = at;
+      at = next;
+    }
+    data[at] = std::move(held);
+    from[at] = at;
+  }
+}
+
+template <typename TAllocator>
+auto sort_strings(vector<string_view, TAllocator> &items, u32 threads = 1)
+    -> void {
+  sort_strings(items.data(), items.size(), threads);
+}
+
+template <typename TStringAllocator, typename TAllocator>
+auto sort_strings(
+    vector<basic_string<char, TStringAllocator>, TAllocator> &items,
+    u32 threads = 1) -> void {
+  sort_strings(items.data(), items.size(), threads);
+}
+} // namespace zinc
\ No newline at end of file
@@ -11,6 +11,16 @@ static const u32 NANOSECONDS_PER_MICROSECOND = 1'000;
 static const u64 MILLISECONDS_PER_SECOND = 1'000;
 static const u64 MICROSECONDS_PER_SECOND = 1'000'000;
 
+struct duration;
+
+// Nanoseconds are always below a second, so a full second of them is None.
+// Declared ahead of duration, whose own methods already return options.
+template <> struct niche_traits<duration> {
+  static constexpr bool available = true;
+  static auto none() noexcept -> duration;
+  static auto is_none(duration const &value) noexcept -> bool;
+};
+
 struct duration {
   u64 m_seconds{0};
   u32 m_nanoseconds{0};
@@ -198,4 +208,15 @@ struct duration {
     return checked_div(rhs).value();
   }
 };
+
+inline auto niche_traits<duration>::none() noexcept -> duration {
+  duration value;
+  value.m_nanoseconds = NANOSECONDS_PER_SECOND;
+  return value;
+}
+
+inline auto niche_traits<duration>::is_none(duration const &value) noexcept
+    -> bool {
+  return value.m_nanoseconds == NANOSECONDS_PER_SECOND;
+}
 } // namespace zinc
\ No newline at end of file
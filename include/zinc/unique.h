@@ -67,12 +67,26 @@ private:
       } else {
         delete (m_raw_ptr);
       }
+      m_raw_ptr = nullptr;
     }
   }
   T *m_raw_ptr{nullptr};
   D m_deleter{nullptr};
 };
 
+// a pointer and a deleter, neither of which knows where it lives
+template <typename T, typename D>
+struct is_trivially_relocatable<unique<T, D>> : is_trivially_relocatable<D> {};
+
+// an empty unique is None
+template <typename T, typename D> struct niche_traits<unique<T, D>> {
+  static constexpr bool available = true;
+  static auto none() noexcept -> unique<T, D> { return nullptr; }
+  static auto is_none(unique<T, D> const &value) noexcept -> bool {
+    return !value;
+  }
+};
+
 template <typename T, typename... Args>
 auto make_unique(Args &&...args) -> unique<T> {
   return std::move(unique<T>(new T(std::forward<Args>(args)...)));
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "base.h"
+#include "option.h"
+#include "string.h"
+
+namespace zinc {
+namespace details {
+// decodes the sequence at data, returns how many bytes it took or zero when
+// it's malformed, overlong, a surrogate or past U+10FFFF
+auto decode_utf8(char const *data, usize available, char32_t &value) -> usize;
+} // namespace details
+
+[[nodiscard]] auto is_valid_utf8(string_view const &text) -> bool;
+
+// both expect valid input, count_code_points is also how many char32_t
+// utf8_to_utf32 writes and utf16_length how many char16_t utf8_to_utf16 does
+[[nodiscard]] auto count_code_points(string_view const &text) -> usize;
+[[nodiscard]] auto utf16_length(string_view const &text) -> usize;
+
+// Transcoders validate as they go and return how many units they wrote, or
+// None when the input is malformed. Output needs room for text.length()
+// units from UTF-8, for three bytes per char16_t and for four bytes per
+// char32_t; anything may have been written when they fail.
+auto utf8_to_utf16(string_view const &text, char16_t *out) -> option<usize>;
+auto utf8_to_utf32(string_view const &text, char32_t *out) -> option<usize>;
+auto utf16_to_utf8(char16_t const *data, usize length, char *out)
+    -> option<usize>;
+auto utf32_to_utf8(char32_t const *data, usize length, char *out)
+    -> option<usize>;
+
+// Walks the code points of a string_view. Malformed bytes come out one at a
+// time as U+FFFD so iteration always makes progress.
+struct utf8_view {
+  static constexpr char32_t replacement = 0xFFFD;
+
+  struct iterator {
+    using value_type = char32_t;
+
+    iterator(char const *cursor, char const *end)
+        : m_cursor(cursor), m_end(end) {
+      decode();
+    }
+
+    [[nodiscard]] auto operator*() const -> char32_t { return m_value; }
+    // where the current code point starts in the underlying text
+    [[nodiscard]] auto data() const -> char const * { return m_cursor; }
+
+    auto operator++() -> iterator & {
+      m_cursor += m_size;
+      decode();
+      return *this;
+    }
+
+    [[nodiscard]] auto operator==(iterator const &other) const -> bool {
+      return m_cursor == other.m_cursor;
+    }
+    [[nodiscard]] auto operator!=(iterator const &other) const -> bool {
+      return m_cursor != other.m_cursor;
+    }
+
+  private:
+    auto decode() -> void {
+      if (m_cursor == m_end) {
+        m_size = 0;
+        return;
+      }
+      if (as<u8>(*m_cursor) < 0x80) {
+        m_value = as<u8>(*m_cursor);
+        m_size = 1;
+        return;
+      }
+      m_size = as<u32>(details::decode_utf8(
+          m_cursor, as<usize>(m_end - m_cursor), m_value));
+      if (m_size == 0) {
+        m_value = replacement;
+        m_size = 1;
+      }
+    }
+
+    char const *m_cursor;
+    char const *m_end;
+    char32_t m_value = 0;
+    u32 m_size = 0;
+  };
+
+  explicit utf8_view(string_view const &text) : m_text(text) {}
+
+  [[nodiscard]] auto begin() const -> iterator {
+    return {m_text.data(), m_text.data() + m_text.length()};
+  }
+  [[nodiscard]] auto end() const -> iterator {
+    auto const *last = m_text.data() + m_text.length();
+    return {last, last};
+  }
+
+private:
+  string_view m_text;
+};
+} // namespace zinc
\ No newline at end of file
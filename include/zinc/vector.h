@@ -5,6 +5,8 @@
 #include "debug.h"
 #include "option.h"
 
+#include <limits>
+
 namespace zinc {
 template <typename TValue> struct array_view;
 
@@ -737,7 +739,7 @@ template <typename T> struct array_view {
   auto operator[](size_type pos) const -> const_reference { return m_arr[pos]; }
 
   auto at(size_type pos) const -> const_reference {
-    ZINC_ASSERTF(pos < m_size, "array_view::at")
+    ZINC_ASSERTF(pos < m_size, "array_view::at");
     return m_arr[pos];
   }
 
@@ -2,19 +2,36 @@
 
 #include "zinc/algorithm.h"
 #include "zinc/allocator/prelude.h"
+#include "zinc/atomic_shared.h"
 #include "zinc/base.h"
+#include "zinc/bits.h"
 #include "zinc/checked_int.h"
+#include "zinc/cord.h"
+#include "zinc/cpu.h"
 #include "zinc/debug.h"
 #include "zinc/enum.h"
+#include "zinc/format.h"
 #include "zinc/func.h"
+#include "zinc/hash.h"
+#include "zinc/inplace_func.h"
 #include "zinc/interface.h"
+#include "zinc/interner.h"
+#include "zinc/number.h"
 #include "zinc/option.h"
+#include "zinc/range.h"
 #include "zinc/ref.h"
 #include "zinc/ref_wrapper.h"
+#include "zinc/result.h"
+#include "zinc/search_index.h"
 #include "zinc/shared.h"
+#include "zinc/shared_string.h"
+#include "zinc/simd.h"
+#include "zinc/static_vector.h"
 #include "zinc/string.h"
+#include "zinc/string_sort.h"
 #include "zinc/time.h"
 #include "zinc/tuple.h"
 #include "zinc/unique.h"
 #include "zinc/unit.h"
+#include "zinc/utf8.h"
 #include "zinc/vector.h"
\ No newline at end of file
@@ -40,4 +40,9 @@ void pool::deallocate(vptr block) {
   }
 }
 
+void pool::deallocate(vptr const *blocks, usize count) {
+  for (usize i = 0; i < count; ++i)
+    deallocate(blocks[i]);
+}
+
 } // namespace zinc
\ No newline at end of file
@@ -0,0 +1,239 @@
+#include "zinc/cord.h"
+
+namespace zinc {
+namespace {
+constexpr usize min_buffer = 256;
+constexpr usize max_buffer = 64 * 1024;
+
+void acquire(details::cord_buffer *buffer) { buffer->m_refs.acquire(); }
+
+void release(details::cord_buffer *buffer) {
+  if (!buffer->m_refs.release())
+    ::operator delete(buffer);
+}
+
+// only the sole owner may grow a buffer, and only from the edge that a piece
+// ends at
+auto is_unique(details::cord_buffer const *buffer) -> bool {
+  return buffer->m_refs.use_count() == 1;
+}
+} // namespace
+
+cord::cord(cord const &other) {
+  reserve_pieces(other.m_count);
+  for (size_type i = 0; i < other.m_count; ++i) {
+    acquire(other.piece(i).m_buffer);
+    push_back(other.piece(i));
+  }
+  m_length = other.m_length;
+}
+
+cord::cord(cord &&other) noexcept
+    : m_pieces(other.m_pieces), m_head(other.m_head), m_count(other.m_count),
+      m_capacity(other.m_capacity), m_length(other.m_length) {
+  other.m_pieces = nullptr;
+  other.m_head = other.m_count = other.m_capacity = other.m_length = 0;
+}
+
+cord::~cord() {
+  clear();
+  delete[] m_pieces;
+}
+
+auto cord::operator=(cord const &other) -> cord & {
+  if (this != &other) {
+    cord copy(other);
+    *this = std::move(copy);
+  }
+  return *this;
+}
+
+auto cord::operator=(cord &&other) noexcept -> cord & {
+  if (this != &other) {
+    clear();
+    delete[] m_pieces;
+    m_pieces = other.m_pieces;
+    m_head = other.m_head;
+    m_count = other.m_count;
+    m_capacity = other.m_capacity;
+    m_length = other.m_length;
+    other.m_pieces = nullptr;
+    other.m_head = other.m_count = other.m_capacity = other.m_length = 0;
+  }
+  return *this;
+}
+
+void cord::clear() {
+  for (size_type i = 0; i < m_count; ++i)
+    release(piece(i).m_buffer);
+  m_head = m_count = m_length = 0;
+}
+
+void cord::reserve_pieces(size_type count) {
+  if (count <= m_capacity)
+    return;
+  auto capacity = m_capacity ? m_capacity : 4;
+  while (capacity < count)
+    capacity *= 2;
+  auto *pieces = new piece_type[capacity];
+  for (size_type i = 0; i < m_count; ++i)
+    pieces[i] = piece(i);
+  delete[] m_pieces;
+  m_pieces = pieces;
+  m_head = 0;
+  m_capacity = capacity;
+}
+
+void cord::push_back(piece_type const &value) {
+  reserve_pieces(m_count + 1);
+  piece(m_count) = value;
+  ++m_count;
+}
+
+void cord::push_front(piece_type const &value) {
+  reserve_pieces(m_count + 1);
+  m_head = (m_head + m_capacity - 1) & (m_capacity - 1);
+  ++m_count;
+  piece(0) = value;
+}
+
+auto cord::new_buffer(size_type needed) const -> details::cord_buffer * {
+  // buffers grow with the cord so a large one ends up with few pieces
+  auto capacity = m_length < min_buffer   ? min_buffer
+                  : m_length > max_buffer ? max_buffer
+                                          : m_length;
+  if (capacity < needed)
+    capacity = needed;
+  auto *buffer = static_cast<details::cord_buffer *>(
+      ::operator new(sizeof(details::cord_buffer) + capacity));
+  new (buffer) details::cord_buffer{{}, capacity, 0, 0};
+  buffer->m_refs.acquire();
+  return buffer;
+}
+
+void cord::append(string_view const &text) {
+  auto const *data = text.data();
+  auto remaining = text.length();
+  if (remaining == 0)
+    return;
+
+  if (m_count > 0) {
+    auto &last = piece(m_count - 1);
+    auto *buffer = last.m_buffer;
+    if (is_unique(buffer) && last.m_offset + last.m_length == buffer->m_end) {
+      auto const room = buffer->m_capacity - buffer->m_end;
+      auto const taken = room < remaining ? room : remaining;
+      memcpy(buffer->bytes() + buffer->m_end, data, taken);
+      buffer->m_end += taken;
+      last.m_length += taken;
+      m_length += taken;
+      data += taken;
+      remaining -= taken;
+    }
+  }
+
+  if (remaining > 0) {
+    auto *buffer = new_buffer(remaining);
+    memcpy(buffer->bytes(), data, remaining);
+    buffer->m_end = remaining;
+    push_back({buffer, 0, remaining});
+    m_length += remaining;
+  }
+}
+
+void cord::prepend(string_view const &text) {
+  auto remaining = text.length();
+  if (remaining == 0)
+    return;
+
+  if (m_count > 0) {
+    auto &first = piece(0);
+    auto *buffer = first.m_buffer;
+    if (is_unique(buffer) && first.m_offset == buffer->m_begin) {
+      auto const room = buffer->m_begin;
+      auto const taken = room < remaining ? room : remaining;
+      buffer->m_begin -= taken;
+      memcpy(buffer->bytes() + buffer->m_begin,
+             text.data() + remaining - taken, taken);
+      first.m_offset -= taken;
+      first.m_length += taken;
+      m_length += taken;
+      remaining -= taken;
+    }
+  }
+
+  if (remaining > 0) {
+    // filled from the back so later prepends land in front of it
+    auto *buffer = new_buffer(remaining);
+    auto const offset = buffer->m_capacity - remaining;
+    memcpy(buffer->bytes() + offset, text.data(), remaining);
+    buffer->m_begin = offset;
+    buffer->m_end = buffer->m_capacity;
+    push_front({buffer, offset, remaining});
+    m_length += remaining;
+  }
+}
+
+void cord::append(cord const &other) {
+  if (&other == this) {
+    cord copy(other);
+    append(copy);
+    return;
+  }
+  reserve_pieces(m_count + other.m_count);
+  for (size_type i = 0; i < other.m_count; ++i) {
+    acquire(other.piece(i).m_buffer);
+    push_back(other.piece(i));
+  }
+  m_length += other.m_length;
+}
+
+void cord::prepend(cord const &other) {
+  if (&other == this) {
+    cord copy(other);
+    prepend(copy);
+    return;
+  }
+  reserve_pieces(m_count + other.m_count);
+  for (size_type i = other.m_count; i > 0; --i) {
+    acquire(other.piece(i - 1).m_buffer);
+    push_front(other.piece(i - 1));
+  }
+  m_length += other.m_length;
+}
+
+auto cord::substr(size_type pos, size_type count) const -> cord {
+  ZINC_ASSERT(pos <= m_length);
+  if (count > m_length - pos)
+    count = m_length - pos;
+
+  cord result;
+  for (size_type i = 0; i < m_count && count > 0; ++i) {
+    auto current = piece(i);
+    if (pos >= current.m_length) {
+      pos -= current.m_length;
+      continue;
+    }
+    current.m_offset += pos;
+    current.m_length -= pos;
+    pos = 0;
+    if (current.m_length > count)
+      current.m_length = count;
+    count -= current.m_length;
+    acquire(current.m_buffer);
+    result.push_back(current);
+    result.m_length += current.m_length;
+  }
+  return result;
+}
+
+auto cord::copy_to(char *out) const -> size_type {
+  for (size_type i = 0; i < m_count; ++i) {
+    auto const &current = piece(i);
+    memcpy(out, current.m_buffer->bytes() + current.m_offset,
+           current.m_length);
+    out += current.m_length;
+  }
+  return m_length;
+}
+} // namespace zinc
\ No newline at end of file
@@ -0,0 +1,94 @@
+#include "zinc/cpu.h"
+
+#if ZINC_CPU_X86
+#if ZINC_COMPILER_MSVC && !ZINC_COMPILER_CLANG_CL
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+namespace zinc {
+namespace {
+#if ZINC_CPU_X86
+struct cpuid_result {
+  u32 eax, ebx, ecx, edx;
+};
+
+auto cpuid(u32 leaf, u32 subleaf) -> cpuid_result {
+  cpuid_result result{};
+#if ZINC_COMPILER_MSVC && !ZINC_COMPILER_CLANG_CL
+  int registers[4];
+  __cpuidex(registers, as<int>(leaf), as<int>(subleaf));
+  result = {as<u32>(registers[0]), as<u32>(registers[1]),
+            as<u32>(registers[2]), as<u32>(registers[3])};
+#else
+  if (leaf > __get_cpuid_max(leaf & 0x80000000, nullptr))
+    return result;
+  __cpuid_count(leaf, subleaf, result.eax, result.ebx, result.ecx,
+                result.edx);
+#endif
+  return result;
+}
+
+// which register files the operating system saves on a context switch
+auto xgetbv() -> u64 {
+#if ZINC_COMPILER_MSVC && !ZINC_COMPILER_CLANG_CL
+  return _xgetbv(0);
+#else
+  u32 low, high;
+  __asm__ volatile("xgetbv" : "=a"(low), "=d"(high) : "c"(0));
+  return (as<u64>(high) << 32) | low;
+#endif
+}
+#endif
+
+auto detect() -> cpu_features {
+  cpu_features features;
+#if ZINC_CPU_X86
+  auto const basic = cpuid(1, 0);
+  features.sse2 = basic.edx & (1u << 26);
+  features.ssse3 = basic.ecx & (1u << 9);
+  features.sse41 = basic.ecx & (1u << 19);
+  features.sse42 = basic.ecx & (1u << 20);
+  features.popcnt = basic.ecx & (1u << 23);
+
+  auto const osxsave = (basic.ecx & (1u << 27)) != 0;
+  auto const avx = (basic.ecx & (1u << 28)) != 0;
+  // the ymm upper halves have to be preserved or avx is unusable
+  auto const ymm_saved = osxsave && (xgetbv() & 0x6) == 0x6;
+  auto const extended = cpuid(7, 0);
+  features.avx2 = avx && ymm_saved && (extended.ebx & (1u << 5));
+  features.bmi2 = extended.ebx & (1u << 8);
+  // and for avx-512 the mask registers and the upper zmm registers too
+  auto const zmm_saved = ymm_saved && (xgetbv() & 0xE0) == 0xE0;
+  features.avx512f = zmm_saved && (extended.ebx & (1u << 16));
+  features.avx512bw = features.avx512f && (extended.ebx & (1u << 30));
+#elif defined(__ARM_NEON) || defined(__aarch64__) || defined(_M_ARM64)
+  features.neon = true;
+#endif
+  return features;
+}
+
+auto features() -> cpu_features & {
+  static auto detected = detect();
+  return detected;
+}
+} // namespace
+
+auto cpu() -> cpu_features const & { return features(); }
+
+void restrict_cpu_features(cpu_features const &allowed) {
+  auto &current = features();
+  current.sse2 &= allowed.sse2;
+  current.ssse3 &= allowed.ssse3;
+  current.sse41 &= allowed.sse41;
+  current.sse42 &= allowed.sse42;
+  current.popcnt &= allowed.popcnt;
+  current.avx2 &= allowed.avx2;
+  current.bmi2 &= allowed.bmi2;
+  current.avx512f &= allowed.avx512f;
+  current.avx512bw &= allowed.avx512bw;
+  current.neon &= allowed.neon;
+}
+} // namespace zinc
\ No newline at end of file
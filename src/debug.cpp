@@ -1,5 +1,7 @@
 #include "zinc/debug.h"
 
+#include "zinc/format.h"
+
 #if ZINC_PLATFORM_ANDROID
 #include <android/log.h>
 #elif ZINC_PLATFORM_WINDOWS
@@ -11,19 +13,21 @@ extern "C" __declspec(dllimport) void __stdcall OutputDebugStringA(
 namespace zinc {
 void DefaultAssertHandler(const char *text, const char *sourcefile, u32 line) {
   char output_text[2048];
-  if (sourcefile) {
-    snprintf(output_text, sizeof(output_text), "%s(%d): ASSERT FAILURE - ",
-             sourcefile, line);
-  } else {
-    strcpy_s(output_text, sizeof(output_text), "ASSERT FAILURE - ");
-  }
-  strcat_s(output_text, sizeof(output_text), text);
+  // room for the newline and terminator
+  auto sink = format_buffer(output_text, sizeof(output_text) - 2);
+  if (sourcefile)
+    format(sink, ZINC_FMT("{}({}): "), sourcefile, line);
+  format(sink, ZINC_FMT("ASSERT FAILURE - {}"), text);
+  auto length = sink.truncated() ? sizeof(output_text) - 2 : sink.length();
+#if ZINC_PLATFORM_WINDOWS
+  output_text[length++] = '\n';
+#endif
+  output_text[length] = '\0';
 
   // print
 #if ZINC_PLATFORM_ANDROID
   __android_log_write(ANDROID_LOG_DEBUG, "", output_text);
 #elif ZINC_PLATFORM_WINDOWS
-  strcat_s(output_text, sizeof(output_text), "\n");
   OutputDebugStringA(output_text);
 #else
   fputs(output_text, stderr);
@@ -37,14 +41,7 @@ void SetAssertCallback(AssertCallback *callback) {
   s_assert_handler = callback ? callback : DefaultAssertHandler;
 }
 
-void DebugMessage(const char *sourcefile, u32 line, const char *fmt...) {
-  char text[2048];
-
-  va_list args;
-  va_start(args, fmt);
-  vsnprintf(text, sizeof(text), fmt, args);
-  va_end(args);
-
+void DebugMessage(const char *sourcefile, u32 line, const char *text) {
   s_assert_handler(text, sourcefile, line);
 }
 } // namespace zinc
\ No newline at end of file
@@ -0,0 +1,105 @@
+#include "zinc/format.h"
+
+#if __has_include(<charconv>)
+#include <charconv>
+#endif
+#include <cstdio>
+
+namespace zinc::details {
+auto format_radix(char *out, u64 magnitude, bool negative, char type)
+    -> usize {
+  auto const *digits =
+      type == 'X' ? "0123456789ABCDEF" : "0123456789abcdef";
+  auto const shift = type == 'b' ? 1u : type == 'o' ? 3u : 4u;
+  auto const mask = (u64(1) << shift) - 1;
+
+  char buffer[64];
+  auto *cursor = buffer + sizeof(buffer);
+  do {
+    *--cursor = digits[magnitude & mask];
+    magnitude >>= shift;
+  } while (magnitude != 0);
+
+  auto *start = out;
+  if (negative)
+    *out++ = '-';
+  if (type == 'p') {
+    *out++ = '0';
+    *out++ = 'x';
+  }
+  auto const length = as<usize>(buffer + sizeof(buffer) - cursor);
+  memcpy(out, cursor, length);
+  return as<usize>(out + length - start);
+}
+
+auto format_float_fixed(char *out, f64 value, char type, i32 precision)
+    -> usize {
+  if (precision < 0)
+    precision = 6;
+  auto const scientific = type == 'e';
+  if (value - value != 0)
+    return format_float(out, value);
+#if defined(__cpp_lib_to_chars)
+  auto const result = std::to_chars(
+      out, out + 384, value,
+      scientific ? std::chars_format::scientific : std::chars_format::fixed,
+      precision);
+  return as<usize>(result.ptr - out);
+#else
+  return as<usize>(
+      snprintf(out, 384, scientific ? "%.*e" : "%.*f", precision, value));
+#endif
+}
+
+// picks the largest unit that keeps a whole part, 1.5s, 250ms, 3.2us, 40ns
+auto format_duration(char *out, duration const &value, i32 precision)
+    -> usize {
+  u64 whole;
+  u32 fraction;
+  u32 fraction_digits;
+  char const *unit;
+  if (value.m_seconds > 0 || value.m_nanoseconds == 0) {
+    whole = value.m_seconds;
+    fraction = value.m_nanoseconds;
+    fraction_digits = 9;
+    unit = "s";
+  } else if (value.m_nanoseconds >= NANOSECONDS_PER_MILLISECOND) {
+    whole = value.m_nanoseconds / NANOSECONDS_PER_MILLISECOND;
+    fraction = value.m_nanoseconds % NANOSECONDS_PER_MILLISECOND;
+    fraction_digits = 6;
+    unit = "ms";
+  } else if (value.m_nanoseconds >= NANOSECONDS_PER_MICROSECOND) {
+    whole = value.m_nanoseconds / NANOSECONDS_PER_MICROSECOND;
+    fraction = value.m_nanoseconds % NANOSECONDS_PER_MICROSECOND;
+    fraction_digits = 3;
+    unit = "us";
+  } else {
+    whole = value.m_nanoseconds;
+    fraction = 0;
+    fraction_digits = 0;
+    unit = "ns";
+  }
+
+  auto *cursor = out + format_int(out, whole);
+  char digits[9];
+  for (auto i = fraction_digits; i > 0; --i) {
+    digits[i - 1] = as<char>('0' + fraction % 10);
+    fraction /= 10;
+  }
+  // without a precision only the digits that matter are kept
+  auto shown = fraction_digits;
+  if (precision >= 0)
+    shown = as<u32>(precision) < shown ? as<u32>(precision) : shown;
+  else
+    while (shown > 0 && digits[shown - 1] == '0')
+      --shown;
+  if (shown > 0) {
+    *cursor++ = '.';
+    memcpy(cursor, digits, shown);
+    cursor += shown;
+  }
+  auto const unit_length = strlen(unit);
+  memcpy(cursor, unit, unit_length);
+  return as<usize>(cursor + unit_length - out);
+}
+} // namespace zinc::details
\ No newline at end of file
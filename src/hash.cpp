@@ -0,0 +1,91 @@
+#include "zinc/hash.h"
+
+namespace zinc {
+namespace {
+using details::hash_mix;
+using details::hash_read64;
+using details::hash_secret;
+
+// One 48 byte block over three independent multiply chains, so the
+// multiplies of a block overlap instead of waiting on each other.
+auto hash_block(u8 const *data, u64 &seed, u64 *lanes) -> void {
+  seed = hash_mix(hash_read64(data) ^ hash_secret[1],
+                  hash_read64(data + 8) ^ seed);
+  lanes[0] = hash_mix(hash_read64(data + 16) ^ hash_secret[2],
+                      hash_read64(data + 24) ^ lanes[0]);
+  lanes[1] = hash_mix(hash_read64(data + 32) ^ hash_secret[3],
+                      hash_read64(data + 40) ^ lanes[1]);
+}
+
+// The last one to 48 bytes. When fewer than 16 are left the final words
+// reach back into bytes that were already hashed, those must be readable.
+auto hash_tail(u8 const *data, usize size, u64 seed, u64 total) -> u64 {
+  while (size > 16) {
+    seed = hash_mix(hash_read64(data) ^ hash_secret[1],
+                    hash_read64(data + 8) ^ seed);
+    data += 16;
+    size -= 16;
+  }
+  return details::hash_finish(hash_read64(data + size - 16),
+                              hash_read64(data + size - 8), seed, total);
+}
+} // namespace
+
+namespace details {
+auto hash_long(u8 const *data, usize size, u64 seed) -> u64 {
+  auto const total = size;
+  if (size > 48) {
+    u64 lanes[2] = {seed, seed};
+    do {
+      hash_block(data, seed, lanes);
+      data += 48;
+      size -= 48;
+    } while (size > 48);
+    seed ^= lanes[0] ^ lanes[1];
+  }
+  return hash_tail(data, size, seed, total);
+}
+} // namespace details
+
+hasher::hasher(u64 seed)
+    : m_seed(details::hash_seed(seed)), m_lanes{m_seed, m_seed} {}
+
+// A block is only hashed once more input is known to follow it, the last one
+// to 48 bytes always go through hash_tail the way hash_long treats them.
+auto hasher::update(void const *data, usize size) -> hasher & {
+  auto const *input = static_cast<u8 const *>(data);
+  m_length += size;
+  while (size > 0) {
+    if (m_pending == block_size) {
+      hash_block(m_buffer + history, m_seed, m_lanes);
+      memcpy(m_buffer, m_buffer + block_size, history);
+      m_pending = 0;
+    }
+    if (m_pending == 0 && size > block_size) {
+      do {
+        hash_block(input, m_seed, m_lanes);
+        input += block_size;
+        size -= block_size;
+      } while (size > block_size);
+      memcpy(m_buffer, input - history, history);
+    }
+    auto const take = size < block_size - m_pending ? size
+                                                    : block_size - m_pending;
+    memcpy(m_buffer + history + m_pending, input, take);
+    m_pending += take;
+    input += take;
+    size -= take;
+  }
+  return *this;
+}
+
+auto hasher::finish() const -> u64 {
+  auto const *pending = m_buffer + history;
+  if (m_length <= 16)
+    return details::hash_short(pending, m_pending, m_seed);
+  auto seed = m_seed;
+  if (m_length > block_size)
+    seed ^= m_lanes[0] ^ m_lanes[1];
+  return hash_tail(pending, m_pending, seed, m_length);
+}
+} // namespace zinc
\ No newline at end of file
@@ -0,0 +1,183 @@
+#include "zinc/interner.h"
+
+#include "zinc/bits.h"
+
+namespace zinc {
+struct interner::entry {
+  char const *data;
+  u32 length;
+  u32 hash;
+};
+
+// Open addressing index of hash tag and id pairs, a zero slot is empty.
+// Replaced tables are kept until the interner goes away, readers may still
+// be probing them and they add up to less than the current one.
+struct interner::table {
+  usize mask;
+  table *previous;
+  std::atomic<u64> *slots;
+};
+
+struct interner::chunk {
+  chunk *next;
+  usize size;
+
+  auto bytes() -> char * { return reinterpret_cast<char *>(this + 1); }
+};
+
+namespace {
+constexpr usize chunk_size = 64 * 1024;
+constexpr usize initial_slots = 256;
+
+// only the upper half of the hash is kept, it picks the slot and is stored
+// next to the id to rule out most mismatches without touching the entry
+auto tag_of(u64 hash) -> u64 { return hash >> 32; }
+auto slot_value(u64 tag, u32 id) -> u64 {
+  return (tag << 32) | (as<u64>(id) + 1);
+}
+} // namespace
+
+auto interner::global() -> interner & {
+  // never destroyed so symbols stay resolvable during static destruction
+  static auto *instance = new interner();
+  return *instance;
+}
+
+interner::interner() {
+  auto *index = new table{initial_slots - 1, nullptr,
+                          new std::atomic<u64>[initial_slots]()};
+  m_table.store(index, std::memory_order_relaxed);
+}
+
+interner::~interner() {
+  for (auto *index = m_table.load(std::memory_order_relaxed); index;) {
+    auto *previous = index->previous;
+    delete[] index->slots;
+    delete index;
+    index = previous;
+  }
+  for (auto &segment : m_segments)
+    delete[] segment.load(std::memory_order_relaxed);
+  while (m_chunks) {
+    auto *next = m_chunks->next;
+    ::operator delete(m_chunks);
+    m_chunks = next;
+  }
+}
+
+auto interner::entry_at(u32 id) const -> entry const & {
+  auto const position = as<u64>(id) + (1u << first_segment_bits);
+  auto const segment = 63 - count_leading_zeros(position) - first_segment_bits;
+  auto const offset = position - (u64(1) << (segment + first_segment_bits));
+  return m_segments[segment].load(std::memory_order_acquire)[offset];
+}
+
+auto interner::lookup(table const &index, string_view const &text,
+                      u64 hash) const -> symbol {
+  auto const tag = tag_of(hash);
+  for (auto slot = as<usize>(tag) & index.mask;;
+       slot = (slot + 1) & index.mask) {
+    auto const value = index.slots[slot].load(std::memory_order_acquire);
+    if (value == 0)
+      return symbol();
+    if ((value >> 32) != tag)
+      continue;
+    auto const id = as<u32>(value) - 1;
+    auto const &candidate = entry_at(id);
+    if (candidate.length == text.length() &&
+        memcmp(candidate.data, text.data(), text.length()) == 0)
+      return symbol(id);
+  }
+}
+
+auto interner::find(string_view const &text) const -> symbol {
+  return lookup(*m_table.load(std::memory_order_acquire), text,
+                hash_value(text));
+}
+
+auto interner::intern(string_view const &text) -> symbol {
+  auto const hash = hash_value(text);
+  if (auto found = lookup(*m_table.load(std::memory_order_acquire), text,
+                          hash))
+    return found;
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  // someone may have added it while we were waiting
+  auto *index = m_table.load(std::memory_order_relaxed);
+  if (auto found = lookup(*index, text, hash))
+    return found;
+
+  auto const id = append(text, hash);
+  if ((as<usize>(id) + 1) * 2 > index->mask + 1) {
+    grow();
+    return symbol(id);
+  }
+  auto const tag = tag_of(hash);
+  auto slot = as<usize>(tag) & index->mask;
+  while (index->slots[slot].load(std::memory_order_relaxed) != 0)
+    slot = (slot + 1) & index->mask;
+  index->slots[slot].store(slot_value(tag, id), std::memory_order_release);
+  return symbol(id);
+}
+
+auto interner::resolve(symbol value) const -> string_view {
+  ZINC_ASSERTF(value.is_valid() && value.id() < size(),
+               "symbol does not belong to this interner");
+  auto const &found = entry_at(value.id());
+  return {found.data, found.length};
+}
+
+auto interner::store(string_view const &text) -> char const * {
+  auto const needed = text.length() + 1;
+  if (!m_chunks || m_chunk_used + needed > m_chunks->size) {
+    auto const size = needed > chunk_size ? needed : chunk_size;
+    auto *fresh =
+        static_cast<chunk *>(::operator new(sizeof(chunk) + size));
+    fresh->next = m_chunks;
+    fresh->size = size;
+    m_chunks = fresh;
+    m_chunk_used = 0;
+  }
+  auto *bytes = m_chunks->bytes() + m_chunk_used;
+  memcpy(bytes, text.data(), text.length());
+  bytes[text.length()] = '\0';
+  m_chunk_used += needed;
+  return bytes;
+}
+
+auto interner::append(string_view const &text, u64 hash) -> u32 {
+  auto const id = m_count.load(std::memory_order_relaxed);
+  ZINC_ASSERTF(id < symbol::invalid_id, "interner is full");
+  auto const position = as<u64>(id) + (1u << first_segment_bits);
+  auto const segment = 63 - count_leading_zeros(position) - first_segment_bits;
+  auto const offset = position - (u64(1) << (segment + first_segment_bits));
+
+  auto *entries = m_segments[segment].load(std::memory_order_relaxed);
+  if (!entries) {
+    entries = new entry[usize(1) << (segment + first_segment_bits)];
+    m_segments[segment].store(entries, std::memory_order_release);
+  }
+  entries[offset] = entry{store(text), as<u32>(text.length()),
+                          as<u32>(tag_of(hash))};
+  // the entry has to be visible before any slot or count names it
+  m_count.store(id + 1, std::memory_order_release);
+  return id;
+}
+
+void interner::grow() {
+  auto *current = m_table.load(std::memory_order_relaxed);
+  auto const capacity = (current->mask + 1) * 2;
+  auto *index =
+      new table{capacity - 1, current, new std::atomic<u64>[capacity]()};
+
+  auto const count = m_count.load(std::memory_order_relaxed);
+  for (u32 id = 0; id < count; ++id) {
+    auto const tag = as<u64>(entry_at(id).hash);
+    auto slot = as<usize>(tag) & index->mask;
+    while (index->slots[slot].load(std::memory_order_relaxed) != 0)
+      slot = (slot + 1) & index->mask;
+    index->slots[slot].store(slot_value(tag, id), std::memory_order_relaxed);
+  }
+  m_table.store(index, std::memory_order_release);
+}
+} // namespace zinc
\ No newline at end of file
@@ -2,16 +2,20 @@
 
 namespace zinc {
 barrier::barrier(usize thread_count)
-    : m_thread_count(thread_count), m_waiting_count(0) {}
+    : m_thread_count(thread_count), m_waiting_count(0),
+      m_generation(0) {}
 
 void barrier::wait() {
   std::unique_lock<std::mutex> lock(m_mutex);
   ++m_waiting_count;
   if (m_waiting_count == m_thread_count) {
     m_waiting_count = 0;
+    ++m_generation;
     m_condition.notify_all();
   } else {
-    m_condition.wait(lock, [this] { return m_waiting_count == 0; });
+    auto const generation = m_generation;
+    m_condition.wait(lock,
+                     [this, generation] { return m_generation != generation; });
   }
 }
 } // namespace zinc
\ No newline at end of file
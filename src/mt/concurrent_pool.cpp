@@ -0,0 +1,31 @@
+#include "zinc/mt/concurrent_pool.h"
+
+namespace zinc {
+concurrent_pool::concurrent_pool(usize granularity, usize size)
+    : m_pool(granularity, size) {}
+
+auto concurrent_pool::get_used() const -> usize {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_pool.get_used();
+}
+
+auto concurrent_pool::get_overflow() const -> usize {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_pool.get_overflow();
+}
+
+auto concurrent_pool::allocate() -> vptr {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_pool.allocate();
+}
+
+void concurrent_pool::deallocate(vptr block) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_pool.deallocate(block);
+}
+
+void concurrent_pool::deallocate(vptr const *blocks, usize count) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_pool.deallocate(blocks, count);
+}
+} // namespace zinc
\ No newline at end of file
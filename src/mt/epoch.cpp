@@ -0,0 +1,186 @@
+#include "zinc/mt/epoch.h"
+
+#include "zinc/debug.h"
+
+#include <limits>
+#include <thread>
+
+namespace zinc {
+// one per thread, recycled once the thread exits
+struct alignas(ZINC_CACHE_LINE_SIZE) epoch_domain::record {
+  std::atomic<u64> epoch{0};
+  std::atomic<bool> in_use{true};
+  record *next{nullptr};
+  u32 nesting{0};
+  retired *pending{nullptr};
+};
+
+// a batch of objects retired by one thread, stamped when it is published
+struct epoch_domain::retired {
+  retired_object objects[batch_size];
+  usize count{0};
+  u64 epoch{0};
+  retired *next{nullptr};
+};
+
+namespace {
+struct epoch_thread_slot {
+  epoch_domain::record *record{nullptr};
+
+  ~epoch_thread_slot() {
+    if (record) {
+      ZINC_ASSERTF(record->nesting == 0, "thread exited inside an epoch");
+      epoch_domain::global().flush();
+      record->epoch.store(0, std::memory_order_relaxed);
+      record->in_use.store(false, std::memory_order_release);
+    }
+  }
+};
+
+thread_local epoch_thread_slot t_slot;
+} // namespace
+
+auto epoch_domain::global() -> epoch_domain & {
+  // never destroyed, threads may still be leaving critical sections while
+  // static destructors run
+  static auto *domain = new epoch_domain();
+  return *domain;
+}
+
+auto epoch_domain::local_record() -> record & {
+  if (t_slot.record)
+    return *t_slot.record;
+
+  for (auto *it = m_records.load(std::memory_order_acquire); it;
+       it = it->next) {
+    auto free = false;
+    if (!it->in_use.load(std::memory_order_relaxed) &&
+        it->in_use.compare_exchange_strong(free, true,
+                                           std::memory_order_acquire)) {
+      t_slot.record = it;
+      return *it;
+    }
+  }
+
+  auto *fresh = new record();
+  auto *head = m_records.load(std::memory_order_relaxed);
+  do {
+    fresh->next = head;
+  } while (!m_records.compare_exchange_weak(
+      head, fresh, std::memory_order_release, std::memory_order_relaxed));
+  t_slot.record = fresh;
+  return *fresh;
+}
+
+void epoch_domain::enter() {
+  auto &local = local_record();
+  if (local.nesting++ == 0) {
+    local.epoch.store(m_epoch.load(std::memory_order_seq_cst),
+                      std::memory_order_relaxed);
+    // the announcement has to be visible before any shared pointer is read
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+  }
+}
+
+void epoch_domain::leave() {
+  auto &local = *t_slot.record;
+  ZINC_ASSERTF(local.nesting > 0, "unbalanced epoch_domain::leave");
+  if (--local.nesting == 0)
+    local.epoch.store(0, std::memory_order_release);
+}
+
+auto epoch_domain::in_critical_section() const -> bool {
+  return t_slot.record && t_slot.record->nesting > 0;
+}
+
+void epoch_domain::retire(retired_object const &object) {
+  auto &local = local_record();
+  if (!local.pending)
+    local.pending = new retired();
+  local.pending->objects[local.pending->count++] = object;
+  if (local.pending->count == batch_size) {
+    publish(local);
+    try_reclaim();
+  }
+}
+
+void epoch_domain::publish(record &local) {
+  auto *batch = local.pending;
+  if (!batch || batch->count == 0)
+    return;
+  local.pending = nullptr;
+  // stamping at publish time rather than per object is conservative, the
+  // epoch can only have moved forward since each object was unlinked
+  {
+    std::lock_guard<std::mutex> lock(m_retired_mutex);
+    batch->epoch = m_epoch.load(std::memory_order_seq_cst);
+    batch->next = m_retired;
+    m_retired = batch;
+  }
+  m_retired_count.fetch_add(batch->count, std::memory_order_relaxed);
+}
+
+void epoch_domain::flush() {
+  if (t_slot.record)
+    publish(*t_slot.record);
+}
+
+auto epoch_domain::min_active_epoch() const -> u64 {
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  auto min_epoch = std::numeric_limits<u64>::max();
+  for (auto *it = m_records.load(std::memory_order_acquire); it;
+       it = it->next) {
+    auto const epoch = it->epoch.load(std::memory_order_acquire);
+    if (epoch != 0 && epoch < min_epoch)
+      min_epoch = epoch;
+  }
+  return min_epoch;
+}
+
+auto epoch_domain::reclaim_before(u64 epoch) -> usize {
+  retired *ready = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(m_retired_mutex);
+    auto **link = &m_retired;
+    while (*link) {
+      auto *node = *link;
+      if (node->epoch < epoch) {
+        *link = node->next;
+        node->next = ready;
+        ready = node;
+      } else {
+        link = &node->next;
+      }
+    }
+  }
+
+  usize count = 0;
+  while (ready) {
+    auto *next = ready->next;
+    details::reclaim_retired(ready->objects, ready->count);
+    count += ready->count;
+    delete ready;
+    ready = next;
+  }
+  m_retired_count.fetch_sub(count, std::memory_order_relaxed);
+  return count;
+}
+
+void epoch_domain::synchronize() {
+  ZINC_ASSERTF(!in_critical_section(),
+               "synchronize inside a critical section would never return");
+  flush();
+  auto const target = m_epoch.fetch_add(1, std::memory_order_seq_cst) + 1;
+  while (min_active_epoch() < target)
+    std::this_thread::yield();
+  reclaim_before(target);
+}
+
+auto epoch_domain::try_reclaim() -> usize {
+  flush();
+  if (get_retired() == 0)
+    return 0;
+  m_epoch.fetch_add(1, std::memory_order_seq_cst);
+  return reclaim_before(min_active_epoch());
+}
+} // namespace zinc
\ No newline at end of file
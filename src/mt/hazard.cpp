@@ -0,0 +1,158 @@
+#include "zinc/mt/hazard.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace zinc {
+struct alignas(ZINC_CACHE_LINE_SIZE) hazard_domain::record {
+  std::atomic<vptr> slots[slots_per_thread]{};
+  std::atomic<bool> in_use{true};
+  std::atomic<usize> retired_count{0};
+  record *next{nullptr};
+  // only touched by the thread that owns the record
+  u32 used_slots{0};
+  std::vector<retired_object> retired;
+};
+
+namespace {
+struct hazard_thread_slot {
+  hazard_domain::record *record{nullptr};
+
+  ~hazard_thread_slot() {
+    if (record) {
+      ZINC_ASSERTF(record->used_slots == 0,
+                   "thread exited holding a hazard_pointer");
+      // whatever is still protected elsewhere stays on the record until
+      // another thread adopts it
+      hazard_domain::global().reclaim();
+      record->in_use.store(false, std::memory_order_release);
+    }
+  }
+};
+
+thread_local hazard_thread_slot t_slot;
+} // namespace
+
+auto hazard_domain::global() -> hazard_domain & {
+  // never destroyed, see epoch_domain::global
+  static auto *domain = new hazard_domain();
+  return *domain;
+}
+
+auto hazard_domain::local_record() -> record & {
+  if (t_slot.record)
+    return *t_slot.record;
+
+  for (auto *it = m_records.load(std::memory_order_acquire); it;
+       it = it->next) {
+    auto free = false;
+    if (!it->in_use.load(std::memory_order_relaxed) &&
+        it->in_use.compare_exchange_strong(free, true,
+                                           std::memory_order_acquire)) {
+      t_slot.record = it;
+      return *it;
+    }
+  }
+
+  auto *fresh = new record();
+  auto *head = m_records.load(std::memory_order_relaxed);
+  do {
+    fresh->next = head;
+  } while (!m_records.compare_exchange_weak(
+      head, fresh, std::memory_order_release, std::memory_order_relaxed));
+  m_record_count.fetch_add(1, std::memory_order_relaxed);
+  t_slot.record = fresh;
+  return *fresh;
+}
+
+auto hazard_domain::acquire_slot() -> std::atomic<vptr> & {
+  auto &local = local_record();
+  for (u32 i = 0; i < slots_per_thread; ++i) {
+    if (!(local.used_slots & (1u << i))) {
+      local.used_slots |= 1u << i;
+      return local.slots[i];
+    }
+  }
+  ZINC_ASSERTF(false, "out of hazard pointer slots");
+  std::abort();
+}
+
+void hazard_domain::release_slot(std::atomic<vptr> &slot) {
+  auto &local = *t_slot.record;
+  auto const index = as<u32>(&slot - local.slots);
+  ZINC_ASSERT(index < slots_per_thread);
+  slot.store(nullptr, std::memory_order_release);
+  local.used_slots &= ~(1u << index);
+}
+
+auto hazard_domain::threshold() const -> usize {
+  // keeping the list at least twice the number of slots means every scan
+  // frees at least half of it
+  auto const slots =
+      m_record_count.load(std::memory_order_relaxed) * slots_per_thread;
+  return std::max<usize>(2 * slots, 64);
+}
+
+void hazard_domain::retire(retired_object const &object) {
+  auto &local = local_record();
+  local.retired.push_back(object);
+  local.retired_count.store(local.retired.size(), std::memory_order_relaxed);
+  if (local.retired.size() >= threshold())
+    scan(local);
+}
+
+auto hazard_domain::reclaim() -> usize { return scan(local_record()); }
+
+auto hazard_domain::scan(record &local) -> usize {
+  // take over the lists of threads that have exited
+  for (auto *it = m_records.load(std::memory_order_acquire); it;
+       it = it->next) {
+    auto free = false;
+    if (it == &local || it->in_use.load(std::memory_order_relaxed) ||
+        !it->in_use.compare_exchange_strong(free, true,
+                                            std::memory_order_acquire))
+      continue;
+    local.retired.insert(local.retired.end(), it->retired.begin(),
+                         it->retired.end());
+    it->retired.clear();
+    it->retired_count.store(0, std::memory_order_relaxed);
+    it->in_use.store(false, std::memory_order_release);
+  }
+
+  // pairs with the fence implied by the seq_cst slot store in try_protect,
+  // every node was unlinked before it was retired so a reader that has not
+  // published it yet can no longer find it
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  std::vector<vptr> hazards;
+  for (auto *it = m_records.load(std::memory_order_acquire); it;
+       it = it->next) {
+    for (auto const &slot : it->slots) {
+      if (auto *pointer = slot.load(std::memory_order_acquire))
+        hazards.push_back(pointer);
+    }
+  }
+  std::sort(hazards.begin(), hazards.end());
+
+  auto const ready = std::stable_partition(
+      local.retired.begin(), local.retired.end(),
+      [&](retired_object const &object) {
+        return std::binary_search(hazards.begin(), hazards.end(),
+                                  object.object);
+      });
+  // a reclaim function may retire more objects, so move them out first
+  std::vector<retired_object> reclaimable(ready, local.retired.end());
+  local.retired.erase(ready, local.retired.end());
+  local.retired_count.store(local.retired.size(), std::memory_order_relaxed);
+
+  details::reclaim_retired(reclaimable.data(), reclaimable.size());
+  return reclaimable.size();
+}
+
+auto hazard_domain::get_retired() const -> usize {
+  usize count = 0;
+  for (auto *it = m_records.load(std::memory_order_acquire); it;
+       it = it->next)
+    count += it->retired_count.load(std::memory_order_relaxed);
+  return count;
+}
+} // namespace zinc
\ No newline at end of file
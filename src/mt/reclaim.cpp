@@ -0,0 +1,25 @@
+#include "zinc/mt/reclaim.h"
+
+namespace zinc::details {
+void reclaim_retired(retired_object const *objects, usize count) {
+  constexpr usize batch_size = 64;
+  vptr batch[batch_size];
+
+  usize i = 0;
+  while (i < count) {
+    auto const &first = objects[i];
+    if (!first.reclaim_batch) {
+      first.reclaim(first.object);
+      ++i;
+      continue;
+    }
+
+    usize filled = 0;
+    while (i < count && filled < batch_size &&
+           objects[i].reclaim_batch == first.reclaim_batch &&
+           objects[i].context == first.context)
+      batch[filled++] = objects[i++].object;
+    first.reclaim_batch(first.context, batch, filled);
+  }
+}
+} // namespace zinc::details
\ No newline at end of file
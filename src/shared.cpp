@@ -0,0 +1,170 @@
+#include "zinc/shared.h"
+
+#include "zinc/debug.h"
+
+namespace zinc {
+namespace details {
+// Owner records are recycled rather than freed, counts keep pointing at them
+// after the thread that created them is gone and the next thread to pick a
+// record up inherits its counts.
+struct biased_owner {
+  std::atomic<biased_count *> m_queue{nullptr};
+  std::atomic<bool> m_in_use{true};
+  biased_owner *m_next{nullptr};
+
+  auto settle_queue() -> usize {
+    usize count = 0;
+    auto *node = m_queue.exchange(nullptr, std::memory_order_acquire);
+    while (node) {
+      auto *next = node->m_next_queued;
+      node->settle();
+      node = next;
+      ++count;
+    }
+    return count;
+  }
+
+  // settles counts queued on a record no thread is holding
+  auto settle_orphan() -> void {
+    while (m_queue.load(std::memory_order_acquire)) {
+      auto in_use = false;
+      if (!m_in_use.compare_exchange_strong(in_use, true,
+                                            std::memory_order_acquire))
+        return;
+      settle_queue();
+      m_in_use.store(false, std::memory_order_release);
+    }
+  }
+
+  auto push(biased_count *count) -> void {
+    auto *head = m_queue.load(std::memory_order_relaxed);
+    do {
+      count->m_next_queued = head;
+    } while (!m_queue.compare_exchange_weak(head, count,
+                                            std::memory_order_release,
+                                            std::memory_order_relaxed));
+    if (!m_in_use.load(std::memory_order_acquire))
+      settle_orphan();
+  }
+};
+
+namespace {
+std::atomic<biased_owner *> s_biased_owners{nullptr};
+
+struct biased_owner_slot {
+  ~biased_owner_slot() {
+    auto *owner = t_biased_owner;
+    if (!owner)
+      return;
+    owner->settle_queue();
+    t_biased_owner = nullptr;
+    owner->m_in_use.store(false, std::memory_order_release);
+    owner->settle_orphan();
+  }
+};
+
+thread_local biased_owner_slot t_biased_owner_slot;
+
+auto local_biased_owner() -> biased_owner * {
+  if (t_biased_owner)
+    return t_biased_owner;
+
+  // touch the slot so its destructor runs when this thread exits
+  (void)&t_biased_owner_slot;
+
+  for (auto *it = s_biased_owners.load(std::memory_order_acquire); it;
+       it = it->m_next) {
+    auto in_use = false;
+    if (!it->m_in_use.load(std::memory_order_relaxed) &&
+        it->m_in_use.compare_exchange_strong(in_use, true,
+                                             std::memory_order_acquire)) {
+      t_biased_owner = it;
+      return it;
+    }
+  }
+
+  auto *fresh = new biased_owner();
+  auto *head = s_biased_owners.load(std::memory_order_relaxed);
+  do {
+    fresh->m_next = head;
+  } while (!s_biased_owners.compare_exchange_weak(head, fresh,
+                                                  std::memory_order_release,
+                                                  std::memory_order_relaxed));
+  t_biased_owner = fresh;
+  return fresh;
+}
+} // namespace
+} // namespace details
+
+biased_count::biased_count() : m_owner(details::local_biased_owner()) {}
+
+auto biased_count::reconcile() -> usize {
+  auto *owner = details::t_biased_owner;
+  return owner ? owner->settle_queue() : 0;
+}
+
+auto biased_count::merge() noexcept -> bool {
+  m_detached = true;
+  auto const value =
+      m_shared.fetch_add(merged_flag, std::memory_order_acq_rel) + merged_flag;
+  // a queued count is settled by reconcile, even if this was the last one
+  return count_of(value) != 0 || (value & queued_flag) != 0;
+}
+
+auto biased_count::try_acquire_shared() noexcept -> bool {
+  // only a merged count can be dead, before that the owner still holds at
+  // least one reference
+  auto value = m_shared.load(std::memory_order_relaxed);
+  for (;;) {
+    if ((value & merged_flag) && count_of(value) == 0)
+      return false;
+    if (m_shared.compare_exchange_weak(value, value + one,
+                                       std::memory_order_acquire,
+                                       std::memory_order_relaxed))
+      return true;
+  }
+}
+
+auto biased_count::release_shared() noexcept -> bool {
+  auto value = m_shared.fetch_sub(one, std::memory_order_acq_rel) - one;
+  if (value & merged_flag)
+    return count_of(value) != 0 || (value & queued_flag) != 0;
+  if (count_of(value) >= 0)
+    return true;
+
+  // the owner still holds the references this thread released, let it know
+  // so it can merge even if it never touches the count again
+  while (!(value & (merged_flag | queued_flag))) {
+    if (m_shared.compare_exchange_weak(value, value | queued_flag,
+                                       std::memory_order_acq_rel,
+                                       std::memory_order_relaxed)) {
+      m_owner->push(this);
+      break;
+    }
+  }
+  return true;
+}
+
+auto biased_count::settle() noexcept -> void {
+  if (!m_detached) {
+    m_detached = true;
+    auto const local = as<isize>(m_local.load(std::memory_order_relaxed));
+    m_local.store(0, std::memory_order_relaxed);
+    m_shared.fetch_add(local * one + merged_flag, std::memory_order_acq_rel);
+  }
+
+  auto value = m_shared.load(std::memory_order_acquire);
+  for (;;) {
+    ZINC_ASSERTF(count_of(value) >= 0, "merged biased count went negative");
+    if (count_of(value) == 0) {
+      if (m_reclaim)
+        m_reclaim(this);
+      return;
+    }
+    if (m_shared.compare_exchange_weak(value, value & ~queued_flag,
+                                       std::memory_order_acq_rel,
+                                       std::memory_order_acquire))
+      return;
+  }
+}
+} // namespace zinc
\ No newline at end of file
@@ -0,0 +1,45 @@
+#include "zinc/shared_string.h"
+
+#include <new>
+
+namespace zinc {
+namespace {
+auto make_block(char *adopted, usize extra) -> details::shared_string_block * {
+  auto *block = new (::operator new(sizeof(details::shared_string_block) +
+                                    extra)) details::shared_string_block;
+  block->m_adopted = adopted;
+  block->m_refs.acquire();
+  return block;
+}
+} // namespace
+
+shared_string::shared_string(string_view const &text)
+    : m_length(text.length()) {
+  if (m_length == 0)
+    return;
+  m_block = make_block(nullptr, m_length);
+  memcpy(m_block->bytes(), text.data(), m_length);
+  m_data = m_block->bytes();
+}
+
+shared_string::shared_string(string &&text) {
+  usize length, capacity;
+  auto *buffer = text.detach_buffer(length, capacity);
+  if (!buffer) {
+    *this = shared_string(text.as_string_view());
+    return;
+  }
+  m_block = make_block(buffer, 0);
+  m_data = buffer;
+  m_length = length;
+}
+
+auto shared_string::release() -> void {
+  if (!m_block || m_block->m_refs.release())
+    return;
+  // string buffers come from sys_allocator, which is operator new
+  ::operator delete(m_block->m_adopted);
+  m_block->~shared_string_block();
+  ::operator delete(m_block);
+}
+} // namespace zinc
\ No newline at end of file
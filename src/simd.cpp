@@ -0,0 +1,982 @@
+#include "zinc/simd.h"
+
+#include "zinc/bits.h"
+#include "zinc/cpu.h"
+
+// GCC 12 warns about the deliberately undefined registers its own avx-512
+// intrinsics start from
+#if ZINC_COMPILER_GCC
+#if __GNUC__ < 13
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+#endif
+
+#if ZINC_CPU_X86
+#include <immintrin.h>
+#endif
+
+namespace zinc::simd::details {
+namespace {
+auto features() -> cpu_features const & {
+  static auto const &detected = cpu();
+  return detected;
+}
+
+// integers wrap in 64 bits, floats add up in doubles
+template <typename TLane>
+using accumulator =
+    std::conditional_t<std::is_floating_point<TLane>::value, f64, u64>;
+
+template <typename TLane>
+auto widened(TLane value) -> accumulator<TLane> {
+  return as<accumulator<TLane>>(as<sum_type<TLane>>(value));
+}
+
+// scalar
+
+template <comparison op, typename TLane> auto holds(TLane a, TLane b) -> bool {
+  if constexpr (op == comparison::equal)
+    return a == b;
+  else if constexpr (op == comparison::not_equal)
+    return a != b;
+  else if constexpr (op == comparison::less)
+    return a < b;
+  else if constexpr (op == comparison::less_equal)
+    return a <= b;
+  else if constexpr (op == comparison::greater)
+    return a > b;
+  else
+    return a >= b;
+}
+
+template <typename TLane>
+auto find_scalar(TLane const *data, usize count, TLane value) -> usize {
+  for (usize i = 0; i < count; ++i) {
+    if (data[i] == value)
+      return i;
+  }
+  return npos;
+}
+
+template <comparison op, typename TLane>
+auto find_if_scalar(TLane const *data, usize count, TLane value, bool negate)
+    -> usize {
+  for (usize i = 0; i < count; ++i) {
+    if (holds<op>(data[i], value) != negate)
+      return i;
+  }
+  return npos;
+}
+
+template <typename TLane>
+auto count_scalar(TLane const *data, usize count, TLane value) -> usize {
+  usize found = 0;
+  for (usize i = 0; i < count; ++i)
+    found += data[i] == value;
+  return found;
+}
+
+// the comparisons are written so a NaN in value never replaces result
+template <typename TLane>
+auto merge(min_max_result<TLane> &result, TLane value) -> void {
+  result.min = value < result.min ? value : result.min;
+  result.max = result.max < value ? value : result.max;
+}
+
+template <typename TLane>
+auto min_max_scalar(TLane const *data, usize count) -> min_max_result<TLane> {
+  min_max_result<TLane> result{data[0], data[0]};
+  for (usize i = 1; i < count; ++i)
+    merge(result, data[i]);
+  return result;
+}
+
+template <typename TLane>
+auto sum_scalar(TLane const *data, usize count) -> accumulator<TLane> {
+  accumulator<TLane> total = 0;
+  for (usize i = 0; i < count; ++i)
+    total += widened(data[i]);
+  return total;
+}
+
+template <typename TLane>
+auto mismatch_scalar(TLane const *a, TLane const *b, usize count) -> usize {
+  for (usize i = 0; i < count; ++i) {
+    if (!(a[i] == b[i]))
+      return i;
+  }
+  return npos;
+}
+
+enum class kernel : u8 { find, find_if, count, min_max, sum, mismatch };
+
+#if ZINC_CPU_X86
+// Lane types wrap one instruction set for one element type. Comparisons
+// come back as bit masks with stride bits per element, the byte masks of
+// SSE and AVX2 giving every byte of an element its own bit. Sums widen
+// every vector into 64-bit lanes, where wide is the vector of those, and
+// report a bias they added to each element to use an unsigned instruction.
+
+template <typename TLane> struct sse_ints {
+  using lane = TLane;
+  using vec = __m128i;
+  using wide = __m128i;
+  static constexpr usize width = 16 / sizeof(TLane);
+  static constexpr usize stride = sizeof(TLane);
+  static constexpr u64 full = 0xFFFF;
+  static constexpr bool is_signed = std::is_signed<TLane>::value;
+  static constexpr i64 bias =
+      sizeof(TLane) == 1 && is_signed    ? 128
+      : sizeof(TLane) == 2 && !is_signed ? -32768
+                                         : 0;
+
+  ZINC_TARGET("sse4.2") static auto load(TLane const *data) -> vec {
+    return _mm_loadu_si128(reinterpret_cast<vec const *>(data));
+  }
+  ZINC_TARGET("sse4.2") static auto store(TLane *out, vec value) -> void {
+    _mm_storeu_si128(reinterpret_cast<vec *>(out), value);
+  }
+  ZINC_TARGET("sse4.2") static auto splat(TLane value) -> vec {
+    if constexpr (sizeof(TLane) == 1)
+      return _mm_set1_epi8(as<char>(value));
+    else if constexpr (sizeof(TLane) == 2)
+      return _mm_set1_epi16(as<short>(value));
+    else if constexpr (sizeof(TLane) == 4)
+      return _mm_set1_epi32(as<int>(value));
+    else
+      return _mm_set1_epi64x(as<long long>(value));
+  }
+  ZINC_TARGET("sse4.2") static auto bits(vec value) -> u64 {
+    return as<u32>(_mm_movemask_epi8(value));
+  }
+  ZINC_TARGET("sse4.2") static auto equal(vec a, vec b) -> vec {
+    if constexpr (sizeof(TLane) == 1)
+      return _mm_cmpeq_epi8(a, b);
+    else if constexpr (sizeof(TLane) == 2)
+      return _mm_cmpeq_epi16(a, b);
+    else if constexpr (sizeof(TLane) == 4)
+      return _mm_cmpeq_epi32(a, b);
+    else
+      return _mm_cmpeq_epi64(a, b);
+  }
+  // unsigned lanes flip their top bit so the signed compares order them
+  ZINC_TARGET("sse4.2") static auto greater(vec a, vec b) -> vec {
+    if constexpr (!is_signed) {
+      auto const top = splat(as<TLane>(TLane(1) << (8 * sizeof(TLane) - 1)));
+      a = _mm_xor_si128(a, top);
+      b = _mm_xor_si128(b, top);
+    }
+    if constexpr (sizeof(TLane) == 1)
+      return _mm_cmpgt_epi8(a, b);
+    else if constexpr (sizeof(TLane) == 2)
+      return _mm_cmpgt_epi16(a, b);
+    else if constexpr (sizeof(TLane) == 4)
+      return _mm_cmpgt_epi32(a, b);
+    else
+      return _mm_cmpgt_epi64(a, b);
+  }
+  template <comparison op>
+  ZINC_TARGET("sse4.2") static auto compare(vec a, vec b) -> u64 {
+    if constexpr (op == comparison::equal)
+      return bits(equal(a, b));
+    else if constexpr (op == comparison::not_equal)
+      return bits(equal(a, b)) ^ full;
+    else if constexpr (op == comparison::less)
+      return bits(greater(b, a));
+    else if constexpr (op == comparison::less_equal)
+      return bits(greater(a, b)) ^ full;
+    else if constexpr (op == comparison::greater)
+      return bits(greater(a, b));
+    else
+      return bits(greater(b, a)) ^ full;
+  }
+  ZINC_TARGET("sse4.2") static auto min(vec a, vec b) -> vec {
+    if constexpr (sizeof(TLane) == 1)
+      return is_signed ? _mm_min_epi8(a, b) : _mm_min_epu8(a, b);
+    else if constexpr (sizeof(TLane) == 2)
+      return is_signed ? _mm_min_epi16(a, b) : _mm_min_epu16(a, b);
+    else if constexpr (sizeof(TLane) == 4)
+      return is_signed ? _mm_min_epi32(a, b) : _mm_min_epu32(a, b);
+    else
+      return _mm_blendv_epi8(a, b, greater(a, b));
+  }
+  ZINC_TARGET("sse4.2") static auto max(vec a, vec b) -> vec {
+    if constexpr (sizeof(TLane) == 1)
+      return is_signed ? _mm_max_epi8(a, b) : _mm_max_epu8(a, b);
+    else if constexpr (sizeof(TLane) == 2)
+      return is_signed ? _mm_max_epi16(a, b) : _mm_max_epu16(a, b);
+    else if constexpr (sizeof(TLane) == 4)
+      return is_signed ? _mm_max_epi32(a, b) : _mm_max_epu32(a, b);
+    else
+      return _mm_blendv_epi8(a, b, greater(b, a));
+  }
+  ZINC_TARGET("sse4.2") static auto wide_zero() -> wide {
+    return _mm_setzero_si128();
+  }
+  ZINC_TARGET("sse4.2") static auto widen(vec value) -> wide {
+    if constexpr (sizeof(TLane) == 1) {
+      if constexpr (is_signed)
+        value = _mm_xor_si128(value, _mm_set1_epi8(as<char>(0x80)));
+      return _mm_sad_epu8(value, _mm_setzero_si128());
+    } else if constexpr (sizeof(TLane) == 2) {
+      if constexpr (!is_signed)
+        value = _mm_xor_si128(value, _mm_set1_epi16(as<short>(0x8000)));
+      auto const pairs = _mm_madd_epi16(value, _mm_set1_epi16(1));
+      return _mm_add_epi64(_mm_cvtepi32_epi64(pairs),
+                           _mm_cvtepi32_epi64(_mm_srli_si128(pairs, 8)));
+    } else if constexpr (sizeof(TLane) == 4) {
+      auto const high = _mm_srli_si128(value, 8);
+      if constexpr (is_signed)
+        return _mm_add_epi64(_mm_cvtepi32_epi64(value),
+                             _mm_cvtepi32_epi64(high));
+      else
+        return _mm_add_epi64(_mm_cvtepu32_epi64(value),
+                             _mm_cvtepu32_epi64(high));
+    } else {
+      return value;
+    }
+  }
+  ZINC_TARGET("sse4.2") static auto wide_add(wide a, wide b) -> wide {
+    return _mm_add_epi64(a, b);
+  }
+  ZINC_TARGET("sse4.2") static auto wide_total(wide value) -> u64 {
+    u64 parts[2];
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(parts), value);
+    return parts[0] + parts[1];
+  }
+};
+
+struct sse_f32 {
+  using lane = f32;
+  using vec = __m128;
+  using wide = __m128d;
+  static constexpr usize width = 4;
+  static constexpr usize stride = 1;
+  static constexpr u64 full = 0xF;
+  static constexpr i64 bias = 0;
+
+  ZINC_TARGET("sse4.2") static auto load(f32 const *data) -> vec {
+    return _mm_loadu_ps(data);
+  }
+  ZINC_TARGET("sse4.2") static auto store(f32 *out, vec value) -> void {
+    _mm_storeu_ps(out, value);
+  }
+  ZINC_TARGET("sse4.2") static auto splat(f32 value) -> vec {
+    return _mm_set1_ps(value);
+  }
+  template <comparison op>
+  ZINC_TARGET("sse4.2") static auto compare(vec a, vec b) -> u64 {
+    if constexpr (op == comparison::equal)
+      return as<u32>(_mm_movemask_ps(_mm_cmpeq_ps(a, b)));
+    else if constexpr (op == comparison::not_equal)
+      return as<u32>(_mm_movemask_ps(_mm_cmpneq_ps(a, b)));
+    else if constexpr (op == comparison::less)
+      return as<u32>(_mm_movemask_ps(_mm_cmplt_ps(a, b)));
+    else if constexpr (op == comparison::less_equal)
+      return as<u32>(_mm_movemask_ps(_mm_cmple_ps(a, b)));
+    else if constexpr (op == comparison::greater)
+      return as<u32>(_mm_movemask_ps(_mm_cmpgt_ps(a, b)));
+    else
+      return as<u32>(_mm_movemask_ps(_mm_cmpge_ps(a, b)));
+  }
+  // minps and maxps return their second operand when either is NaN
+  ZINC_TARGET("sse4.2") static auto min(vec a, vec b) -> vec {
+    return _mm_min_ps(a, b);
+  }
+  ZINC_TARGET("sse4.2") static auto max(vec a, vec b) -> vec {
+    return _mm_max_ps(a, b);
+  }
+  ZINC_TARGET("sse4.2") static auto wide_zero() -> wide {
+    return _mm_setzero_pd();
+  }
+  ZINC_TARGET("sse4.2") static auto widen(vec value) -> wide {
+    return _mm_add_pd(_mm_cvtps_pd(value),
+                      _mm_cvtps_pd(_mm_movehl_ps(value, value)));
+  }
+  ZINC_TARGET("sse4.2") static auto wide_add(wide a, wide b) -> wide {
+    return _mm_add_pd(a, b);
+  }
+  ZINC_TARGET("sse4.2") static auto wide_total(wide value) -> f64 {
+    f64 parts[2];
+    _mm_storeu_pd(parts, value);
+    return parts[0] + parts[1];
+  }
+};
+
+struct sse_f64 {
+  using lane = f64;
+  using vec = __m128d;
+  using wide = __m128d;
+  static constexpr usize width = 2;
+  static constexpr usize stride = 1;
+  static constexpr u64 full = 0x3;
+  static constexpr i64 bias = 0;
+
+  ZINC_TARGET("sse4.2") static auto load(f64 const *data) -> vec {
+    return _mm_loadu_pd(data);
+  }
+  ZINC_TARGET("sse4.2") static auto store(f64 *out, vec value) -> void {
+    _mm_storeu_pd(out, value);
+  }
+  ZINC_TARGET("sse4.2") static auto splat(f64 value) -> vec {
+    return _mm_set1_pd(value);
+  }
+  template <comparison op>
+  ZINC_TARGET("sse4.2") static auto compare(vec a, vec b) -> u64 {
+    if constexpr (op == comparison::equal)
+      return as<u32>(_mm_movemask_pd(_mm_cmpeq_pd(a, b)));
+    else if constexpr (op == comparison::not_equal)
+      return as<u32>(_mm_movemask_pd(_mm_cmpneq_pd(a, b)));
+    else if constexpr (op == comparison::less)
+      return as<u32>(_mm_movemask_pd(_mm_cmplt_pd(a, b)));
+    else if constexpr (op == comparison::less_equal)
+      return as<u32>(_mm_movemask_pd(_mm_cmple_pd(a, b)));
+    else if constexpr (op == comparison::greater)
+      return as<u32>(_mm_movemask_pd(_mm_cmpgt_pd(a, b)));
+    else
+      return as<u32>(_mm_movemask_pd(_mm_cmpge_pd(a, b)));
+  }
+  ZINC_TARGET("sse4.2") static auto min(vec a, vec b) -> vec {
+    return _mm_min_pd(a, b);
+  }
+  ZINC_TARGET("sse4.2") static auto max(vec a, vec b) -> vec {
+    return _mm_max_pd(a, b);
+  }
+  ZINC_TARGET("sse4.2") static auto wide_zero() -> wide {
+    return _mm_setzero_pd();
+  }
+  ZINC_TARGET("sse4.2") static auto widen(vec value) -> wide { return value; }
+  ZINC_TARGET("sse4.2") static auto wide_add(wide a, wide b) -> wide {
+    return _mm_add_pd(a, b);
+  }
+  ZINC_TARGET("sse4.2") static auto wide_total(wide value) -> f64 {
+    f64 parts[2];
+    _mm_storeu_pd(parts, value);
+    return parts[0] + parts[1];
+  }
+};
+
+template <typename TLane> struct avx2_ints {
+  using lane = TLane;
+  using vec = __m256i;
+  using wide = __m256i;
+  static constexpr usize width = 32 / sizeof(TLane);
+  static constexpr usize stride = sizeof(TLane);
+  static constexpr u64 full = 0xFFFFFFFF;
+  static constexpr bool is_signed = std::is_signed<TLane>::value;
+  static constexpr i64 bias = sse_ints<TLane>::bias;
+
+  ZINC_TARGET("avx2") static auto load(TLane const *data) -> vec {
+    return _mm256_loadu_si256(reinterpret_cast<vec const *>(data));
+  }
+  ZINC_TARGET("avx2") static auto store(TLane *out, vec value) -> void {
+    _mm256_storeu_si256(reinterpret_cast<vec *>(out), value);
+  }
+  ZINC_TARGET("avx2") static auto splat(TLane value) -> vec {
+    if constexpr (sizeof(TLane) == 1)
+      return _mm256_set1_epi8(as<char>(value));
+    else if constexpr (sizeof(TLane) == 2)
+      return _mm256_set1_epi16(as<short>(value));
+    else if constexpr (sizeof(TLane) == 4)
+      return _mm256_set1_epi32(as<int>(value));
+    else
+      return _mm256_set1_epi64x(as<long long>(value));
+  }
+  ZINC_TARGET("avx2") static auto bits(vec value) -> u64 {
+    return as<u32>(_mm256_movemask_epi8(value));
+  }
+  ZINC_TARGET("avx2") static auto equal(vec a, vec b) -> vec {
+    if constexpr (sizeof(TLane) == 1)
+      return _mm256_cmpeq_epi8(a, b);
+    else if constexpr (sizeof(TLane) == 2)
+      return _mm256_cmpeq_epi16(a, b);
+    else if constexpr (sizeof(TLane) == 4)
+      return _mm256_cmpeq_epi32(a, b);
+    else
+      return _mm256_cmpeq_epi64(a, b);
+  }
+  ZINC_TARGET("avx2") static auto greater(vec a, vec b) -> vec {
+    if constexpr (!is_signed) {
+      auto const top = splat(as<TLane>(TLane(1) << (8 * sizeof(TLane) - 1)));
+      a = _mm256_xor_si256(a, top);
+      b = _mm256_xor_si256(b, top);
+    }
+    if constexpr (sizeof(TLane) == 1)
+      return _mm256_cmpgt_epi8(a, b);
+    else if constexpr (sizeof(TLane) == 2)
+      return _mm256_cmpgt_epi16(a, b);
+    else if constexpr (sizeof(TLane) == 4)
+      return _mm256_cmpgt_epi32(a, b);
+    else
+      return _mm256_cmpgt_epi64(a, b);
+  }
+  template <comparison op>
+  ZINC_TARGET("avx2") static auto compare(vec a, vec b) -> u64 {
+    if constexpr (op == comparison::equal)
+      return bits(equal(a, b));
+    else if constexpr (op == comparison::not_equal)
+      return bits(equal(a, b)) ^ full;
+    else if constexpr (op == comparison::less)
+      return bits(greater(b, a));
+    else if constexpr (op == comparison::less_equal)
+      return bits(greater(a, b)) ^ full;
+    else if constexpr (op == comparison::greater)
+      return bits(greater(a, b));
+    else
+      return bits(greater(b, a)) ^ full;
+  }
+  ZINC_TARGET("avx2") static auto min(vec a, vec b) -> vec {
+    if constexpr (sizeof(TLane) == 1)
+      return is_signed ? _mm256_min_epi8(a, b) : _mm256_min_epu8(a, b);
+    else if constexpr (sizeof(TLane) == 2)
+      return is_signed ? _mm256_min_epi16(a, b) : _mm256_min_epu16(a, b);
+    else if constexpr (sizeof(TLane) == 4)
+      return is_signed ? _mm256_min_epi32(a, b) : _mm256_min_epu32(a, b);
+    else
+      return _mm256_blendv_epi8(a, b, greater(a, b));
+  }
+  ZINC_TARGET("avx2") static auto max(vec a, vec b) -> vec {
+    if constexpr (sizeof(TLane) == 1)
+      return is_signed ? _mm256_max_epi8(a, b) : _mm256_max_epu8(a, b);
+    else if constexpr (sizeof(TLane) == 2)
+      return is_signed ? _mm256_max_epi16(a, b) : _mm256_max_epu16(a, b);
+    else if constexpr (sizeof(TLane) == 4)
+      return is_signed ? _mm256_max_epi32(a, b) : _mm256_max_epu32(a, b);
+    else
+      return _mm256_blendv_epi8(a, b, greater(b, a));
+  }
+  ZINC_TARGET("avx2") static auto wide_zero() -> wide {
+    return _mm256_setzero_si256();
+  }
+  ZINC_TARGET("avx2") static auto widen(vec value) -> wide {
+    if constexpr (sizeof(TLane) == 1) {
+      if constexpr (is_signed)
+        value = _mm256_xor_si256(value, _mm256_set1_epi8(as<char>(0x80)));
+      return _mm256_sad_epu8(value, _mm256_setzero_si256());
+    } else if constexpr (sizeof(TLane) == 2) {
+      if constexpr (!is_signed)
+        value =
+            _mm256_xor_si256(value, _mm256_set1_epi16(as<short>(0x8000)));
+      auto const pairs = _mm256_madd_epi16(value, _mm256_set1_epi16(1));
+      return _mm256_add_epi64(
+          _mm256_cvtepi32_epi64(_mm256_castsi256_si128(pairs)),
+          _mm256_cvtepi32_epi64(_mm256_extracti128_si256(pairs, 1)));
+    } else if constexpr (sizeof(TLane) == 4) {
+      auto const low = _mm256_castsi256_si128(value);
+      auto const high = _mm256_extracti128_si256(value, 1);
+      if constexpr (is_signed)
+        return _mm256_add_epi64(_mm256_cvtepi32_epi64(low),
+                                _mm256_cvtepi32_epi64(high));
+      else
+        return _mm256_add_epi64(_mm256_cvtepu32_epi64(low),
+                                _mm256_cvtepu32_epi64(high));
+    } else {
+      return value;
+    }
+  }
+  ZINC_TARGET("avx2") static auto wide_add(wide a, wide b) -> wide {
+    return _mm256_add_epi64(a, b);
+  }
+  ZINC_TARGET("avx2") static auto wide_total(wide value) -> u64 {
+    u64 parts[4];
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(parts), value);
+    return parts[0] + parts[1] + parts[2] + parts[3];
+  }
+};
+
+// the ordered predicates are false for NaN and not_equal is true, like the
+// C++ operators
+template <comparison op> constexpr auto float_predicate() -> int {
+  if constexpr (op == comparison::equal)
+    return _CMP_EQ_OQ;
+  else if constexpr (op == comparison::not_equal)
+    return _CMP_NEQ_UQ;
+  else if constexpr (op == comparison::less)
+    return _CMP_LT_OQ;
+  else if constexpr (op == comparison::less_equal)
+    return _CMP_LE_OQ;
+  else if constexpr (op == comparison::greater)
+    return _CMP_GT_OQ;
+  else
+    return _CMP_GE_OQ;
+}
+
+struct avx2_f32 {
+  using lane = f32;
+  using vec = __m256;
+  using wide = __m256d;
+  static constexpr usize width = 8;
+  static constexpr usize stride = 1;
+  static constexpr u64 full = 0xFF;
+  static constexpr i64 bias = 0;
+
+  ZINC_TARGET("avx2") static auto load(f32 const *data) -> vec {
+    return _mm256_loadu_ps(data);
+  }
+  ZINC_TARGET("avx2") static auto store(f32 *out, vec value) -> void {
+    _mm256_storeu_ps(out, value);
+  }
+  ZINC_TARGET("avx2") static auto splat(f32 value) -> vec {
+    return _mm256_set1_ps(value);
+  }
+  template <comparison op>
+  ZINC_TARGET("avx2") static auto compare(vec a, vec b) -> u64 {
+    constexpr auto predicate = float_predicate<op>();
+    return as<u32>(_mm256_movemask_ps(_mm256_cmp_ps(a, b, predicate)));
+  }
+  ZINC_TARGET("avx2") static auto min(vec a, vec b) -> vec {
+    return _mm256_min_ps(a, b);
+  }
+  ZINC_TARGET("avx2") static auto max(vec a, vec b) -> vec {
+    return _mm256_max_ps(a, b);
+  }
+  ZINC_TARGET("avx2") static auto wide_zero() -> wide {
+    return _mm256_setzero_pd();
+  }
+  ZINC_TARGET("avx2") static auto widen(vec value) -> wide {
+    return _mm256_add_pd(_mm256_cvtps_pd(_mm256_castps256_ps128(value)),
+                         _mm256_cvtps_pd(_mm256_extractf128_ps(value, 1)));
+  }
+  ZINC_TARGET("avx2") static auto wide_add(wide a, wide b) -> wide {
+    return _mm256_add_pd(a, b);
+  }
+  ZINC_TARGET("avx2") static auto wide_total(wide value) -> f64 {
+    f64 parts[4];
+    _mm256_storeu_pd(parts, value);
+    return (parts[0] + parts[1]) + (parts[2] + parts[3]);
+  }
+};
+
+struct avx2_f64 {
+  using lane = f64;
+  using vec = __m256d;
+  using wide = __m256d;
+  static constexpr usize width = 4;
+  static constexpr usize stride = 1;
+  static constexpr u64 full = 0xF;
+  static constexpr i64 bias = 0;
+
+  ZINC_TARGET("avx2") static auto load(f64 const *data) -> vec {
+    return _mm256_loadu_pd(data);
+  }
+  ZINC_TARGET("avx2") static auto store(f64 *out, vec value) -> void {
+    _mm256_storeu_pd(out, value);
+  }
+  ZINC_TARGET("avx2") static auto splat(f64 value) -> vec {
+    return _mm256_set1_pd(value);
+  }
+  template <comparison op>
+  ZINC_TARGET("avx2") static auto compare(vec a, vec b) -> u64 {
+    constexpr auto predicate = float_predicate<op>();
+    return as<u32>(_mm256_movemask_pd(_mm256_cmp_pd(a, b, predicate)));
+  }
+  ZINC_TARGET("avx2") static auto min(vec a, vec b) -> vec {
+    return _mm256_min_pd(a, b);
+  }
+  ZINC_TARGET("avx2") static auto max(vec a, vec b) -> vec {
+    return _mm256_max_pd(a, b);
+  }
+  ZINC_TARGET("avx2") static auto wide_zero() -> wide {
+    return _mm256_setzero_pd();
+  }
+  ZINC_TARGET("avx2") static auto widen(vec value) -> wide { return value; }
+  ZINC_TARGET("avx2") static auto wide_add(wide a, wide b) -> wide {
+    return _mm256_add_pd(a, b);
+  }
+  ZINC_TARGET("avx2") static auto wide_total(wide value) -> f64 {
+    f64 parts[4];
+    _mm256_storeu_pd(parts, value);
+    return (parts[0] + parts[1]) + (parts[2] + parts[3]);
+  }
+};
+
+template <comparison op> constexpr auto integer_predicate() -> int {
+  if constexpr (op == comparison::equal)
+    return _MM_CMPINT_EQ;
+  else if constexpr (op == comparison::not_equal)
+    return _MM_CMPINT_NE;
+  else if constexpr (op == comparison::less)
+    return _MM_CMPINT_LT;
+  else if constexpr (op == comparison::less_equal)
+    return _MM_CMPINT_LE;
+  else if constexpr (op == comparison::greater)
+    return _MM_CMPINT_NLE;
+  else
+    return _MM_CMPINT_NLT;
+}
+
+// avx-512 compares straight into mask registers, one bit per element and
+// with unsigned forms, and has every min and max the narrower sets lack
+template <typename TLane> struct avx512_ints {
+  using lane = TLane;
+  using vec = __m512i;
+  using wide = __m512i;
+  static constexpr usize width = 64 / sizeof(TLane);
+  static constexpr usize stride = 1;
+  static constexpr u64 full = width == 64 ? ~u64(0) : (u64(1) << width) - 1;
+  static constexpr bool is_signed = std::is_signed<TLane>::value;
+  static constexpr i64 bias = sse_ints<TLane>::bias;
+
+  ZINC_TARGET("avx512f,avx512bw") static auto load(TLane const *data) -> vec {
+    return _mm512_loadu_si512(data);
+  }
+  ZINC_TARGET("avx512f,avx512bw")
+  static auto store(TLane *out, vec value) -> void {
+    _mm512_storeu_si512(out, value);
+  }
+  ZINC_TARGET("avx512f,avx512bw") static auto splat(TLane value) -> vec {
+    if constexpr (sizeof(TLane) == 1)
+      return _mm512_set1_epi8(as<char>(value));
+    else if constexpr (sizeof(TLane) == 2)
+      return _mm512_set1_epi16(as<short>(value));
+    else if constexpr (sizeof(TLane) == 4)
+      return _mm512_set1_epi32(as<int>(value));
+    else
+      return _mm512_set1_epi64(as<long long>(value));
+  }
+  template <comparison op>
+  ZINC_TARGET("avx512f,avx512bw") static auto compare(vec a, vec b) -> u64 {
+    constexpr auto predicate = integer_predicate<op>();
+    if constexpr (sizeof(TLane) == 1)
+      return is_signed ? _mm512_cmp_epi8_mask(a, b, predicate)
+                       : _mm512_cmp_epu8_mask(a, b, predicate);
+    else if constexpr (sizeof(TLane) == 2)
+      return is_signed ? _mm512_cmp_epi16_mask(a, b, predicate)
+                       : _mm512_cmp_epu16_mask(a, b, predicate);
+    else if constexpr (sizeof(TLane) == 4)
+      return is_signed ? _mm512_cmp_epi32_mask(a, b, predicate)
+                       : _mm512_cmp_epu32_mask(a, b, predicate);
+    else
+      return is_signed ? _mm512_cmp_epi64_mask(a, b, predicate)
+                       : _mm512_cmp_epu64_mask(a, b, predicate);
+  }
+  ZINC_TARGET("avx512f,avx512bw") static auto min(vec a, vec b) -> vec {
+    if constexpr (sizeof(TLane) == 1)
+      return is_signed ? _mm512_min_epi8(a, b) : _mm512_min_epu8(a, b);
+    else if constexpr (sizeof(TLane) == 2)
+      return is_signed ? _mm512_min_epi16(a, b) : _mm512_min_epu16(a, b);
+    else if constexpr (sizeof(TLane) == 4)
+      return is_signed ? _mm512_min_epi32(a, b) : _mm512_min_epu32(a, b);
+    else
+      return is_signed ? _mm512_min_epi64(a, b) : _mm512_min_epu64(a, b);
+  }
+  ZINC_TARGET("avx512f,avx512bw") static auto max(vec a, vec b) -> vec {
+    if constexpr (sizeof(TLane) == 1)
+      return is_signed ? _mm512_max_epi8(a, b) : _mm512_max_epu8(a, b);
+    else if constexpr (sizeof(TLane) == 2)
+      return is_signed ? _mm512_max_epi16(a, b) : _mm512_max_epu16(a, b);
+    else if constexpr (sizeof(TLane) == 4)
+      return is_signed ? _mm512_max_epi32(a, b) : _mm512_max_epu32(a, b);
+    else
+      return is_signed ? _mm512_max_epi64(a, b) : _mm512_max_epu64(a, b);
+  }
+  ZINC_TARGET("avx512f,avx512bw") static auto wide_zero() -> wide {
+    return _mm512_setzero_si512();
+  }
+  // both signed 32-bit halves of every 64-bit lane added, shifting in place
+  // instead of converting each half across the register
+  ZINC_TARGET("avx512f,avx512bw") static auto pair_sums(vec value) -> wide {
+    return _mm512_add_epi64(_mm512_srai_epi64(_mm512_slli_epi64(value, 32), 32),
+                            _mm512_srai_epi64(value, 32));
+  }
+  ZINC_TARGET("avx512f,avx512bw") static auto widen(vec value) -> wide {
+    if constexpr (sizeof(TLane) == 1) {
+      if constexpr (is_signed)
+        value = _mm512_xor_si512(value, _mm512_set1_epi8(as<char>(0x80)));
+      return _mm512_sad_epu8(value, _mm512_setzero_si512());
+    } else if constexpr (sizeof(TLane) == 2) {
+      if constexpr (!is_signed)
+        value =
+            _mm512_xor_si512(value, _mm512_set1_epi16(as<short>(0x8000)));
+      return pair_sums(_mm512_madd_epi16(value, _mm512_set1_epi16(1)));
+    } else if constexpr (sizeof(TLane) == 4) {
+      if constexpr (is_signed)
+        return pair_sums(value);
+      else
+        return _mm512_add_epi64(
+            _mm512_and_si512(value, _mm512_set1_epi64(0xFFFFFFFF)),
+            _mm512_srli_epi64(value, 32));
+    } else {
+      return value;
+    }
+  }
+  ZINC_TARGET("avx512f,avx512bw") static auto wide_add(wide a, wide b)
+      -> wide {
+    return _mm512_add_epi64(a, b);
+  }
+  // not _mm512_reduce_add_epi64, which adds as signed and may overflow
+  ZINC_TARGET("avx512f,avx512bw") static auto wide_total(wide value) -> u64 {
+    u64 parts[8];
+    _mm512_storeu_si512(parts, value);
+    return (parts[0] + parts[1]) + (parts[2] + parts[3]) +
+           ((parts[4] + parts[5]) + (parts[6] + parts[7]));
+  }
+};
+
+struct avx512_f32 {
+  using lane = f32;
+  using vec = __m512;
+  using wide = __m512d;
+  static constexpr usize width = 16;
+  static constexpr usize stride = 1;
+  static constexpr u64 full = 0xFFFF;
+  static constexpr i64 bias = 0;
+
+  ZINC_TARGET("avx512f,avx512bw") static auto load(f32 const *data) -> vec {
+    return _mm512_loadu_ps(data);
+  }
+  ZINC_TARGET("avx512f,avx512bw")
+  static auto store(f32 *out, vec value) -> void {
+    _mm512_storeu_ps(out, value);
+  }
+  ZINC_TARGET("avx512f,avx512bw") static auto splat(f32 value) -> vec {
+    return _mm512_set1_ps(value);
+  }
+  template <comparison op>
+  ZINC_TARGET("avx512f,avx512bw") static auto compare(vec a, vec b) -> u64 {
+    constexpr auto predicate = float_predicate<op>();
+    return _mm512_cmp_ps_mask(a, b, predicate);
+  }
+  ZINC_TARGET("avx512f,avx512bw") static auto min(vec a, vec b) -> vec {
+    return _mm512_min_ps(a, b);
+  }
+  ZINC_TARGET("avx512f,avx512bw") static auto max(vec a, vec b) -> vec {
+    return _mm512_max_ps(a, b);
+  }
+  ZINC_TARGET("avx512f,avx512bw") static auto wide_zero() -> wide {
+    return _mm512_setzero_pd();
+  }
+  ZINC_TARGET("avx512f,avx512bw") static auto widen(vec value) -> wide {
+    auto const high = _mm256_castpd_ps(
+        _mm512_extractf64x4_pd(_mm512_castps_pd(value), 1));
+    return _mm512_add_pd(_mm512_cvtps_pd(_mm512_castps512_ps256(value)),
+                         _mm512_cvtps_pd(high));
+  }
+  ZINC_TARGET("avx512f,avx512bw") static auto wide_add(wide a, wide b)
+      -> wide {
+    return _mm512_add_pd(a, b);
+  }
+  ZINC_TARGET("avx512f,avx512bw") static auto wide_total(wide value) -> f64 {
+    return _mm512_reduce_add_pd(value);
+  }
+};
+
+struct avx512_f64 {
+  using lane = f64;
+  using vec = __m512d;
+  using wide = __m512d;
+  static constexpr usize width = 8;
+  static constexpr usize stride = 1;
+  static constexpr u64 full = 0xFF;
+  static constexpr i64 bias = 0;
+
+  ZINC_TARGET("avx512f,avx512bw") static auto load(f64 const *data) -> vec {
+    return _mm512_loadu_pd(data);
+  }
+  ZINC_TARGET("avx512f,avx512bw")
+  static auto store(f64 *out, vec value) -> void {
+    _mm512_storeu_pd(out, value);
+  }
+  ZINC_TARGET("avx512f,avx512bw") static auto splat(f64 value) -> vec {
+    return _mm512_set1_pd(value);
+  }
+  template <comparison op>
+  ZINC_TARGET("avx512f,avx512bw") static auto compare(vec a, vec b) -> u64 {
+    constexpr auto predicate = float_predicate<op>();
+    return _mm512_cmp_pd_mask(a, b, predicate);
+  }
+  ZINC_TARGET("avx512f,avx512bw") static auto min(vec a, vec b) -> vec {
+    return _mm512_min_pd(a, b);
+  }
+  ZINC_TARGET("avx512f,avx512bw") static auto max(vec a, vec b) -> vec {
+    return _mm512_max_pd(a, b);
+  }
+  ZINC_TARGET("avx512f,avx512bw") static auto wide_zero() -> wide {
+    return _mm512_setzero_pd();
+  }
+  ZINC_TARGET("avx512f,avx512bw") static auto widen(vec value) -> wide {
+    return value;
+  }
+  ZINC_TARGET("avx512f,avx512bw") static auto wide_add(wide a, wide b)
+      -> wide {
+    return _mm512_add_pd(a, b);
+  }
+  ZINC_TARGET("avx512f,avx512bw") static auto wide_total(wide value) -> f64 {
+    return _mm512_reduce_add_pd(value);
+  }
+};
+
+template <typename TLane, typename TF32, typename TF64, typename TInts>
+using pick_lanes = std::conditional_t<
+    std::is_same<TLane, f32>::value, TF32,
+    std::conditional_t<std::is_same<TLane, f64>::value, TF64, TInts>>;
+
+template <typename TLane>
+using sse_lanes = pick_lanes<TLane, sse_f32, sse_f64, sse_ints<TLane>>;
+template <typename TLane>
+using avx2_lanes = pick_lanes<TLane, avx2_f32, avx2_f64, avx2_ints<TLane>>;
+template <typename TLane>
+using avx512_lanes =
+    pick_lanes<TLane, avx512_f32, avx512_f64, avx512_ints<TLane>>;
+
+// Every instruction set gets its own copy of the kernels compiled for it.
+// Vectors then only ever pass between functions built for the same
+// registers, which does not depend on the inliner getting rid of the calls.
+#if ZINC_COMPILER_CLANG
+#pragma clang attribute push(__attribute__((target("sse4.2,popcnt"))),   \
+                             apply_to = function)
+#elif ZINC_COMPILER_GCC
+#pragma GCC push_options
+#pragma GCC target("sse4.2,popcnt")
+#endif
+namespace sse42 {
+#include "simd_kernels.inl"
+} // namespace sse42
+#if ZINC_COMPILER_CLANG
+#pragma clang attribute pop
+#elif ZINC_COMPILER_GCC
+#pragma GCC pop_options
+#endif
+
+#if ZINC_COMPILER_CLANG
+#pragma clang attribute push(__attribute__((target("avx2,popcnt"))),     \
+                             apply_to = function)
+#elif ZINC_COMPILER_GCC
+#pragma GCC push_options
+#pragma GCC target("avx2,popcnt")
+#endif
+namespace avx2 {
+#include "simd_kernels.inl"
+} // namespace avx2
+#if ZINC_COMPILER_CLANG
+#pragma clang attribute pop
+#elif ZINC_COMPILER_GCC
+#pragma GCC pop_options
+#endif
+
+#if ZINC_COMPILER_CLANG
+#pragma clang attribute push(                                              \
+    __attribute__((target("avx512f,avx512bw,popcnt"))), apply_to = function)
+#elif ZINC_COMPILER_GCC
+#pragma GCC push_options
+#pragma GCC target("avx512f,avx512bw,popcnt")
+#endif
+namespace avx512 {
+#include "simd_kernels.inl"
+} // namespace avx512
+#if ZINC_COMPILER_CLANG
+#pragma clang attribute pop
+#elif ZINC_COMPILER_GCC
+#pragma GCC pop_options
+#endif
+#endif
+
+// Runs the kernel with the widest lanes the processor has. Returns false
+// when it has none, leaving the work to the scalar loops.
+template <kernel id, typename TLane, typename TResult, typename... TArgs>
+auto dispatch(TResult &result, TArgs... args) -> bool {
+#if ZINC_CPU_X86
+  if (features().avx512bw) {
+    result = avx512::run<id, avx512_lanes<TLane>>(args...);
+    return true;
+  }
+  if (features().avx2) {
+    result = avx2::run<id, avx2_lanes<TLane>>(args...);
+    return true;
+  }
+  if (features().sse42 && features().popcnt) {
+    result = sse42::run<id, sse_lanes<TLane>>(args...);
+    return true;
+  }
+#endif
+  return false;
+}
+} // namespace
+
+template <typename TLane>
+auto find(TLane const *data, usize count, TLane value) -> usize {
+  usize result;
+  if (dispatch<kernel::find, TLane>(result, data, count, value))
+    return result;
+  return find_scalar(data, count, value);
+}
+
+template <typename TLane>
+auto find_if(TLane const *data, usize count, comparison op, TLane value,
+             bool negate) -> usize {
+  usize result;
+  if (dispatch<kernel::find_if, TLane>(result, data, count, op, value, negate))
+    return result;
+  switch (op) {
+  case comparison::equal:
+    return find_if_scalar<comparison::equal>(data, count, value, negate);
+  case comparison::not_equal:
+    return find_if_scalar<comparison::not_equal>(data, count, value, negate);
+  case comparison::less:
+    return find_if_scalar<comparison::less>(data, count, value, negate);
+  case comparison::less_equal:
+    return find_if_scalar<comparison::less_equal>(data, count, value, negate);
+  case comparison::greater:
+    return find_if_scalar<comparison::greater>(data, count, value, negate);
+  case comparison::greater_equal:
+    return find_if_scalar<comparison::greater_equal>(data, count, value,
+                                                     negate);
+  }
+  return npos;
+}
+
+template <typename TLane>
+auto count(TLane const *data, usize count, TLane value) -> usize {
+  usize result;
+  if (dispatch<kernel::count, TLane>(result, data, count, value))
+    return result;
+  return count_scalar(data, count, value);
+}
+
+template <typename TLane>
+auto min_max(TLane const *data, usize count) -> min_max_result<TLane> {
+  min_max_result<TLane> result;
+  if (dispatch<kernel::min_max, TLane>(result, data, count))
+    return result;
+  return min_max_scalar(data, count);
+}
+
+template <typename TLane>
+auto sum(TLane const *data, usize count) -> sum_type<TLane> {
+  accumulator<TLane> result;
+  if (!dispatch<kernel::sum, TLane>(result, data, count))
+    result = sum_scalar(data, count);
+  return as<sum_type<TLane>>(result);
+}
+
+template <typename TLane>
+auto mismatch(TLane const *a, TLane const *b, usize count) -> usize {
+  usize result;
+  if (dispatch<kernel::mismatch, TLane>(result, a, b, count))
+    return result;
+  return mismatch_scalar(a, b, count);
+}
+
+#define ZINC_SIMD_INSTANTIATE(TLane)                                          \
+  template auto find(TLane const *, usize, TLane) -> usize;                   \
+  template auto find_if(TLane const *, usize, comparison, TLane, bool)        \
+      -> usize;                                                               \
+  template auto count(TLane const *, usize, TLane) -> usize;                  \
+  template auto min_max(TLane const *, usize) -> min_max_result<TLane>;       \
+  template auto sum(TLane const *, usize) -> sum_type<TLane>;                 \
+  template auto mismatch(TLane const *, TLane const *, usize) -> usize;
+
+ZINC_SIMD_INSTANTIATE(i8)
+ZINC_SIMD_INSTANTIATE(u8)
+ZINC_SIMD_INSTANTIATE(i16)
+ZINC_SIMD_INSTANTIATE(u16)
+ZINC_SIMD_INSTANTIATE(i32)
+ZINC_SIMD_INSTANTIATE(u32)
+ZINC_SIMD_INSTANTIATE(i64)
+ZINC_SIMD_INSTANTIATE(u64)
+ZINC_SIMD_INSTANTIATE(f32)
+ZINC_SIMD_INSTANTIATE(f64)
+
+#undef ZINC_SIMD_INSTANTIATE
+} // namespace zinc::simd::details
\ No newline at end of file
@@ -0,0 +1,196 @@
+// The generic kernels, included by simd.cpp once for every instruction set
+// with that set enabled for everything in here. Names from outside, the
+// lanes and the scalar loops, come from the enclosing namespace.
+
+// Kernels. Searches finish with one vector ending at the last element,
+// overlapping what was already checked, which cannot turn up an earlier
+// match and is cheaper than a scalar tail. Counts and sums cannot look at
+// an element twice and finish with the scalar loops.
+
+template <typename L> struct find_kernel {
+  using lane = typename L::lane;
+
+  static auto run(lane const *data, usize count, lane value) -> usize {
+    if (count < L::width)
+      return find_scalar(data, count, value);
+    auto const needle = L::splat(value);
+    usize i = 0;
+    for (; i + L::width <= count; i += L::width) {
+      auto const found = L::template compare<comparison::equal>(
+          L::load(data + i), needle);
+      if (found)
+        return i + count_trailing_zeros(found) / L::stride;
+    }
+    if (i == count)
+      return npos;
+    i = count - L::width;
+    auto const found =
+        L::template compare<comparison::equal>(L::load(data + i), needle);
+    return found ? i + count_trailing_zeros(found) / L::stride : npos;
+  }
+};
+
+template <typename L> struct find_if_kernel {
+  using lane = typename L::lane;
+
+  template <comparison op>
+  static auto search(lane const *data, usize count, lane value, bool negate)
+      -> usize {
+    if (count < L::width)
+      return find_if_scalar<op>(data, count, value, negate);
+    auto const bound = L::splat(value);
+    auto const flip = negate ? L::full : 0;
+    usize i = 0;
+    for (; i + L::width <= count; i += L::width) {
+      auto const found =
+          L::template compare<op>(L::load(data + i), bound) ^ flip;
+      if (found)
+        return i + count_trailing_zeros(found) / L::stride;
+    }
+    if (i == count)
+      return npos;
+    i = count - L::width;
+    auto const found = L::template compare<op>(L::load(data + i), bound) ^ flip;
+    return found ? i + count_trailing_zeros(found) / L::stride : npos;
+  }
+
+  static auto run(lane const *data, usize count, comparison op, lane value,
+                  bool negate) -> usize {
+    switch (op) {
+    case comparison::equal:
+      return search<comparison::equal>(data, count, value, negate);
+    case comparison::not_equal:
+      return search<comparison::not_equal>(data, count, value, negate);
+    case comparison::less:
+      return search<comparison::less>(data, count, value, negate);
+    case comparison::less_equal:
+      return search<comparison::less_equal>(data, count, value, negate);
+    case comparison::greater:
+      return search<comparison::greater>(data, count, value, negate);
+    case comparison::greater_equal:
+      return search<comparison::greater_equal>(data, count, value, negate);
+    }
+    return npos;
+  }
+};
+
+template <typename L> struct count_kernel {
+  using lane = typename L::lane;
+
+  static auto run(lane const *data, usize count, lane value) -> usize {
+    auto const needle = L::splat(value);
+    usize bits = 0;
+    usize i = 0;
+    for (; i + L::width <= count; i += L::width)
+      bits += popcount(L::template compare<comparison::equal>(
+          L::load(data + i), needle));
+    return bits / L::stride + count_scalar(data + i, count - i, value);
+  }
+};
+
+// four independent accumulators, so the loop is not held up by the
+// latency of min, max and add
+template <typename L> struct min_max_kernel {
+  using lane = typename L::lane;
+  using vec = typename L::vec;
+
+  static auto run(lane const *data, usize count) -> min_max_result<lane> {
+    if (count < L::width)
+      return min_max_scalar(data, count);
+    vec low[4], high[4];
+    for (usize k = 0; k < 4; ++k)
+      low[k] = high[k] = L::splat(data[0]);
+    usize i = 0;
+    for (; i + 4 * L::width <= count; i += 4 * L::width) {
+      for (usize k = 0; k < 4; ++k) {
+        auto const values = L::load(data + i + k * L::width);
+        low[k] = L::min(values, low[k]);
+        high[k] = L::max(values, high[k]);
+      }
+    }
+    for (; i + L::width <= count; i += L::width) {
+      auto const values = L::load(data + i);
+      low[0] = L::min(values, low[0]);
+      high[0] = L::max(values, high[0]);
+    }
+    // looking at elements twice does not change a minimum
+    auto const last = L::load(data + count - L::width);
+    low[0] = L::min(last, L::min(L::min(low[1], low[0]),
+                                 L::min(low[3], low[2])));
+    high[0] = L::max(last, L::max(L::max(high[1], high[0]),
+                                  L::max(high[3], high[2])));
+
+    lane lows[L::width], highs[L::width];
+    L::store(lows, low[0]);
+    L::store(highs, high[0]);
+    min_max_result<lane> result{data[0], data[0]};
+    for (usize k = 0; k < L::width; ++k) {
+      merge(result, lows[k]);
+      merge(result, highs[k]);
+    }
+    return result;
+  }
+};
+
+template <typename L> struct sum_kernel {
+  using lane = typename L::lane;
+  using wide = typename L::wide;
+
+  static auto run(lane const *data, usize count) -> accumulator<lane> {
+    wide partial[4];
+    for (usize k = 0; k < 4; ++k)
+      partial[k] = L::wide_zero();
+    usize i = 0;
+    for (; i + 4 * L::width <= count; i += 4 * L::width) {
+      for (usize k = 0; k < 4; ++k)
+        partial[k] = L::wide_add(
+            partial[k], L::widen(L::load(data + i + k * L::width)));
+    }
+    for (; i + L::width <= count; i += L::width)
+      partial[0] = L::wide_add(partial[0], L::widen(L::load(data + i)));
+    auto total = L::wide_total(
+        L::wide_add(L::wide_add(partial[0], partial[1]),
+                    L::wide_add(partial[2], partial[3])));
+    if constexpr (L::bias != 0)
+      total -= as<accumulator<lane>>(L::bias) * i;
+    return total + sum_scalar(data + i, count - i);
+  }
+};
+
+template <typename L> struct mismatch_kernel {
+  using lane = typename L::lane;
+
+  static auto run(lane const *a, lane const *b, usize count) -> usize {
+    if (count < L::width)
+      return mismatch_scalar(a, b, count);
+    usize i = 0;
+    for (; i + L::width <= count; i += L::width) {
+      auto const found = L::template compare<comparison::not_equal>(
+          L::load(a + i), L::load(b + i));
+      if (found)
+        return i + count_trailing_zeros(found) / L::stride;
+    }
+    if (i == count)
+      return npos;
+    i = count - L::width;
+    auto const found = L::template compare<comparison::not_equal>(
+        L::load(a + i), L::load(b + i));
+    return found ? i + count_trailing_zeros(found) / L::stride : npos;
+  }
+};
+
+template <kernel id, typename L, typename... TArgs>
+ZINC_FLATTEN auto run(TArgs... args) {
+  if constexpr (id == kernel::find)
+    return find_kernel<L>::run(args...);
+  else if constexpr (id == kernel::find_if)
+    return find_if_kernel<L>::run(args...);
+  else if constexpr (id == kernel::count)
+    return count_kernel<L>::run(args...);
+  else if constexpr (id == kernel::min_max)
+    return min_max_kernel<L>::run(args...);
+  else if constexpr (id == kernel::sum)
+    return sum_kernel<L>::run(args...);
+  else
+    return mismatch_kernel<L>::run(args...);
+}
\ No newline at end of file
@@ -0,0 +1,509 @@
+#include "zinc/string.h"
+
+#include "zinc/bits.h"
+#include "zinc/cpu.h"
+
+#if ZINC_CPU_X86
+#include <immintrin.h>
+#endif
+
+namespace zinc::details {
+namespace {
+constexpr usize not_found = ~usize(0);
+
+auto features() -> cpu_features const & {
+  static auto const &detected = cpu();
+  return detected;
+}
+
+// scalar
+
+auto find_byte_scalar(char const *data, usize length, char value) -> usize {
+  auto const *found = static_cast<char const *>(memchr(data, value, length));
+  return found ? as<usize>(found - data) : not_found;
+}
+
+auto rfind_byte_scalar(char const *data, usize length, char value) -> usize {
+  while (length > 0) {
+    if (data[--length] == value)
+      return length;
+  }
+  return not_found;
+}
+
+auto count_byte_scalar(char const *data, usize length, char value) -> usize {
+  usize count = 0;
+  for (usize i = 0; i < length; ++i)
+    count += data[i] == value;
+  return count;
+}
+
+// small sets are cheaper to compare against than to build a table for
+template <bool negate>
+auto find_any_scalar(char const *data, usize length, char const *set,
+                     usize set_length) -> usize {
+  if (set_length <= 8) {
+    for (usize i = 0; i < length; ++i) {
+      auto hit = false;
+      for (usize j = 0; j < set_length; ++j)
+        hit |= data[i] == set[j];
+      if (hit != negate)
+        return i;
+    }
+    return not_found;
+  }
+
+  bool table[256] = {};
+  for (usize j = 0; j < set_length; ++j)
+    table[as<u8>(set[j])] = true;
+  for (usize i = 0; i < length; ++i) {
+    if (table[as<u8>(data[i])] != negate)
+      return i;
+  }
+  return not_found;
+}
+
+auto find_bytes_scalar(char const *data, usize length, char const *needle,
+                       usize needle_length) -> usize {
+  auto const limit = length - needle_length + 1;
+  usize i = 0;
+  while (i < limit) {
+    auto const found = find_byte_scalar(data + i, limit - i, needle[0]);
+    if (found == not_found)
+      return not_found;
+    i += found;
+    if (memcmp(data + i + 1, needle + 1, needle_length - 1) == 0)
+      return i;
+    ++i;
+  }
+  return not_found;
+}
+
+#if ZINC_CPU_X86
+// Every kernel walks full vectors and then finishes with one load that ends
+// at the last byte, overlapping what was already checked, which is cheaper
+// than a scalar tail. Inputs shorter than a vector drop to the narrower
+// kernel.
+
+ZINC_TARGET("sse2")
+auto load16(char const *data) -> __m128i {
+  return _mm_loadu_si128(reinterpret_cast<__m128i const *>(data));
+}
+
+ZINC_TARGET("avx2")
+auto load32(char const *data) -> __m256i {
+  return _mm256_loadu_si256(reinterpret_cast<__m256i const *>(data));
+}
+
+ZINC_TARGET("sse2")
+auto match16(char const *data, __m128i needle) -> u32 {
+  return as<u32>(_mm_movemask_epi8(_mm_cmpeq_epi8(load16(data), needle)));
+}
+
+ZINC_TARGET("avx2")
+auto match32(char const *data, __m256i needle) -> u32 {
+  return as<u32>(
+      _mm256_movemask_epi8(_mm256_cmpeq_epi8(load32(data), needle)));
+}
+
+ZINC_TARGET("sse2")
+auto find_byte_sse2(char const *data, usize length, char value) -> usize {
+  if (length < 16)
+    return find_byte_scalar(data, length, value);
+  auto const needle = _mm_set1_epi8(value);
+  usize i = 0;
+  for (; i + 16 <= length; i += 16) {
+    if (auto const mask = match16(data + i, needle))
+      return i + count_trailing_zeros(mask);
+  }
+  if (i == length)
+    return not_found;
+  auto const start = length - 16;
+  auto const mask = match16(data + start, needle) & (~0u << (i - start));
+  return mask ? start + count_trailing_zeros(mask) : not_found;
+}
+
+ZINC_TARGET("avx2")
+auto find_byte_avx2(char const *data, usize length, char value) -> usize {
+  if (length < 32)
+    return find_byte_sse2(data, length, value);
+  auto const needle = _mm256_set1_epi8(value);
+  if (auto const mask = match32(data, needle))
+    return count_trailing_zeros(mask);
+  // continue from the next aligned address so no load splits a cache line,
+  // then two vectors per iteration with a single test
+  usize i = 32 - (as<uptr>(data) & 31);
+  for (; i + 64 <= length; i += 64) {
+    auto const low = _mm256_cmpeq_epi8(load32(data + i), needle);
+    auto const high = _mm256_cmpeq_epi8(load32(data + i + 32), needle);
+    if (!_mm256_testz_si256(_mm256_or_si256(low, high),
+                            _mm256_or_si256(low, high))) {
+      auto const mask =
+          (as<u64>(as<u32>(_mm256_movemask_epi8(high))) << 32) |
+          as<u32>(_mm256_movemask_epi8(low));
+      return i + count_trailing_zeros(mask);
+    }
+  }
+  for (; i + 32 <= length; i += 32) {
+    if (auto const mask = match32(data + i, needle))
+      return i + count_trailing_zeros(mask);
+  }
+  if (i == length)
+    return not_found;
+  auto const start = length - 32;
+  auto const mask = match32(data + start, needle) & (~0u << (i - start));
+  return mask ? start + count_trailing_zeros(mask) : not_found;
+}
+
+ZINC_TARGET("sse2")
+auto rfind_byte_sse2(char const *data, usize length, char value) -> usize {
+  if (length < 16)
+    return rfind_byte_scalar(data, length, value);
+  auto const needle = _mm_set1_epi8(value);
+  auto end = length;
+  for (; end >= 16; end -= 16) {
+    if (auto const mask = match16(data + end - 16, needle))
+      return end - 16 + 31 - count_leading_zeros(mask);
+  }
+  if (end == 0)
+    return not_found;
+  auto const mask = match16(data, needle) & ((1u << end) - 1);
+  return mask ? 31 - count_leading_zeros(mask) : not_found;
+}
+
+ZINC_TARGET("avx2")
+auto rfind_byte_avx2(char const *data, usize length, char value) -> usize {
+  if (length < 32)
+    return rfind_byte_sse2(data, length, value);
+  auto const needle = _mm256_set1_epi8(value);
+  auto end = length;
+  for (; end >= 32; end -= 32) {
+    if (auto const mask = match32(data + end - 32, needle))
+      return end - 32 + 31 - count_leading_zeros(mask);
+  }
+  if (end == 0)
+    return not_found;
+  auto const mask = match32(data, needle) & ((1u << end) - 1);
+  return mask ? 31 - count_leading_zeros(mask) : not_found;
+}
+
+ZINC_TARGET("sse2")
+auto count_byte_sse2(char const *data, usize length, char value) -> usize {
+  if (length < 16)
+    return count_byte_scalar(data, length, value);
+  auto const needle = _mm_set1_epi8(value);
+  usize count = 0;
+  usize i = 0;
+  for (; i + 16 <= length; i += 16)
+    count += popcount(match16(data + i, needle));
+  if (i == length)
+    return count;
+  auto const start = length - 16;
+  return count +
+         popcount(match16(data + start, needle) & (~0u << (i - start)));
+}
+
+ZINC_TARGET("avx2,popcnt")
+auto count_byte_avx2(char const *data, usize length, char value) -> usize {
+  if (length < 32)
+    return count_byte_sse2(data, length, value);
+  auto const needle = _mm256_set1_epi8(value);
+  usize count = 0;
+  usize i = 0;
+  for (; i + 32 <= length; i += 32)
+    count += popcount(match32(data + i, needle));
+  if (i == length)
+    return count;
+  auto const start = length - 32;
+  return count +
+         popcount(match32(data + start, needle) & (~0u << (i - start)));
+}
+
+// sse2 has no byte shuffle, so sets are compared one member at a time
+template <bool negate>
+ZINC_TARGET("sse2")
+auto match_any16(char const *data, __m128i const *set, usize set_length)
+    -> u32 {
+  auto const block = load16(data);
+  auto hits = _mm_setzero_si128();
+  for (usize j = 0; j < set_length; ++j)
+    hits = _mm_or_si128(hits, _mm_cmpeq_epi8(block, set[j]));
+  auto const mask = as<u32>(_mm_movemask_epi8(hits));
+  return negate ? ~mask & 0xffff : mask;
+}
+
+template <bool negate>
+ZINC_TARGET("sse2")
+auto find_any_sse2(char const *data, usize length, char const *set,
+                   usize set_length) -> usize {
+  if (length < 16 || set_length > 16)
+    return find_any_scalar<negate>(data, length, set, set_length);
+  __m128i members[16];
+  for (usize j = 0; j < set_length; ++j)
+    members[j] = _mm_set1_epi8(set[j]);
+  usize i = 0;
+  for (; i + 16 <= length; i += 16) {
+    if (auto const mask = match_any16<negate>(data + i, members, set_length))
+      return i + count_trailing_zeros(mask);
+  }
+  if (i == length)
+    return not_found;
+  auto const start = length - 16;
+  auto const mask = match_any16<negate>(data + start, members, set_length) &
+                    (~0u << (i - start));
+  return mask ? start + count_trailing_zeros(mask) : not_found;
+}
+
+// Classifies every byte with two 16 entry lookups. The low nibble selects a
+// row of eight bits, one per high nibble, and the high nibble selects the
+// bit. High nibbles 8 to 15 use a second row table picked by the sign bit.
+struct nibble_set {
+  __m256i low_rows;
+  __m256i high_rows;
+  __m256i bits;
+};
+
+ZINC_TARGET("avx2")
+auto broadcast16(u8 const *table) -> __m256i {
+  return _mm256_broadcastsi128_si256(
+      _mm_load_si128(reinterpret_cast<__m128i const *>(table)));
+}
+
+ZINC_TARGET("avx2")
+auto make_nibble_set(char const *set, usize set_length) -> nibble_set {
+  alignas(16) u8 low_rows[16] = {};
+  alignas(16) u8 high_rows[16] = {};
+  alignas(16) u8 bits[16];
+  for (u32 i = 0; i < 16; ++i)
+    bits[i] = as<u8>(1u << (i & 7));
+  for (usize j = 0; j < set_length; ++j) {
+    auto const byte = as<u8>(set[j]);
+    auto &row = byte < 0x80 ? low_rows[byte & 0xf] : high_rows[byte & 0xf];
+    row |= as<u8>(1u << ((byte >> 4) & 7));
+  }
+  return {broadcast16(low_rows), broadcast16(high_rows), broadcast16(bits)};
+}
+
+template <bool negate>
+ZINC_TARGET("avx2")
+auto match_any32(char const *data, nibble_set const &set) -> u32 {
+  auto const block = load32(data);
+  auto const nibble = _mm256_set1_epi8(0x0f);
+  auto const low = _mm256_and_si256(block, nibble);
+  auto const high = _mm256_and_si256(_mm256_srli_epi16(block, 4), nibble);
+  auto const upper_half = _mm256_cmpgt_epi8(_mm256_setzero_si256(), block);
+  auto const row =
+      _mm256_blendv_epi8(_mm256_shuffle_epi8(set.low_rows, low),
+                         _mm256_shuffle_epi8(set.high_rows, low), upper_half);
+  auto const bit = _mm256_shuffle_epi8(set.bits, high);
+  auto const misses = _mm256_cmpeq_epi8(_mm256_and_si256(row, bit),
+                                        _mm256_setzero_si256());
+  auto const mask = as<u32>(_mm256_movemask_epi8(misses));
+  return negate ? mask : ~mask;
+}
+
+// for a few members comparing is cheaper than building the nibble tables
+template <bool negate>
+ZINC_TARGET("avx2")
+auto match_few32(char const *data, __m256i const *set, usize set_length)
+    -> u32 {
+  auto const block = load32(data);
+  auto hits = _mm256_setzero_si256();
+  for (usize j = 0; j < set_length; ++j)
+    hits = _mm256_or_si256(hits, _mm256_cmpeq_epi8(block, set[j]));
+  auto const mask = as<u32>(_mm256_movemask_epi8(hits));
+  return negate ? ~mask : mask;
+}
+
+template <bool negate>
+ZINC_TARGET("avx2")
+auto find_few_avx2(char const *data, usize length, char const *set,
+                   usize set_length) -> usize {
+  __m256i members[4];
+  for (usize j = 0; j < set_length; ++j)
+    members[j] = _mm256_set1_epi8(set[j]);
+  usize i = 0;
+  for (; i + 32 <= length; i += 32) {
+    if (auto const mask = match_few32<negate>(data + i, members, set_length))
+      return i + count_trailing_zeros(mask);
+  }
+  if (i == length)
+    return not_found;
+  auto const start = length - 32;
+  auto const mask = match_few32<negate>(data + start, members, set_length) &
+                    (~0u << (i - start));
+  return mask ? start + count_trailing_zeros(mask) : not_found;
+}
+
+template <bool negate>
+ZINC_TARGET("avx2")
+auto find_any_avx2(char const *data, usize length, char const *set,
+                   usize set_length) -> usize {
+  if (length < 32)
+    return find_any_sse2<negate>(data, length, set, set_length);
+  if (set_length <= 4)
+    return find_few_avx2<negate>(data, length, set, set_length);
+  auto const members = make_nibble_set(set, set_length);
+  usize i = 0;
+  for (; i + 32 <= length; i += 32) {
+    if (auto const mask = match_any32<negate>(data + i, members))
+      return i + count_trailing_zeros(mask);
+  }
+  if (i == length)
+    return not_found;
+  auto const start = length - 32;
+  auto const mask =
+      match_any32<negate>(data + start, members) & (~0u << (i - start));
+  return mask ? start + count_trailing_zeros(mask) : not_found;
+}
+
+// Compares the first and last byte of the needle at every position of a
+// vector at once and only runs memcmp where both match.
+ZINC_TARGET("sse2")
+auto find_bytes_sse2(char const *data, usize length, char const *needle,
+                     usize needle_length) -> usize {
+  auto const limit = length - needle_length + 1;
+  auto const first = _mm_set1_epi8(needle[0]);
+  auto const last = _mm_set1_epi8(needle[needle_length - 1]);
+  usize i = 0;
+  for (; i + 16 <= limit; i += 16) {
+    auto mask = match16(data + i, first) &
+                match16(data + i + needle_length - 1, last);
+    while (mask) {
+      auto const offset = i + count_trailing_zeros(mask);
+      if (memcmp(data + offset + 1, needle + 1, needle_length - 2) == 0)
+        return offset;
+      mask &= mask - 1;
+    }
+  }
+  auto const found =
+      find_bytes_scalar(data + i, length - i, needle, needle_length);
+  return found == not_found ? not_found : i + found;
+}
+
+ZINC_TARGET("avx2")
+auto find_bytes_avx2(char const *data, usize length, char const *needle,
+                     usize needle_length) -> usize {
+  auto const limit = length - needle_length + 1;
+  auto const first = _mm256_set1_epi8(needle[0]);
+  auto const last = _mm256_set1_epi8(needle[needle_length - 1]);
+  usize i = 0;
+  for (; i + 32 <= limit; i += 32) {
+    auto mask = match32(data + i, first) &
+                match32(data + i + needle_length - 1, last);
+    while (mask) {
+      auto const offset = i + count_trailing_zeros(mask);
+      if (memcmp(data + offset + 1, needle + 1, needle_length - 2) == 0)
+        return offset;
+      mask &= mask - 1;
+    }
+  }
+  auto const found =
+      find_bytes_sse2(data + i, length - i, needle, needle_length);
+  return found == not_found ? not_found : i + found;
+}
+#endif
+
+template <bool negate>
+auto find_any(char const *data, usize length, char const *set,
+              usize set_length) -> usize {
+  // tokenizers mostly stop at the very first byte, answer that without
+  // setting up any vectors
+  if (length > 0 && set_length <= 4) {
+    auto hit = false;
+    for (usize j = 0; j < set_length; ++j)
+      hit |= data[0] == set[j];
+    if (hit != negate)
+      return 0;
+  }
+#if ZINC_CPU_X86
+  if (features().avx2)
+    return find_any_avx2<negate>(data, length, set, set_length);
+  if (features().sse2)
+    return find_any_sse2<negate>(data, length, set, set_length);
+#endif
+  return find_any_scalar<negate>(data, length, set, set_length);
+}
+} // namespace
+
+auto find_byte(char const *data, usize length, char value) -> usize {
+#if ZINC_CPU_X86
+  if (features().avx2)
+    return find_byte_avx2(data, length, value);
+  if (features().sse2)
+    return find_byte_sse2(data, length, value);
+#endif
+  return find_byte_scalar(data, length, value);
+}
+
+auto rfind_byte(char const *data, usize length, char value) -> usize {
+#if ZINC_CPU_X86
+  if (features().avx2)
+    return rfind_byte_avx2(data, length, value);
+  if (features().sse2)
+    return rfind_byte_sse2(data, length, value);
+#endif
+  return rfind_byte_scalar(data, length, value);
+}
+
+auto count_byte(char const *data, usize length, char value) -> usize {
+#if ZINC_CPU_X86
+  if (features().avx2)
+    return count_byte_avx2(data, length, value);
+  if (features().sse2)
+    return count_byte_sse2(data, length, value);
+#endif
+  return count_byte_scalar(data, length, value);
+}
+
+auto find_any_byte(char const *data, usize length, char const *set,
+                   usize set_length) -> usize {
+  if (set_length == 0)
+    return not_found;
+  if (set_length == 1)
+    return find_byte(data, length, set[0]);
+  return find_any<false>(data, length, set, set_length);
+}
+
+auto find_not_any_byte(char const *data, usize length, char const *set,
+                       usize set_length) -> usize {
+  if (set_length == 0)
+    return length ? 0 : not_found;
+  return find_any<true>(data, length, set, set_length);
+}
+
+auto find_bytes(char const *data, usize length, char const *needle,
+                usize needle_length) -> usize {
+  if (needle_length == 0)
+    return 0;
+  if (needle_length > length)
+    return not_found;
+  if (needle_length == 1)
+    return find_byte(data, length, needle[0]);
+#if ZINC_CPU_X86
+  if (features().avx2)
+    return find_bytes_avx2(data, length, needle, needle_length);
+  if (features().sse2)
+    return find_bytes_sse2(data, length, needle, needle_length);
+#endif
+  return find_bytes_scalar(data, length, needle, needle_length);
+}
+
+auto rfind_bytes(char const *data, usize length, char const *needle,
+                 usize needle_length) -> usize {
+  if (needle_length == 0)
+    return length;
+  if (needle_length > length)
+    return not_found;
+  auto end = length - needle_length + 1;
+  while (end > 0) {
+    auto const found = rfind_byte(data, end, needle[0]);
+    if (found == not_found)
+      return not_found;
+    if (memcmp(data + found + 1, needle + 1, needle_length - 1) == 0)
+      return found;
+    end = found;
+  }
+  return not_found;
+}
+} // namespace zinc::details
\ No newline at end of file
@@ -0,0 +1,358 @@
+#include "zinc/string_sort.h"
+
+#include "zinc/bits.h"
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace zinc {
+namespace {
+constexpr usize insertion_limit = 16;
+constexpr usize multikey_limit = 512;
+// buckets smaller than this are sorted by the thread that produced them
+constexpr usize parallel_limit = 1 << 15;
+constexpr usize bucket_count = 257;
+
+struct indexed_view {
+  string_view view;
+  usize index;
+};
+
+auto view_of(string_view const &entry) -> string_view const & {
+  return entry;
+}
+auto view_of(indexed_view const &entry) -> string_view const & {
+  return entry.view;
+}
+
+// the byte at depth shifted up by one, zero once the string has ended
+auto key_at(string_view const &text, usize depth) -> u16 {
+  return depth < text.length() ? as<u16>(as<u8>(text.data()[depth]) + 1) : 0;
+}
+
+// Every string reaching a sort at depth shares its first depth bytes with
+// the others, so only the rest is compared.
+auto less_from(string_view const &a, string_view const &b, usize depth)
+    -> bool {
+  auto const a_rest = a.length() - depth;
+  auto const b_rest = b.length() - depth;
+  auto const common = a_rest < b_rest ? a_rest : b_rest;
+  auto const order = memcmp(a.data() + depth, b.data() + depth, common);
+  return order < 0 || (order == 0 && a_rest < b_rest);
+}
+
+template <typename TEntry>
+auto insertion_sort(TEntry *entries, usize count, usize depth) -> void {
+  for (usize i = 1; i < count; ++i) {
+    auto const entry = entries[i];
+    auto j = i;
+    for (; j > 0 && less_from(view_of(entry), view_of(entries[j - 1]), depth);
+         --j)
+      entries[j] = entries[j - 1];
+    entries[j] = entry;
+  }
+}
+
+auto median_of_three(u16 a, u16 b, u16 c) -> u16 {
+  if (a < b)
+    return b < c ? b : (a < c ? c : a);
+  return a < c ? a : (b < c ? c : b);
+}
+
+// Bentley and Sedgewick's three way split on one byte. The bytes of the
+// current depth are cached next to the entries, so partitioning never
+// reaches into the strings, and the parts split at the same depth keep
+// them.
+template <typename TEntry>
+auto multikey_sort(TEntry *entries, u16 *keys, usize count, usize depth,
+                   bool cached) -> void {
+  while (count >= insertion_limit) {
+    if (!cached)
+      for (usize i = 0; i < count; ++i)
+        keys[i] = key_at(view_of(entries[i]), depth);
+    auto const pivot =
+        median_of_three(keys[0], keys[count / 2], keys[count - 1]);
+
+    usize less = 0, i = 0, greater = count;
+    while (i < greater) {
+      if (keys[i] < pivot) {
+        std::swap(entries[less], entries[i]);
+        std::swap(keys[less], keys[i]);
+        ++less;
+        ++i;
+      } else if (keys[i] > pivot) {
+        --greater;
+        std::swap(entries[i], entries[greater]);
+        std::swap(keys[i], keys[greater]);
+      } else {
+        ++i;
+      }
+    }
+
+    multikey_sort(entries, keys, less, depth, true);
+    multikey_sort(entries + greater, keys + greater, count - greater, depth,
+                  true);
+    // strings that all ended here are equal
+    if (pivot == 0)
+      return;
+    entries += less;
+    keys += less;
+    count = greater - less;
+    ++depth;
+    cached = false;
+  }
+  insertion_sort(entries, count, depth);
+}
+
+// The next eight bytes of every key, from depth on, kept next to the
+// entries and moved with them. Radix passes read the cache instead of the
+// strings, which are only touched once every eight levels.
+struct prefix_cache {
+  u64 *words;
+  u64 *spare;
+  usize depth;
+};
+
+// big endian, so comparing words orders like comparing the bytes
+auto load_word(string_view const &text, usize depth) -> u64 {
+  if (depth + 8 <= text.length()) {
+    u64 word;
+    memcpy(&word, text.data() + depth, sizeof(word));
+#if ZINC_CPU_ENDIAN_LITTLE
+    word = byte_swap(word);
+#endif
+    return word;
+  }
+  u64 word = 0;
+  for (auto at = depth; at < text.length(); ++at)
+    word |= as<u64>(as<u8>(text.data()[at])) << (56 - 8 * (at - depth));
+  return word;
+}
+
+template <typename TEntry>
+auto fill_cache(TEntry const *entries, u64 *words, usize count, usize depth)
+    -> void {
+  for (usize i = 0; i < count; ++i)
+    words[i] = load_word(view_of(entries[i]), depth);
+}
+
+// Spreads entries over buckets by their byte at depth, moving depth past
+// bytes that all of them share. Returns false when they are all the same
+// string.
+template <typename TEntry>
+auto radix_pass(TEntry *entries, TEntry *buffer, u16 *keys,
+                prefix_cache &cache, usize count, usize &depth,
+                usize (&counts)[bucket_count]) -> bool {
+  for (;;) {
+    if (depth >= cache.depth + 8) {
+      cache.depth = depth;
+      fill_cache(entries, cache.words, count, depth);
+    }
+    // bytes every key shares are stepped over together, as long as no key
+    // ends inside them
+    u64 differ = 0;
+    auto shortest = view_of(entries[0]).length();
+    for (usize i = 0; i < count; ++i) {
+      differ |= cache.words[i] ^ cache.words[0];
+      auto const length = view_of(entries[i]).length();
+      shortest = length < shortest ? length : shortest;
+    }
+    differ <<= 8 * (depth - cache.depth);
+    auto shared = differ ? count_leading_zeros(differ) / 8 : 8;
+    auto const window = cache.depth + 8 - depth;
+    shared = shared < window ? shared : window;
+    if (depth + shared > shortest)
+      shared = shortest > depth ? shortest - depth : 0;
+    depth += shared;
+    if (depth >= cache.depth + 8)
+      continue;
+
+    auto const shift = 56 - 8 * (depth - cache.depth);
+    for (auto &slot : counts)
+      slot = 0;
+    for (usize i = 0; i < count; ++i) {
+      keys[i] = depth < view_of(entries[i]).length()
+                    ? as<u16>(((cache.words[i] >> shift) & 0xFF) + 1)
+                    : 0;
+      ++counts[keys[i]];
+    }
+    if (counts[keys[0]] != count)
+      break;
+    if (keys[0] == 0)
+      return false;
+    ++depth;
+  }
+
+  usize next[bucket_count];
+  usize start = 0;
+  for (usize b = 0; b < bucket_count; ++b) {
+    next[b] = start;
+    start += counts[b];
+  }
+  for (usize i = 0; i < count; ++i) {
+    auto const at = next[keys[i]]++;
+    buffer[at] = entries[i];
+    cache.spare[at] = cache.words[i];
+  }
+  for (usize i = 0; i < count; ++i)
+    entries[i] = buffer[i];
+  memcpy(cache.words, cache.spare, count * sizeof(u64));
+  return true;
+}
+
+auto offset_cache(prefix_cache const &cache, usize offset) -> prefix_cache {
+  return {cache.words + offset, cache.spare + offset, cache.depth};
+}
+
+template <typename TEntry>
+auto radix_sort(TEntry *entries, TEntry *buffer, u16 *keys,
+                prefix_cache cache, usize count, usize depth) -> void {
+  while (count >= multikey_limit) {
+    usize counts[bucket_count];
+    if (!radix_pass(entries, buffer, keys, cache, count, depth, counts))
+      return;
+
+    // the largest bucket is sorted by looping, the others by recursion, so
+    // the stack only grows with the log of the count
+    usize largest = 1;
+    for (usize b = 2; b < bucket_count; ++b)
+      largest = counts[b] > counts[largest] ? b : largest;
+    usize start = counts[0], largest_start = 0;
+    for (usize b = 1; b < bucket_count; ++b) {
+      if (b == largest)
+        largest_start = start;
+      else if (counts[b] > 1)
+        radix_sort(entries + start, buffer + start, keys + start,
+                   offset_cache(cache, start), counts[b], depth + 1);
+      start += counts[b];
+    }
+    entries += largest_start;
+    buffer += largest_start;
+    keys += largest_start;
+    cache = offset_cache(cache, largest_start);
+    count = counts[largest];
+    ++depth;
+  }
+  multikey_sort(entries, keys, count, depth, false);
+}
+
+// Large buckets become tasks for whichever thread is free. Each task owns
+// the same range of the scratch arrays as of the entries, so threads never
+// share scratch space.
+template <typename TEntry> struct parallel_sort {
+  struct task {
+    usize begin;
+    usize count;
+    usize depth;
+    usize cached_depth;
+  };
+
+  TEntry *m_entries;
+  TEntry *m_buffer;
+  u16 *m_keys;
+  u64 *m_words;
+  u64 *m_spare;
+  std::mutex m_mutex{};
+  std::condition_variable m_ready{};
+  std::vector<task> m_tasks{};
+  u32 m_busy{0};
+
+  auto run(task const &work) -> void {
+    auto *entries = m_entries + work.begin;
+    auto *buffer = m_buffer + work.begin;
+    auto *keys = m_keys + work.begin;
+    auto cache = prefix_cache{m_words + work.begin, m_spare + work.begin,
+                              work.cached_depth};
+    if (work.count < parallel_limit) {
+      radix_sort(entries, buffer, keys, cache, work.count, work.depth);
+      return;
+    }
+    usize counts[bucket_count];
+    auto depth = work.depth;
+    if (!radix_pass(entries, buffer, keys, cache, work.count, depth, counts))
+      return;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto start = work.begin + counts[0];
+    for (usize b = 1; b < bucket_count; ++b) {
+      if (counts[b] > 1)
+        m_tasks.push_back({start, counts[b], depth + 1, cache.depth});
+      start += counts[b];
+    }
+    m_ready.notify_all();
+  }
+
+  auto work() -> void {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for (;;) {
+      m_ready.wait(lock, [this] { return !m_tasks.empty() || m_busy == 0; });
+      if (m_tasks.empty())
+        return;
+      auto const next = m_tasks.back();
+      m_tasks.pop_back();
+      ++m_busy;
+      lock.unlock();
+      run(next);
+      lock.lock();
+      if (--m_busy == 0 && m_tasks.empty())
+        m_ready.notify_all();
+    }
+  }
+};
+
+template <typename TEntry>
+auto sort_entries(TEntry *entries, usize count, u32 threads) -> void {
+  if (count < 2)
+    return;
+  if (count < multikey_limit) {
+    scoped_array<u16> keys(new u16[count]);
+    multikey_sort(entries, keys.get(), count, 0, false);
+    return;
+  }
+  scoped_array<TEntry> buffer(new TEntry[count]);
+  scoped_array<u16> keys(new u16[count]);
+  scoped_array<u64> words(new u64[count]);
+  scoped_array<u64> spare(new u64[count]);
+  fill_cache(entries, words.get(), count, 0);
+  if (threads == 0)
+    threads = std::thread::hardware_concurrency();
+  if (threads <= 1 || count < parallel_limit) {
+    radix_sort(entries, buffer.get(), keys.get(),
+               prefix_cache{words.get(), spare.get(), 0}, count, 0);
+    return;
+  }
+
+  parallel_sort<TEntry> sorter{entries,     buffer.get(), keys.get(),
+                               words.get(), spare.get()};
+  sorter.m_tasks.push_back({0, count, 0, 0});
+  std::vector<std::thread> helpers;
+  for (u32 i = 1; i < threads; ++i)
+    helpers.emplace_back([&sorter] { sorter.work(); });
+  sorter.work();
+  for (auto &helper : helpers)
+    helper.join();
+}
+} // namespace
+
+namespace details {
+auto sort_views(string_view *views, usize count, u32 threads) -> void {
+  sort_entries(views, count, threads);
+}
+
+auto sort_views(string_view *views, usize *order, usize count, u32 threads)
+    -> void {
+  if (count < 2)
+    return;
+  scoped_array<indexed_view> entries(new indexed_view[count]);
+  for (usize i = 0; i < count; ++i)
+    entries.get()[i] = {views[i], order[i]};
+  sort_entries(entries.get(), count, threads);
+  for (usize i = 0; i < count; ++i) {
+    views[i] = entries.get()[i].view;
+    order[i] = entries.get()[i].index;
+  }
+}
+} // namespace details
+} // namespace zinc
\ No newline at end of file
@@ -0,0 +1,738 @@
+#include "zinc/utf8.h"
+
+#include "zinc/bits.h"
+#include "zinc/cpu.h"
+
+#if ZINC_CPU_X86
+#include <immintrin.h>
+#endif
+
+namespace zinc {
+namespace details {
+auto decode_utf8(char const *data, usize available, char32_t &value)
+    -> usize {
+  auto const *bytes = reinterpret_cast<u8 const *>(data);
+  auto const lead = bytes[0];
+  if (lead < 0x80) {
+    value = lead;
+    return 1;
+  }
+  if (lead < 0xC2 || lead > 0xF4)
+    return 0;
+
+  auto const continuation = [&](usize i) {
+    return (bytes[i] & 0xC0) == 0x80;
+  };
+  if (lead < 0xE0) {
+    if (available < 2 || !continuation(1))
+      return 0;
+    value = (char32_t(lead & 0x1F) << 6) | (bytes[1] & 0x3F);
+    return 2;
+  }
+
+  // the second byte's range is what rules out overlongs, surrogates and
+  // anything past U+10FFFF
+  if (lead < 0xF0) {
+    u8 const low = lead == 0xE0 ? 0xA0 : 0x80;
+    u8 const high = lead == 0xED ? 0x9F : 0xBF;
+    if (available < 3 || bytes[1] < low || bytes[1] > high ||
+        !continuation(2))
+      return 0;
+    value = (char32_t(lead & 0x0F) << 12) | (char32_t(bytes[1] & 0x3F) << 6) |
+            (bytes[2] & 0x3F);
+    return 3;
+  }
+
+  u8 const low = lead == 0xF0 ? 0x90 : 0x80;
+  u8 const high = lead == 0xF4 ? 0x8F : 0xBF;
+  if (available < 4 || bytes[1] < low || bytes[1] > high ||
+      !continuation(2) || !continuation(3))
+    return 0;
+  value = (char32_t(lead & 0x07) << 18) | (char32_t(bytes[1] & 0x3F) << 12) |
+          (char32_t(bytes[2] & 0x3F) << 6) | (bytes[3] & 0x3F);
+  return 4;
+}
+} // namespace details
+
+namespace {
+auto features() -> cpu_features const & {
+  static auto const &detected = cpu();
+  return detected;
+}
+
+auto ascii_word(char const *data) -> bool {
+  u64 word;
+  memcpy(&word, data, sizeof(word));
+  return (word & 0x8080808080808080) == 0;
+}
+
+auto encode(char32_t value, char *out) -> usize {
+  if (value < 0x80) {
+    out[0] = as<char>(value);
+    return 1;
+  }
+  if (value < 0x800) {
+    out[0] = as<char>(0xC0 | (value >> 6));
+    out[1] = as<char>(0x80 | (value & 0x3F));
+    return 2;
+  }
+  if (value < 0x10000) {
+    out[0] = as<char>(0xE0 | (value >> 12));
+    out[1] = as<char>(0x80 | ((value >> 6) & 0x3F));
+    out[2] = as<char>(0x80 | (value & 0x3F));
+    return 3;
+  }
+  out[0] = as<char>(0xF0 | (value >> 18));
+  out[1] = as<char>(0x80 | ((value >> 12) & 0x3F));
+  out[2] = as<char>(0x80 | ((value >> 6) & 0x3F));
+  out[3] = as<char>(0x80 | (value & 0x3F));
+  return 4;
+}
+
+// scalar
+
+auto validate_scalar(char const *data, usize length) -> bool {
+  usize i = 0;
+  while (i < length) {
+    if (i + 8 <= length && ascii_word(data + i)) {
+      i += 8;
+      continue;
+    }
+    char32_t ignored;
+    auto const size = details::decode_utf8(data + i, length - i, ignored);
+    if (size == 0)
+      return false;
+    i += size;
+  }
+  return true;
+}
+
+// bytes outside 0x80-0xBF start a code point, 0xF0 and up also need a
+// second UTF-16 unit
+template <bool utf16>
+auto count_scalar(char const *data, usize length) -> usize {
+  usize count = 0;
+  for (usize i = 0; i < length; ++i) {
+    count += as<i8>(data[i]) > -65;
+    if constexpr (utf16)
+      count += as<u8>(data[i]) >= 0xF0;
+  }
+  return count;
+}
+
+// decodes the non ASCII stretch at data[i], shared by every transcoder
+template <typename TUnit>
+auto transcode_one(char const *data, usize length, usize &i, TUnit *&out)
+    -> bool {
+  char32_t value;
+  auto const size = details::decode_utf8(data + i, length - i, value);
+  if (size == 0)
+    return false;
+  i += size;
+  if constexpr (sizeof(TUnit) == 2) {
+    if (value >= 0x10000) {
+      value -= 0x10000;
+      *out++ = as<TUnit>(0xD800 + (value >> 10));
+      *out++ = as<TUnit>(0xDC00 + (value & 0x3FF));
+      return true;
+    }
+  }
+  *out++ = as<TUnit>(value);
+  return true;
+}
+
+template <typename TUnit>
+auto from_utf8_scalar(char const *data, usize length, usize i, TUnit *out)
+    -> TUnit * {
+  while (i < length) {
+    if (as<u8>(data[i]) < 0x80) {
+      *out++ = as<TUnit>(data[i++]);
+      continue;
+    }
+    if (!transcode_one(data, length, i, out))
+      return nullptr;
+  }
+  return out;
+}
+
+// one code point, a high surrogate has to be followed by a low one
+auto utf16_step(char16_t const *data, usize length, usize &i, char *&out)
+    -> bool {
+  char32_t value = data[i++];
+  if (value >= 0xD800 && value < 0xE000) {
+    if (value >= 0xDC00 || i == length || data[i] < 0xDC00 ||
+        data[i] >= 0xE000)
+      return false;
+    value = 0x10000 + ((value - 0xD800) << 10) + (data[i++] - 0xDC00);
+  }
+  out += encode(value, out);
+  return true;
+}
+
+auto utf16_to_utf8_scalar(char16_t const *data, usize length, usize i,
+                          char *out) -> char * {
+  while (i < length) {
+    if (!utf16_step(data, length, i, out))
+      return nullptr;
+  }
+  return out;
+}
+
+auto utf32_to_utf8_scalar(char32_t const *data, usize length, usize i,
+                          char *out) -> char * {
+  for (; i < length; ++i) {
+    auto const value = data[i];
+    if (value > 0x10FFFF || (value >= 0xD800 && value < 0xE000))
+      return nullptr;
+    out += encode(value, out);
+  }
+  return out;
+}
+
+#if ZINC_CPU_X86
+// Validation is the lookup algorithm of Keiser and Lemire (simdjson,
+// simdutf). Three 16 entry tables indexed by the nibbles of each byte and
+// the one before it flag every error that spans two bytes; a lead byte
+// two or three back says whether this byte must be a continuation. An
+// input ending mid sequence is caught by the next block or the zero padded
+// tail. Whole blocks of ASCII skip the tables.
+
+constexpr u8 too_short = 1 << 0;
+constexpr u8 too_long = 1 << 1;
+constexpr u8 overlong_3 = 1 << 2;
+constexpr u8 too_large = 1 << 3;
+constexpr u8 surrogate = 1 << 4;
+constexpr u8 overlong_2 = 1 << 5;
+constexpr u8 too_large_1000 = 1 << 6;
+constexpr u8 overlong_4 = 1 << 6;
+constexpr u8 two_conts = 1 << 7;
+constexpr u8 carry = too_short | too_long | two_conts;
+
+constexpr u8 byte_1_high[16] = {
+    too_long,   too_long,   too_long,   too_long,
+    too_long,   too_long,   too_long,   too_long,
+    two_conts,  two_conts,  two_conts,  two_conts,
+    too_short | overlong_2, too_short,
+    too_short | overlong_3 | surrogate,
+    too_short | too_large | too_large_1000 | overlong_4};
+
+constexpr u8 byte_1_low[16] = {
+    carry | overlong_3 | overlong_2 | overlong_4,
+    carry | overlong_2,
+    carry,
+    carry,
+    carry | too_large,
+    carry | too_large | too_large_1000,
+    carry | too_large | too_large_1000,
+    carry | too_large | too_large_1000,
+    carry | too_large | too_large_1000,
+    carry | too_large | too_large_1000,
+    carry | too_large | too_large_1000,
+    carry | too_large | too_large_1000,
+    carry | too_large | too_large_1000,
+    carry | too_large | too_large_1000 | surrogate,
+    carry | too_large | too_large_1000,
+    carry | too_large | too_large_1000};
+
+constexpr u8 byte_2_high[16] = {
+    too_short, too_short, too_short, too_short,
+    too_short, too_short, too_short, too_short,
+    too_long | overlong_2 | two_conts | overlong_3 | too_large_1000 |
+        overlong_4,
+    too_long | overlong_2 | two_conts | overlong_3 | too_large,
+    too_long | overlong_2 | two_conts | surrogate | too_large,
+    too_long | overlong_2 | two_conts | surrogate | too_large,
+    too_short, too_short, too_short, too_short};
+
+// lead bytes that still need bytes past the end of a block: anything in the
+// last three positions at or above 0xF0, 0xE0 and 0xC0 respectively
+constexpr u8 incomplete_limits[32] = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xEF, 0xDF, 0xBF};
+
+ZINC_TARGET("sse2")
+auto load16(void const *data) -> __m128i {
+  return _mm_loadu_si128(static_cast<__m128i const *>(data));
+}
+
+ZINC_TARGET("avx2")
+auto load32(void const *data) -> __m256i {
+  return _mm256_loadu_si256(static_cast<__m256i const *>(data));
+}
+
+struct state16 {
+  __m128i error;
+  __m128i previous;
+  __m128i incomplete;
+};
+
+ZINC_TARGET("ssse3")
+auto check16(state16 &state, __m128i input) -> void {
+  auto const nibble = _mm_set1_epi8(0x0F);
+  auto const prev1 = _mm_alignr_epi8(input, state.previous, 15);
+  auto const prev2 = _mm_alignr_epi8(input, state.previous, 14);
+  auto const prev3 = _mm_alignr_epi8(input, state.previous, 13);
+
+  auto const special = _mm_and_si128(
+      _mm_and_si128(
+          _mm_shuffle_epi8(load16(byte_1_high),
+                           _mm_and_si128(_mm_srli_epi16(prev1, 4), nibble)),
+          _mm_shuffle_epi8(load16(byte_1_low), _mm_and_si128(prev1, nibble))),
+      _mm_shuffle_epi8(load16(byte_2_high),
+                       _mm_and_si128(_mm_srli_epi16(input, 4), nibble)));
+
+  auto const third = _mm_subs_epu8(prev2, _mm_set1_epi8(0x60));
+  auto const fourth = _mm_subs_epu8(prev3, _mm_set1_epi8(0x70));
+  auto const must_continue = _mm_and_si128(_mm_or_si128(third, fourth),
+                                           _mm_set1_epi8(as<char>(0x80)));
+
+  state.error =
+      _mm_or_si128(state.error, _mm_xor_si128(must_continue, special));
+  state.previous = input;
+}
+
+// 64 bytes at a time so ASCII text only pays for one test
+ZINC_TARGET("ssse3")
+auto check64_ssse3(state16 &state, char const *data) -> void {
+  auto const a = load16(data);
+  auto const b = load16(data + 16);
+  auto const c = load16(data + 32);
+  auto const d = load16(data + 48);
+  auto const any = _mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d));
+  if (_mm_movemask_epi8(any) == 0) {
+    state.error = _mm_or_si128(state.error, state.incomplete);
+    state.previous = d;
+    return;
+  }
+  check16(state, a);
+  check16(state, b);
+  check16(state, c);
+  check16(state, d);
+  state.incomplete = _mm_subs_epu8(d, load16(incomplete_limits + 16));
+}
+
+ZINC_TARGET("ssse3")
+auto validate_ssse3(char const *data, usize length) -> bool {
+  state16 state{_mm_setzero_si128(), _mm_setzero_si128(),
+                _mm_setzero_si128()};
+  usize i = 0;
+  for (; i + 64 <= length; i += 64)
+    check64_ssse3(state, data + i);
+
+  char tail[64] = {};
+  memcpy(tail, data + i, length - i);
+  check64_ssse3(state, tail);
+  auto const error = _mm_or_si128(state.error, state.incomplete);
+  return _mm_movemask_epi8(_mm_cmpeq_epi8(error, _mm_setzero_si128())) ==
+         0xFFFF;
+}
+
+struct state32 {
+  __m256i error;
+  __m256i previous;
+  __m256i incomplete;
+};
+
+ZINC_TARGET("avx2")
+auto broadcast16(u8 const *table) -> __m256i {
+  return _mm256_broadcastsi128_si256(load16(table));
+}
+
+ZINC_TARGET("avx2")
+auto check32(state32 &state, __m256i input) -> void {
+  auto const nibble = _mm256_set1_epi8(0x0F);
+  // the previous block's upper half next to this block's lower half, so
+  // the in lane alignr can reach across the middle
+  auto const shifted = _mm256_permute2x128_si256(state.previous, input, 0x21);
+  auto const prev1 = _mm256_alignr_epi8(input, shifted, 15);
+  auto const prev2 = _mm256_alignr_epi8(input, shifted, 14);
+  auto const prev3 = _mm256_alignr_epi8(input, shifted, 13);
+
+  auto const special = _mm256_and_si256(
+      _mm256_and_si256(
+          _mm256_shuffle_epi8(
+              broadcast16(byte_1_high),
+              _mm256_and_si256(_mm256_srli_epi16(prev1, 4), nibble)),
+          _mm256_shuffle_epi8(broadcast16(byte_1_low),
+                              _mm256_and_si256(prev1, nibble))),
+      _mm256_shuffle_epi8(
+          broadcast16(byte_2_high),
+          _mm256_and_si256(_mm256_srli_epi16(input, 4), nibble)));
+
+  auto const third = _mm256_subs_epu8(prev2, _mm256_set1_epi8(0x60));
+  auto const fourth = _mm256_subs_epu8(prev3, _mm256_set1_epi8(0x70));
+  auto const must_continue = _mm256_and_si256(
+      _mm256_or_si256(third, fourth), _mm256_set1_epi8(as<char>(0x80)));
+
+  state.error = _mm256_or_si256(state.error,
+                                _mm256_xor_si256(must_continue, special));
+  state.previous = input;
+}
+
+ZINC_TARGET("avx2")
+auto check64_avx2(state32 &state, char const *data) -> void {
+  auto const a = load32(data);
+  auto const b = load32(data + 32);
+  if (_mm256_movemask_epi8(_mm256_or_si256(a, b)) == 0) {
+    state.error = _mm256_or_si256(state.error, state.incomplete);
+    state.previous = b;
+    return;
+  }
+  check32(state, a);
+  check32(state, b);
+  state.incomplete = _mm256_subs_epu8(b, load32(incomplete_limits));
+}
+
+ZINC_TARGET("avx2")
+auto validate_avx2(char const *data, usize length) -> bool {
+  state32 state{_mm256_setzero_si256(), _mm256_setzero_si256(),
+                _mm256_setzero_si256()};
+  usize i = 0;
+  for (; i + 64 <= length; i += 64)
+    check64_avx2(state, data + i);
+
+  char tail[64] = {};
+  memcpy(tail, data + i, length - i);
+  check64_avx2(state, tail);
+  auto const error = _mm256_or_si256(state.error, state.incomplete);
+  return _mm256_testz_si256(error, error) != 0;
+}
+
+// Counting adds the compare masks bytewise, flushing through sad before a
+// lane could wrap; each sad sum fits in 16 bits. utf16 adds a second mask
+// for bytes at or above 0xF0, so the flush comes sooner.
+
+ZINC_TARGET("sse2")
+auto sum16(__m128i counts) -> usize {
+  auto const sums = _mm_sad_epu8(counts, _mm_setzero_si128());
+  return as<usize>(_mm_cvtsi128_si32(sums) + _mm_extract_epi16(sums, 4));
+}
+
+template <bool utf16>
+ZINC_TARGET("sse2")
+auto count_sse2(char const *data, usize length) -> usize {
+  constexpr usize flush = utf16 ? 127 : 255;
+  auto const lead = _mm_set1_epi8(-65);
+  auto const four = _mm_set1_epi8(as<char>(0xF0));
+  usize count = 0;
+  usize i = 0;
+  while (i + 16 <= length) {
+    auto counts = _mm_setzero_si128();
+    for (usize n = 0; n < flush && i + 16 <= length; ++n, i += 16) {
+      auto const bytes = load16(data + i);
+      counts = _mm_sub_epi8(counts, _mm_cmpgt_epi8(bytes, lead));
+      if constexpr (utf16)
+        counts = _mm_sub_epi8(
+            counts, _mm_cmpeq_epi8(_mm_max_epu8(bytes, four), bytes));
+    }
+    count += sum16(counts);
+  }
+  return count + count_scalar<utf16>(data + i, length - i);
+}
+
+ZINC_TARGET("avx2")
+auto sum32(__m256i counts) -> usize {
+  auto const sums = _mm256_sad_epu8(counts, _mm256_setzero_si256());
+  auto const half = _mm_add_epi64(_mm256_castsi256_si128(sums),
+                                  _mm256_extracti128_si256(sums, 1));
+  return as<usize>(_mm_cvtsi128_si32(half) + _mm_extract_epi16(half, 4));
+}
+
+template <bool utf16>
+ZINC_TARGET("avx2")
+auto count_avx2(char const *data, usize length) -> usize {
+  constexpr usize flush = utf16 ? 127 : 255;
+  auto const lead = _mm256_set1_epi8(-65);
+  auto const four = _mm256_set1_epi8(as<char>(0xF0));
+  usize count = 0;
+  usize i = 0;
+  while (i + 32 <= length) {
+    auto counts = _mm256_setzero_si256();
+    for (usize n = 0; n < flush && i + 32 <= length; ++n, i += 32) {
+      auto const bytes = load32(data + i);
+      counts = _mm256_sub_epi8(counts, _mm256_cmpgt_epi8(bytes, lead));
+      if constexpr (utf16)
+        counts = _mm256_sub_epi8(
+            counts, _mm256_cmpeq_epi8(_mm256_max_epu8(bytes, four), bytes));
+    }
+    count += sum32(counts);
+  }
+  return count + count_sse2<utf16>(data + i, length - i);
+}
+
+// UTF-8 input is validated up front, the kernels below then decode without
+// checking. Blocks of ASCII are widened a vector at a time. Other blocks
+// decode the sequences starting in the first eight positions in one go:
+// every position gets its value as if it led a one, two or three byte
+// sequence, continuation positions are squeezed out with a shuffle from
+// pack_lanes and the output advances by how many were kept. Four byte
+// sequences go through the scalar decoder.
+
+struct lane_packing {
+  u8 control[256][16];
+  u8 count[256];
+};
+
+// entry m moves the 16 bit lanes set in m to the front, in order
+constexpr auto make_lane_packing() -> lane_packing {
+  lane_packing table{};
+  for (u32 mask = 0; mask < 256; ++mask) {
+    u32 kept = 0;
+    for (u32 lane = 0; lane < 8; ++lane) {
+      if (mask & (1u << lane)) {
+        table.control[mask][kept * 2] = as<u8>(lane * 2);
+        table.control[mask][kept * 2 + 1] = as<u8>(lane * 2 + 1);
+        ++kept;
+      }
+    }
+    table.count[mask] = as<u8>(kept);
+    for (; kept < 8; ++kept) {
+      table.control[mask][kept * 2] = 0x80;
+      table.control[mask][kept * 2 + 1] = 0x80;
+    }
+  }
+  return table;
+}
+
+alignas(16) constexpr lane_packing pack_lanes = make_lane_packing();
+
+template <typename TUnit>
+auto decode_unchecked(char const *data, usize &i, TUnit *&out) -> void {
+  char32_t value;
+  i += details::decode_utf8(data + i, 4, value);
+  if constexpr (sizeof(TUnit) == 2) {
+    if (value >= 0x10000) {
+      value -= 0x10000;
+      *out++ = as<TUnit>(0xD800 + (value >> 10));
+      *out++ = as<TUnit>(0xDC00 + (value & 0x3FF));
+      return;
+    }
+  }
+  *out++ = as<TUnit>(value);
+}
+
+// Values of the sequences that start in the first eight bytes, packed to the
+// front. Returns how many bytes they span, zero when the block starts with a
+// four byte sequence. Sequences are at most three bytes long here so the
+// first lead at or after the eighth byte marks the end, which keeps the
+// result off the critical path of the value computation.
+ZINC_TARGET("ssse3")
+auto decode8_ssse3(char const *data, __m128i &values, u32 &count) -> u32 {
+  auto const zero = _mm_setzero_si128();
+  auto const input = load16(data);
+  auto const fours = as<u32>(_mm_movemask_epi8(_mm_cmpeq_epi8(
+                         _mm_max_epu8(input, _mm_set1_epi8(as<char>(0xF0))),
+                         input))) &
+                     0xFF;
+  auto const leads = as<u32>(_mm_movemask_epi8(
+      _mm_cmpgt_epi8(input, _mm_set1_epi8(as<char>(0xBF)))));
+  auto const limit = fours ? count_trailing_zeros(fours) : 8u;
+  if (limit == 0)
+    return 0;
+
+  auto const b = _mm_unpacklo_epi8(input, zero);
+  auto const n1 = _mm_unpacklo_epi8(_mm_srli_si128(input, 1), zero);
+  auto const n2 = _mm_unpacklo_epi8(_mm_srli_si128(input, 2), zero);
+  auto const low6 = _mm_set1_epi16(0x3F);
+  auto const two = _mm_or_si128(
+      _mm_slli_epi16(_mm_and_si128(b, _mm_set1_epi16(0x1F)), 6),
+      _mm_and_si128(n1, low6));
+  auto const three = _mm_or_si128(
+      _mm_or_si128(_mm_slli_epi16(b, 12),
+                   _mm_slli_epi16(_mm_and_si128(n1, low6), 6)),
+      _mm_and_si128(n2, low6));
+  auto const is_two = _mm_cmpgt_epi16(b, _mm_set1_epi16(0xBF));
+  auto const is_three = _mm_cmpgt_epi16(b, _mm_set1_epi16(0xDF));
+  auto value = _mm_or_si128(_mm_andnot_si128(is_two, b),
+                            _mm_and_si128(is_two, two));
+  value = _mm_or_si128(_mm_andnot_si128(is_three, value),
+                       _mm_and_si128(is_three, three));
+
+  auto const keep = leads & ((1u << limit) - 1);
+  values = _mm_shuffle_epi8(
+      value, _mm_load_si128(
+                 reinterpret_cast<__m128i const *>(pack_lanes.control[keep])));
+  count = pack_lanes.count[keep];
+  return fours ? limit : 8 + count_trailing_zeros(leads >> 8);
+}
+
+ZINC_TARGET("ssse3")
+auto store_units(char16_t *out, __m128i values) -> void {
+  _mm_storeu_si128(reinterpret_cast<__m128i *>(out), values);
+}
+
+ZINC_TARGET("ssse3")
+auto store_units(char32_t *out, __m128i values) -> void {
+  auto const zero = _mm_setzero_si128();
+  _mm_storeu_si128(reinterpret_cast<__m128i *>(out),
+                   _mm_unpacklo_epi16(values, zero));
+  _mm_storeu_si128(reinterpret_cast<__m128i *>(out + 4),
+                   _mm_unpackhi_epi16(values, zero));
+}
+
+ZINC_TARGET("ssse3")
+auto widen_ascii(char16_t *out, __m128i bytes) -> void {
+  auto const zero = _mm_setzero_si128();
+  store_units(out, _mm_unpacklo_epi8(bytes, zero));
+  store_units(out + 8, _mm_unpackhi_epi8(bytes, zero));
+}
+
+ZINC_TARGET("ssse3")
+auto widen_ascii(char32_t *out, __m128i bytes) -> void {
+  auto const zero = _mm_setzero_si128();
+  store_units(out, _mm_unpacklo_epi8(bytes, zero));
+  store_units(out + 8, _mm_unpackhi_epi8(bytes, zero));
+}
+
+// Writes stay inside the output: at most one unit per input byte has been
+// written so far and a block only runs with sixteen bytes left.
+template <typename TUnit>
+ZINC_TARGET("ssse3")
+auto from_utf8_ssse3(char const *data, usize length, usize i, TUnit *out)
+    -> TUnit * {
+  while (i + 16 <= length) {
+    auto const input = load16(data + i);
+    if (_mm_movemask_epi8(input) == 0) {
+      widen_ascii(out, input);
+      i += 16;
+      out += 16;
+      continue;
+    }
+    __m128i values;
+    u32 count;
+    if (auto const used = decode8_ssse3(data + i, values, count)) {
+      store_units(out, values);
+      out += count;
+      i += used;
+      continue;
+    }
+    decode_unchecked(data, i, out);
+  }
+  while (i < length)
+    decode_unchecked(data, i, out);
+  return out;
+}
+
+// ASCII a full register at a time, anything else through the SSSE3 blocks
+template <typename TUnit>
+ZINC_TARGET("avx2")
+auto from_utf8_avx2(char const *data, usize length, TUnit *out) -> TUnit * {
+  usize i = 0;
+  while (i + 32 <= length) {
+    auto const input = load32(data + i);
+    if (_mm256_movemask_epi8(input) != 0)
+      break;
+    widen_ascii(out, _mm256_castsi256_si128(input));
+    widen_ascii(out + 16, _mm256_extracti128_si256(input, 1));
+    i += 32;
+    out += 32;
+  }
+  return from_utf8_ssse3(data, length, i, out);
+}
+
+ZINC_TARGET("sse2")
+auto utf16_to_utf8_sse2(char16_t const *data, usize length, char *out)
+    -> char * {
+  auto const high_bits = _mm_set1_epi16(as<short>(0xFF80));
+  auto const zero = _mm_setzero_si128();
+  usize i = 0;
+  while (i < length) {
+    if (i + 8 <= length) {
+      auto const units = load16(data + i);
+      auto const ascii =
+          _mm_cmpeq_epi16(_mm_and_si128(units, high_bits), zero);
+      if (_mm_movemask_epi8(ascii) == 0xFFFF) {
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(out),
+                         _mm_packus_epi16(units, units));
+        out += 8;
+        i += 8;
+        continue;
+      }
+    }
+    if (!utf16_step(data, length, i, out))
+      return nullptr;
+  }
+  return out;
+}
+#endif
+
+template <typename TUnit>
+auto from_utf8(string_view const &text, TUnit *out) -> option<usize> {
+  TUnit *end;
+#if ZINC_CPU_X86
+  if (features().ssse3) {
+    if (!is_valid_utf8(text))
+      return None;
+    end = features().avx2
+              ? from_utf8_avx2(text.data(), text.length(), out)
+              : from_utf8_ssse3(text.data(), text.length(), 0, out);
+  } else
+#endif
+    end = from_utf8_scalar(text.data(), text.length(), 0, out);
+  if (!end)
+    return None;
+  return as<usize>(end - out);
+}
+} // namespace
+
+auto is_valid_utf8(string_view const &text) -> bool {
+#if ZINC_CPU_X86
+  if (features().avx2)
+    return validate_avx2(text.data(), text.length());
+  if (features().ssse3)
+    return validate_ssse3(text.data(), text.length());
+#endif
+  return validate_scalar(text.data(), text.length());
+}
+
+auto count_code_points(string_view const &text) -> usize {
+#if ZINC_CPU_X86
+  if (features().avx2)
+    return count_avx2<false>(text.data(), text.length());
+  if (features().sse2)
+    return count_sse2<false>(text.data(), text.length());
+#endif
+  return count_scalar<false>(text.data(), text.length());
+}
+
+auto utf16_length(string_view const &text) -> usize {
+#if ZINC_CPU_X86
+  if (features().avx2)
+    return count_avx2<true>(text.data(), text.length());
+  if (features().sse2)
+    return count_sse2<true>(text.data(), text.length());
+#endif
+  return count_scalar<true>(text.data(), text.length());
+}
+
+auto utf8_to_utf16(string_view const &text, char16_t *out) -> option<usize> {
+  return from_utf8(text, out);
+}
+
+auto utf8_to_utf32(string_view const &text, char32_t *out) -> option<usize> {
+  return from_utf8(text, out);
+}
+
+auto utf16_to_utf8(char16_t const *data, usize length, char *out)
+    -> option<usize> {
+  char *end;
+#if ZINC_CPU_X86
+  if (features().sse2)
+    end = utf16_to_utf8_sse2(data, length, out);
+  else
+#endif
+    end = utf16_to_utf8_scalar(data, length, 0, out);
+  if (!end)
+    return None;
+  return as<usize>(end - out);
+}
+
+auto utf32_to_utf8(char32_t const *data, usize length, char *out)
+    -> option<usize> {
+  auto *end = utf32_to_utf8_scalar(data, length, 0, out);
+  if (!end)
+    return None;
+  return as<usize>(end - out);
+}
+} // namespace zinc
\ No newline at end of file
@@ -1,5 +1,9 @@
+#include "zinc/mt/parallel_sort.h"
+#include "zinc/mt/rcu.h"
+#include "zinc/mt/seqlock.h"
 #include "zinc/zinc.h"
 #include <iostream>
+#include <limits>
 
 using namespace zinc;
 
@@ -16,11 +20,189 @@ auto clean_rt(rt *r) -> void {
   std::cout << "clean_rt" << std::endl;
 }
 
+auto half_of(u32 value) -> zinc::result<u32, char const *> {
+  if (value % 2)
+    return zinc::Err("odd");
+  return zinc::Ok(value / 2);
+}
+
+auto quarter_of(u32 value) -> zinc::result<u32, char const *> {
+  ZINC_TRY(auto half, half_of(value));
+  return half_of(half);
+}
+
 auto main() -> int {
   auto data_pool = zinc::pool(sizeof(char), 1000);
 
   auto dyna = zinc::string("Hello World! 😱");
   std::cout << dyna.data() << std::endl;
+  dyna += " and then some more";
+  std::cout << dyna.length() << " " << dyna.is_inline() << std::endl;
+
+  auto line = zinc::string_view("GET /index.html  HTTP/1.1");
+  for (auto field : line.tokenize(" "))
+    std::cout << field.length() << " ";
+  std::cout << line.find("HTTP") << " " << line.count('/') << std::endl;
+
+  auto &names = zinc::interner::global();
+  auto method = names.intern(line.substr(0, 3));
+  std::cout << (method == names.intern("GET")) << " "
+            << names.resolve(method).data() << std::endl;
+
+  auto response = zinc::cord(zinc::string_view("\"ok\""));
+  response.prepend("{\"status\":");
+  response.append("}");
+  std::cout << response.flatten().data() << " " << response.chunk_count()
+            << std::endl;
+
+  auto reading = zinc::string("t=");
+  zinc::format_float(reading, 0.1 + 0.2);
+  reading += " n=";
+  zinc::format_int(reading, -42);
+  std::cout << reading.data() << " "
+            << zinc::parse_int<u16>("65535").value_or(0) << " "
+            << zinc::parse_float<f64>("2.5e-3").value_or(0) << std::endl;
+
+  char banner[64];
+  zinc::format_to(banner, ZINC_FMT("{:<6}|{:>4}|{:x}|{}"), "zinc", 42, 255u,
+                  zinc::duration::from_milliseconds(1500));
+  std::cout << banner << std::endl;
+
+  auto greeting = zinc::string_view("h\xc3\xa9llo \xf0\x9f\x8c\x8d");
+  char16_t wide[16];
+  usize glyphs = 0;
+  for (auto c : zinc::utf8_view(greeting))
+    glyphs += c < 0x80 ? 0 : 1;
+  std::cout << zinc::is_valid_utf8(greeting) << " "
+            << zinc::count_code_points(greeting) << " " << glyphs << " "
+            << zinc::utf8_to_utf16(greeting, wide).value_or(0) << std::endl;
+
+  auto digest = zinc::hasher();
+  digest.update("GET /index").update(".html");
+  std::cout << (digest.finish() == zinc::hash_value(zinc::string_view(
+                                       "GET /index.html")))
+            << " " << (zinc::hash_value(method) == method.hash()) << std::endl;
+
+  auto payload = zinc::shared_string(zinc::string_view("{\"id\":7}"));
+  auto fanned = payload;
+  std::cout << payload.use_count() << " "
+            << (payload.substr(2, 2) == zinc::string_view("id")) << " "
+            << fanned.as_string_view().length() << std::endl;
+
+  zinc::string_view routes[] = {"/users", "/", "/orders", "/users/7"};
+  zinc::sort_strings(routes, 4);
+  for (auto route : routes)
+    std::cout << route.data() << " ";
+  std::cout << std::endl;
+
+  int latencies[] = {40, 3, 17, 3, 9};
+  zinc::sort(latencies, 5);
+  for (auto latency : latencies)
+    std::cout << latency << " ";
+  std::cout << std::endl;
+
+  // every other sample failed to read, the first two are zeros of both signs
+  f64 samples[1024];
+  for (usize i = 0; i < 1024; ++i)
+    samples[i] = i % 2 ? std::numeric_limits<f64>::quiet_NaN() : 1024.0 - i;
+  samples[0] = 0.0;
+  samples[2] = -0.0;
+  zinc::sort(samples, 1024);
+  std::cout << samples[0] << " " << samples[1] << " " << samples[511] << " "
+            << samples[512] << std::endl;
+
+  struct job {
+    u32 priority;
+    char const *name;
+  };
+  job jobs[] = {{2, "flush"}, {0, "accept"}, {1, "parse"}, {0, "read"}};
+  zinc::sort_by_key(jobs, 4, [](job const &j) { return j.priority; });
+  for (auto const &j : jobs)
+    std::cout << j.name << " ";
+  std::cout << std::endl;
+
+  u32 shards[] = {9, 4, 7, 1};
+  u32 backlog[] = {2, 3, 8};
+  u32 merged[7];
+  zinc::parallel_sort(shards, 4, 2);
+  zinc::parallel_merge(shards, 4, backlog, 3, merged, 2);
+  for (auto shard : merged)
+    std::cout << shard << " ";
+  std::cout << std::endl;
+
+  i32 readings[] = {18, 21, -3, 40, 21, 7};
+  auto const sensor = zinc::array_view<i32>(readings, 6);
+  auto const range = zinc::simd::min_max(sensor).value();
+  std::cout << zinc::simd::sum(sensor) << " " << range.min << " " << range.max
+            << " " << zinc::simd::find(sensor, 21) << " "
+            << zinc::simd::count(sensor, 21) << " "
+            << zinc::simd::any_of(sensor, zinc::simd::less_than(0))
+            << std::endl;
+
+  f32 relevance[] = {0.2f, 0.9f, 0.4f, 0.7f, 0.1f, 0.8f};
+  zinc::top_k<f32, 3> best;
+  best.push(relevance, 6);
+  for (auto score : best.sorted())
+    std::cout << score << " ";
+  zinc::nth_element(relevance, relevance + 3, relevance + 6);
+  std::cout << "median " << relevance[3] << std::endl;
+
+  u32 countdown[] = {5, 4, 3, 2, 1};
+  zinc::partial_sort(countdown, countdown + 5, countdown + 5);
+  for (auto tick : countdown)
+    std::cout << tick << " ";
+  std::cout << std::endl;
+
+  u32 offsets[] = {0, 120, 480, 512, 2048, 4096};
+  auto const by_offset = zinc::array_view<u32>(offsets, 6);
+  zinc::eytzinger_index<u32> offset_index(by_offset);
+  zinc::btree_index<u32> offset_tree(by_offset);
+  std::cout << zinc::lower_bound(by_offset, 500u) << " "
+            << zinc::upper_bound(by_offset, 512u) << " "
+            << *offset_index.lower_bound(500u) << " "
+            << *offset_tree.upper_bound(512u) << " "
+            << offset_index.contains(121u) << std::endl;
+
+  zinc::sys_allocator<u32> page_allocator;
+  zinc::vector<u32> pages(page_allocator);
+  zinc::from(by_offset)
+      .filter([](u32 offset) { return offset % 512 == 0; })
+      .map([](u32 offset) { return offset / 512; })
+      .collect_into(pages);
+  for (auto page : pages)
+    std::cout << page << " ";
+  std::cout << zinc::from(by_offset).stride(2).count() << std::endl;
+
+  auto owned = zinc::unique<rt>(new rt(6));
+  zinc::func<u32(u32)> scale = [r = std::move(owned)](u32 x) {
+    return x * r->ii;
+  };
+  auto moved = std::move(scale);
+  auto const apply = [](zinc::function_ref<u32(u32)> f) { return f(7); };
+  std::cout << moved(2) << " " << apply(moved) << " " << scale.is_valid()
+            << std::endl;
+
+  u32 ticks = 0;
+  zinc::static_vector<zinc::inplace_func<void(u32)>, 4> on_tick;
+  on_tick.emplace_back([&ticks](u32 now) { ticks += now; });
+  on_tick.emplace_back([&ticks](u32 now) { ticks *= now; });
+  auto handlers = std::move(on_tick);
+  for (auto &handler : handlers)
+    handler(3);
+  std::cout << ticks << " " << handlers.size() << std::endl;
+
+  auto timeout = zinc::option<zinc::duration>();
+  auto owner = zinc::option<rt &>();
+  rt guest(8);
+  owner = guest;
+  timeout = zinc::duration::from_milliseconds(250);
+  std::cout << (sizeof(timeout) == sizeof(zinc::duration)) << " "
+            << timeout.value().as_milliseconds() << " " << owner.value().ii
+            << std::endl;
+
+  std::cout << quarter_of(12).value() << " " << quarter_of(6).error() << " "
+            << half_of(7).map([](u32 half) { return half + 1; }).value_or(0)
+            << std::endl;
 
   auto m = zinc::vector<int>();
   m.push_back(6);
@@ -47,5 +229,37 @@ auto main() -> int {
     std::cout << x.use_count() << std::endl;
   }
 
+  {
+    auto cache = zinc::weak<rt>();
+    {
+      auto x = zinc::make_shared<rt>(5);
+      cache = x;
+      std::cout << cache.lock()->ii << std::endl;
+    }
+    std::cout << cache.expired() << std::endl;
+  }
+
+  {
+    auto config = zinc::atomic_shared<rt>(zinc::make_shared<rt>(1));
+    auto seen = config.load();
+    config.compare_exchange(seen, zinc::make_shared<rt>(2));
+    std::cout << config.load()->ii << std::endl;
+  }
+
+  {
+    struct route {
+      u32 port;
+      u32 weight;
+    };
+    auto table = zinc::seqlock<route>(route{80, 1});
+    table.store(route{443, 2});
+    std::cout << table.load().port << std::endl;
+
+    auto config = zinc::rcu_ptr<route>(new route{8080, 1});
+    config.emplace(route{8443, 3});
+    config.read([](route const *r) { std::cout << r->port << std::endl; });
+    zinc::epoch_domain::global().synchronize();
+  }
+
   return 0;
 }
\ No newline at end of file
@@ -15,6 +15,8 @@ target("zinc")
 
     if is_plat("windows") then
         add_syslinks("User32", "Shell32", "Gdi32", "Kernel32")
+    elseif is_plat("linux") then
+        add_syslinks("pthread", {public = true})
     end
 
 target("zinctest")
@@ -25,3 +27,16 @@ target("zinctest")
         add_defines("ZINC_CONFIG_SHARED_LIB")
     end
     add_deps("zinc")
+
+-- one binary per benchmark, build with `xmake build bench_<name>`
+for _, file in ipairs(os.files("benches/*.cpp")) do
+    target("bench_" .. path.basename(file))
+        set_kind("binary")
+        set_default(false)
+        add_files(file)
+        set_languages("cxx17")
+        if is_kind("shared") then
+            add_defines("ZINC_CONFIG_SHARED_LIB")
+        end
+        add_deps("zinc")
+end
\ No newline at end of file